@@ -0,0 +1,174 @@
+/*
+    Benchmark of the lookups of custom settings
+
+    SPDX-FileCopyrightText: 2026 Alexander Reinholdt <alexander.reinholdt@kdemail.net>
+    SPDX-License-Identifier: GPL-2.0-or-later
+*/
+
+// application specific includes
+#include "smb4kcustomsettings.h"
+#include "smb4kcustomsettingsmanager.h"
+#include "smb4kglobal.h"
+#include "smb4khost.h"
+#include "smb4ksettings.h"
+#include "smb4kshare.h"
+
+// Qt includes
+#include <QStandardPaths>
+#include <QTest>
+#include <QUrl>
+
+using namespace Smb4KGlobal;
+
+//
+// Number of hosts and number of shares per host. Together with the
+// entries of the hosts, there are 10,000 custom settings.
+//
+#define BENCHMARK_HOSTS 100
+#define BENCHMARK_SHARES 99
+
+class Smb4KCustomSettingsBenchmark : public QObject
+{
+    Q_OBJECT
+
+private Q_SLOTS:
+    void initTestCase();
+    void cleanupTestCase();
+    void findShareSettings();
+    void findHostSettings();
+    void findInheritedSettings();
+    void findMissingSettings();
+    void addHostSettings();
+
+private:
+    HostPtr createHost(int host);
+    SharePtr createShare(int host, int share);
+    CustomSettingsPtr createSettings(Smb4KBasicNetworkItem *networkItem);
+};
+
+HostPtr Smb4KCustomSettingsBenchmark::createHost(int host)
+{
+    HostPtr networkHost = HostPtr(new Smb4KHost());
+    networkHost->setHostName(QStringLiteral("HOST-%1").arg(host));
+    networkHost->setWorkgroupName(QStringLiteral("WORKGROUP"));
+
+    return networkHost;
+}
+
+SharePtr Smb4KCustomSettingsBenchmark::createShare(int host, int share)
+{
+    SharePtr networkShare = SharePtr(new Smb4KShare());
+    networkShare->setHostName(QStringLiteral("HOST-%1").arg(host));
+    networkShare->setShareName(QStringLiteral("share%1").arg(share));
+    networkShare->setWorkgroupName(QStringLiteral("WORKGROUP"));
+
+    return networkShare;
+}
+
+CustomSettingsPtr Smb4KCustomSettingsBenchmark::createSettings(Smb4KBasicNetworkItem *networkItem)
+{
+    CustomSettingsPtr settings = CustomSettingsPtr::create(networkItem);
+
+    //
+    // Only entries with custom settings are stored
+    //
+    settings->setUseKerberos(!Smb4KSettings::useKerberos());
+
+    return settings;
+}
+
+void Smb4KCustomSettingsBenchmark::initTestCase()
+{
+    QStandardPaths::setTestModeEnabled(true);
+
+    for (int i = 0; i < BENCHMARK_HOSTS; ++i) {
+        HostPtr host = createHost(i);
+        Smb4KCustomSettingsManager::self()->addCustomSettings(createSettings(host.data()));
+
+        for (int j = 0; j < BENCHMARK_SHARES; ++j) {
+            SharePtr share = createShare(i, j);
+            Smb4KCustomSettingsManager::self()->addCustomSettings(createSettings(share.data()));
+        }
+    }
+
+    QCOMPARE(Smb4KCustomSettingsManager::self()->customSettings().size(), BENCHMARK_HOSTS * (BENCHMARK_SHARES + 1));
+}
+
+void Smb4KCustomSettingsBenchmark::cleanupTestCase()
+{
+    const QList<CustomSettingsPtr> settingsList = Smb4KCustomSettingsManager::self()->customSettings();
+
+    for (const CustomSettingsPtr &settings : settingsList) {
+        Smb4KCustomSettingsManager::self()->removeCustomSettings(settings);
+    }
+}
+
+void Smb4KCustomSettingsBenchmark::findShareSettings()
+{
+    SharePtr share = createShare(BENCHMARK_HOSTS - 1, BENCHMARK_SHARES - 1);
+    CustomSettingsPtr settings;
+
+    QBENCHMARK {
+        settings = Smb4KCustomSettingsManager::self()->findCustomSettings(share->url());
+    }
+
+    QVERIFY(settings);
+}
+
+void Smb4KCustomSettingsBenchmark::findHostSettings()
+{
+    HostPtr host = createHost(BENCHMARK_HOSTS - 1);
+    CustomSettingsPtr settings;
+
+    QBENCHMARK {
+        settings = Smb4KCustomSettingsManager::self()->findCustomSettings(host->url());
+    }
+
+    QVERIFY(settings);
+}
+
+void Smb4KCustomSettingsBenchmark::findInheritedSettings()
+{
+    //
+    // A share without own entry gets the settings of its host
+    //
+    NetworkItemPtr share = createShare(BENCHMARK_HOSTS - 1, BENCHMARK_SHARES);
+    CustomSettingsPtr settings;
+
+    QBENCHMARK {
+        settings = Smb4KCustomSettingsManager::self()->findCustomSettings(share);
+    }
+
+    QVERIFY(settings);
+}
+
+void Smb4KCustomSettingsBenchmark::findMissingSettings()
+{
+    SharePtr share = createShare(BENCHMARK_HOSTS, 0);
+    CustomSettingsPtr settings;
+
+    QBENCHMARK {
+        settings = Smb4KCustomSettingsManager::self()->findCustomSettings(share->url());
+    }
+
+    QVERIFY(!settings);
+}
+
+void Smb4KCustomSettingsBenchmark::addHostSettings()
+{
+    //
+    // Updating the entry of a host also updates the entries of its shares
+    //
+    HostPtr host = createHost(BENCHMARK_HOSTS / 2);
+    CustomSettingsPtr settings = createSettings(host.data());
+
+    QBENCHMARK {
+        Smb4KCustomSettingsManager::self()->addCustomSettings(settings);
+    }
+
+    QCOMPARE(Smb4KCustomSettingsManager::self()->customSettings().size(), BENCHMARK_HOSTS * (BENCHMARK_SHARES + 1));
+}
+
+QTEST_GUILESS_MAIN(Smb4KCustomSettingsBenchmark)
+
+#include "smb4kcustomsettingsbenchmark.moc"
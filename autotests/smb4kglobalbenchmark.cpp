@@ -0,0 +1,183 @@
+/*
+    Benchmark of the lookups in the global lists of network items
+
+    SPDX-FileCopyrightText: 2026 Alexander Reinholdt <alexander.reinholdt@kdemail.net>
+    SPDX-License-Identifier: GPL-2.0-or-later
+*/
+
+// application specific includes
+#include "smb4kglobal.h"
+#include "smb4khost.h"
+#include "smb4kshare.h"
+#include "smb4kworkgroup.h"
+
+// Qt includes
+#include <QTest>
+#include <QUrl>
+
+using namespace Smb4KGlobal;
+
+class Smb4KGlobalBenchmark : public QObject
+{
+    Q_OBJECT
+
+private Q_SLOTS:
+    void cleanup();
+    void findWorkgroup_data();
+    void findWorkgroup();
+    void findHost_data();
+    void findHost();
+    void findShare_data();
+    void findShare();
+    void findShareByPath_data();
+    void findShareByPath();
+
+private:
+    void addData();
+    void populate(int items);
+};
+
+void Smb4KGlobalBenchmark::addData()
+{
+    QTest::addColumn<int>("items");
+
+    QTest::newRow("10") << 10;
+    QTest::newRow("100") << 100;
+    QTest::newRow("1000") << 1000;
+    QTest::newRow("10000") << 10000;
+    QTest::newRow("50000") << 50000;
+}
+
+void Smb4KGlobalBenchmark::populate(int items)
+{
+    for (int i = 0; i < items; ++i) {
+        WorkgroupPtr workgroup = WorkgroupPtr(new Smb4KWorkgroup(QStringLiteral("WORKGROUP-%1").arg(i)));
+        addWorkgroup(workgroup);
+
+        HostPtr host = HostPtr(new Smb4KHost());
+        host->setHostName(QStringLiteral("HOST-%1").arg(i));
+        host->setWorkgroupName(workgroup->workgroupName());
+        addHost(host);
+
+        SharePtr share = SharePtr(new Smb4KShare());
+        share->setHostName(host->hostName());
+        share->setShareName(QStringLiteral("SHARE-%1").arg(i));
+        share->setWorkgroupName(workgroup->workgroupName());
+        addShare(share);
+
+        SharePtr mountedShare = SharePtr(new Smb4KShare(*share.data()));
+        mountedShare->setPath(QStringLiteral("/tmp/smb4k-benchmark/HOST-%1/SHARE-%1").arg(i));
+        mountedShare->setMounted(true);
+        addMountedShare(mountedShare);
+    }
+}
+
+void Smb4KGlobalBenchmark::cleanup()
+{
+    //
+    // Remove the mounted shares in list order, so that the removal
+    // does not dominate the run time of the larger data sets
+    //
+    const QList<SharePtr> mountedShares = mountedSharesList();
+
+    for (const SharePtr &share : mountedShares) {
+        removeMountedShare(share, true);
+    }
+
+    clearSharesList();
+    clearHostsList();
+    clearWorkgroupsList();
+}
+
+void Smb4KGlobalBenchmark::findWorkgroup_data()
+{
+    addData();
+}
+
+void Smb4KGlobalBenchmark::findWorkgroup()
+{
+    QFETCH(int, items);
+    populate(items);
+
+    //
+    // Look up the last item with a name that differs in case, so the
+    // worst case of a linear search is compared against the index
+    //
+    const QString name = QStringLiteral("workgroup-%1").arg(items - 1);
+    WorkgroupPtr workgroup;
+
+    QBENCHMARK {
+        workgroup = Smb4KGlobal::findWorkgroup(name);
+    }
+
+    QVERIFY(workgroup);
+}
+
+void Smb4KGlobalBenchmark::findHost_data()
+{
+    addData();
+}
+
+void Smb4KGlobalBenchmark::findHost()
+{
+    QFETCH(int, items);
+    populate(items);
+
+    const QString name = QStringLiteral("host-%1").arg(items - 1);
+    const QString workgroupName = QStringLiteral("workgroup-%1").arg(items - 1);
+    HostPtr host;
+
+    QBENCHMARK {
+        host = Smb4KGlobal::findHost(name, workgroupName);
+    }
+
+    QVERIFY(host);
+}
+
+void Smb4KGlobalBenchmark::findShare_data()
+{
+    addData();
+}
+
+void Smb4KGlobalBenchmark::findShare()
+{
+    QFETCH(int, items);
+    populate(items);
+
+    QUrl url;
+    url.setScheme(QStringLiteral("smb"));
+    url.setHost(QStringLiteral("host-%1").arg(items - 1));
+    url.setPath(QStringLiteral("/share-%1").arg(items - 1));
+
+    SharePtr share;
+
+    QBENCHMARK {
+        share = Smb4KGlobal::findShare(url);
+    }
+
+    QVERIFY(share);
+}
+
+void Smb4KGlobalBenchmark::findShareByPath_data()
+{
+    addData();
+}
+
+void Smb4KGlobalBenchmark::findShareByPath()
+{
+    QFETCH(int, items);
+    populate(items);
+
+    const QString path = QStringLiteral("/tmp/smb4k-benchmark/host-%1/share-%1").arg(items - 1);
+    SharePtr share;
+
+    QBENCHMARK {
+        share = Smb4KGlobal::findShareByPath(path);
+    }
+
+    QVERIFY(share);
+}
+
+QTEST_GUILESS_MAIN(Smb4KGlobalBenchmark)
+
+#include "smb4kglobalbenchmark.moc"
@@ -0,0 +1,195 @@
+/*
+    Benchmark of the network scan against the synthetic network
+
+    SPDX-FileCopyrightText: 2026 Alexander Reinholdt <alexander.reinholdt@kdemail.net>
+    SPDX-License-Identifier: GPL-2.0-or-later
+*/
+
+// application specific includes
+#include "smb4kclient.h"
+#include "smb4kglobal.h"
+#include "smb4khost.h"
+#include "smb4ksettings.h"
+#include "smb4kshare.h"
+#include "smb4kworkgroup.h"
+#include "smb4k/smb4knetworkbrowsermodel.h"
+
+// Qt includes
+#include <QEventLoop>
+#include <QStandardPaths>
+#include <QTest>
+#include <QTimer>
+
+using namespace Smb4KGlobal;
+
+//
+// The network that is scanned when SMB4K_SYNTHETIC_NETWORK is not set
+//
+#define DEFAULT_SYNTHETIC_NETWORK "workgroups=10,hosts=50,shares=10,latency=0"
+
+//
+// Maximum time in msec a scan may take
+//
+#define SCAN_TIMEOUT 300000
+
+class Smb4KNetworkBenchmark : public QObject
+{
+    Q_OBJECT
+
+private Q_SLOTS:
+    void initTestCase();
+    void cleanupTestCase();
+    void scan();
+    void merge();
+    void updateModel();
+
+private:
+    void scanNetwork();
+    void waitForClient();
+    void clearLists();
+};
+
+void Smb4KNetworkBenchmark::initTestCase()
+{
+    QStandardPaths::setTestModeEnabled(true);
+
+    //
+    // The synthetic network is read when the first lookup is started
+    //
+    if (!qEnvironmentVariableIsSet("SMB4K_SYNTHETIC_NETWORK")) {
+        qputenv("SMB4K_SYNTHETIC_NETWORK", DEFAULT_SYNTHETIC_NETWORK);
+    }
+
+    qInfo() << "Scanning the synthetic network" << qgetenv("SMB4K_SYNTHETIC_NETWORK");
+
+    //
+    // Only measure the lookups of the client library backend
+    //
+    Smb4KSettings::setUseWsDiscovery(false);
+    Smb4KSettings::setUseDnsServiceDiscovery(false);
+    Smb4KSettings::setEnableWakeOnLAN(false);
+    Smb4KSettings::setCacheNetworkNeighborhood(false);
+}
+
+void Smb4KNetworkBenchmark::cleanupTestCase()
+{
+    Smb4KClient::self()->abort();
+    clearLists();
+}
+
+void Smb4KNetworkBenchmark::waitForClient()
+{
+    if (!Smb4KClient::self()->isRunning()) {
+        return;
+    }
+
+    QEventLoop loop;
+
+    connect(Smb4KClient::self(), &Smb4KClient::finished, &loop, [&loop]() {
+        if (!Smb4KClient::self()->isRunning()) {
+            loop.quit();
+        }
+    });
+
+    QTimer::singleShot(SCAN_TIMEOUT, &loop, &QEventLoop::quit);
+
+    loop.exec();
+
+    QVERIFY2(!Smb4KClient::self()->isRunning(), "The scan timed out");
+}
+
+void Smb4KNetworkBenchmark::scanNetwork()
+{
+    Smb4KClient::self()->lookupDomains();
+    waitForClient();
+
+    const QList<WorkgroupPtr> workgroups = workgroupsList();
+
+    for (const WorkgroupPtr &workgroup : workgroups) {
+        Smb4KClient::self()->lookupDomainMembers(workgroup);
+    }
+
+    waitForClient();
+
+    const QList<HostPtr> hosts = hostsList();
+
+    for (const HostPtr &host : hosts) {
+        Smb4KClient::self()->lookupShares(host);
+    }
+
+    waitForClient();
+}
+
+void Smb4KNetworkBenchmark::clearLists()
+{
+    clearSharesList();
+    clearHostsList();
+    clearWorkgroupsList();
+}
+
+void Smb4KNetworkBenchmark::scan()
+{
+    //
+    // Scan the network neighborhood starting with empty lists
+    //
+    QBENCHMARK {
+        clearLists();
+        scanNetwork();
+    }
+
+    QVERIFY(!workgroupsList().isEmpty());
+    QVERIFY(!hostsList().isEmpty());
+}
+
+void Smb4KNetworkBenchmark::merge()
+{
+    //
+    // Scan the network neighborhood again, so that the results have to
+    // be merged into the known items
+    //
+    clearLists();
+    scanNetwork();
+
+    QBENCHMARK {
+        scanNetwork();
+    }
+
+    QVERIFY(!sharesList().isEmpty());
+}
+
+void Smb4KNetworkBenchmark::updateModel()
+{
+    clearLists();
+    scanNetwork();
+
+    const QList<WorkgroupPtr> workgroups = workgroupsList();
+    Smb4KNetworkBrowserModel model;
+
+    //
+    // Show the whole network neighborhood and refresh the members of all
+    // workgroups afterwards, like the network browser does
+    //
+    QBENCHMARK {
+        model.clear();
+        model.updateWorkgroups(workgroups, QList<WorkgroupPtr>(), QList<WorkgroupPtr>());
+
+        for (int i = 0; i < model.rowCount(); ++i) {
+            QModelIndex workgroupIndex = model.index(i, Smb4KNetworkBrowserModel::Network);
+            model.fetchMore(workgroupIndex);
+
+            for (int j = 0; j < model.rowCount(workgroupIndex); ++j) {
+                model.fetchMore(model.index(j, Smb4KNetworkBrowserModel::Network, workgroupIndex));
+            }
+        }
+
+        for (const WorkgroupPtr &workgroup : workgroups) {
+            model.updateHosts(workgroup, QList<HostPtr>(), QList<HostPtr>(), workgroupMembers(workgroup));
+        }
+    }
+
+    QCOMPARE(model.rowCount(), workgroups.size());
+}
+
+QTEST_MAIN(Smb4KNetworkBenchmark)
+
+#include "smb4knetworkbenchmark.moc"
@@ -22,7 +22,9 @@ public:
     QIcon icon;
     QUrl url;
     bool dnsDiscovered;
+    bool cached;
     QString comment;
+    QDateTime lastSeen;
 };
 
 Smb4KBasicNetworkItem::Smb4KBasicNetworkItem(NetworkItem type)
@@ -30,6 +32,7 @@ Smb4KBasicNetworkItem::Smb4KBasicNetworkItem(NetworkItem type)
 {
     d->type = type;
     d->dnsDiscovered = false;
+    d->cached = false;
 
     pUrl = &d->url;
     pIcon = &d->icon;
@@ -148,6 +151,26 @@ bool Smb4KBasicNetworkItem::hasUserInfo() const
     return !d->url.userInfo().isEmpty();
 }
 
+void Smb4KBasicNetworkItem::setCached(bool cached) const
+{
+    d->cached = cached;
+}
+
+bool Smb4KBasicNetworkItem::isCached() const
+{
+    return d->cached;
+}
+
+void Smb4KBasicNetworkItem::setLastSeen(const QDateTime &dateTime) const
+{
+    d->lastSeen = dateTime;
+}
+
+QDateTime Smb4KBasicNetworkItem::lastSeen() const
+{
+    return d->lastSeen;
+}
+
 Smb4KBasicNetworkItem &Smb4KBasicNetworkItem::operator=(const Smb4KBasicNetworkItem &other)
 {
     *d = *other.d;
@@ -14,6 +14,7 @@
 #include "smb4kglobalenums.h"
 
 // Qt includes
+#include <QDateTime>
 #include <QIcon>
 #include <QMetaType>
 #include <QScopedPointer>
@@ -130,6 +131,37 @@ public:
      */
     bool hasUserInfo() const;
 
+    /**
+     * Set @p cached to TRUE if this network item was loaded from the
+     * network neighborhood cache and was not confirmed by a scan yet.
+     *
+     * @param cached        Set this to TRUE if the item is cached
+     */
+    void setCached(bool cached) const;
+
+    /**
+     * Return TRUE if the network item was loaded from the network
+     * neighborhood cache and was not confirmed by a scan yet.
+     *
+     * @returns TRUE if the item is cached
+     */
+    bool isCached() const;
+
+    /**
+     * Set the time the network item was last seen on the network.
+     *
+     * @param dateTime      The date and time
+     */
+    void setLastSeen(const QDateTime &dateTime) const;
+
+    /**
+     * Return the time the network item was last seen on the network. The
+     * returned date and time is invalid if the item was not seen yet.
+     *
+     * @returns the date and time
+     */
+    QDateTime lastSeen() const;
+
     /**
      * Copy assignment operator
      */
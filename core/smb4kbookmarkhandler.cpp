@@ -13,6 +13,7 @@
 #include "smb4kprofilemanager.h"
 #include "smb4ksettings.h"
 #include "smb4kshare.h"
+#include "smb4kwritescheduler.h"
 
 // Qt includes
 #if (QT_VERSION >= QT_VERSION_CHECK(6, 8, 0))
@@ -23,6 +24,7 @@
 #include <QDir>
 #include <QFile>
 #include <QMutableListIterator>
+#include <QSaveFile>
 #include <QTextStream>
 #include <QXmlStreamReader>
 #include <QXmlStreamWriter>
@@ -36,6 +38,7 @@ class Smb4KBookmarkHandlerPrivate
 {
 public:
     QList<BookmarkPtr> bookmarks;
+    Smb4KWriteScheduler writeScheduler;
 };
 
 class Smb4KBookmarkHandlerStatic
@@ -60,6 +63,7 @@ Smb4KBookmarkHandler::Smb4KBookmarkHandler(QObject *parent)
 
     read();
 
+    connect(&d->writeScheduler, &Smb4KWriteScheduler::write, this, &Smb4KBookmarkHandler::write);
     connect(Smb4KProfileManager::self(), &Smb4KProfileManager::profileRemoved, this, &Smb4KBookmarkHandler::slotProfileRemoved);
     connect(Smb4KProfileManager::self(), &Smb4KProfileManager::profileMigrated, this, &Smb4KBookmarkHandler::slotProfileMigrated);
     connect(Smb4KProfileManager::self(), &Smb4KProfileManager::activeProfileChanged, this, &Smb4KBookmarkHandler::slotActiveProfileChanged);
@@ -67,6 +71,8 @@ Smb4KBookmarkHandler::Smb4KBookmarkHandler(QObject *parent)
 
 Smb4KBookmarkHandler::~Smb4KBookmarkHandler()
 {
+    d->writeScheduler.flush();
+
     while (!d->bookmarks.isEmpty()) {
         d->bookmarks.takeFirst().clear();
     }
@@ -80,7 +86,7 @@ Smb4KBookmarkHandler *Smb4KBookmarkHandler::self()
 void Smb4KBookmarkHandler::addBookmark(const BookmarkPtr &bookmark)
 {
     if (bookmark && add(bookmark)) {
-        write();
+        d->writeScheduler.schedule();
         Q_EMIT updated();
     }
 }
@@ -109,7 +115,7 @@ void Smb4KBookmarkHandler::addBookmarks(const QList<BookmarkPtr> &list, bool rep
     }
 
     if (added) {
-        write();
+        d->writeScheduler.schedule();
         Q_EMIT updated();
     }
 }
@@ -117,7 +123,7 @@ void Smb4KBookmarkHandler::addBookmarks(const QList<BookmarkPtr> &list, bool rep
 void Smb4KBookmarkHandler::removeBookmark(const BookmarkPtr &bookmark)
 {
     if (bookmark && remove(bookmark)) {
-        write();
+        d->writeScheduler.schedule();
         Q_EMIT updated();
     }
 }
@@ -125,7 +131,7 @@ void Smb4KBookmarkHandler::removeBookmark(const BookmarkPtr &bookmark)
 void Smb4KBookmarkHandler::removeCategory(const QString &name)
 {
     if (!name.isEmpty() && remove(name)) {
-        write();
+        d->writeScheduler.schedule();
         Q_EMIT updated();
     }
 }
@@ -360,9 +366,15 @@ void Smb4KBookmarkHandler::read()
 
 void Smb4KBookmarkHandler::write()
 {
-    QFile xmlFile(dataLocation() + QDir::separator() + QStringLiteral("bookmarks.xml"));
+    QString fileName = dataLocation() + QDir::separator() + QStringLiteral("bookmarks.xml");
 
     if (!d->bookmarks.isEmpty()) {
+        //
+        // Write to a temporary file first, so that an interrupted write
+        // does not destroy the bookmarks
+        //
+        QSaveFile xmlFile(fileName);
+
         if (xmlFile.open(QIODevice::WriteOnly | QIODevice::Text)) {
             QXmlStreamWriter xmlWriter(&xmlFile);
             xmlWriter.setAutoFormatting(true);
@@ -390,12 +402,14 @@ void Smb4KBookmarkHandler::write()
 
             xmlWriter.writeEndDocument();
 
-            xmlFile.close();
+            if (!xmlFile.commit()) {
+                Smb4KNotification::openingFileFailed(xmlFile);
+            }
         } else {
             Smb4KNotification::openingFileFailed(xmlFile);
         }
     } else {
-        xmlFile.remove();
+        QFile::remove(fileName);
     }
 }
 
@@ -411,7 +425,7 @@ void Smb4KBookmarkHandler::slotProfileRemoved(const QString &name)
         }
     }
 
-    write();
+    d->writeScheduler.schedule();
     Q_EMIT updated();
 }
 
@@ -424,7 +438,7 @@ void Smb4KBookmarkHandler::slotProfileMigrated(const QString &oldName, const QSt
         }
     }
 
-    write();
+    d->writeScheduler.schedule();
     Q_EMIT updated();
 }
 
@@ -14,8 +14,11 @@
 #include "smb4kcustomsettingsmanager.h"
 #include "smb4khardwareinterface.h"
 #include "smb4khomesshareshandler.h"
+#include "smb4knetworkcache.h"
 #include "smb4knotification.h"
+#include "smb4ksearchindex.h"
 #include "smb4ksettings.h"
+#include "smb4kwakeonlan.h"
 
 // Qt includes
 #include <QApplication>
@@ -24,25 +27,104 @@
 #else
 #include <qapplicationstatic.h>
 #endif
-#include <QHostAddress>
 #include <QPointer>
+#include <QRandomGenerator>
+#include <QSet>
+#include <QThreadPool>
 #include <QTimer>
-#include <QUdpSocket>
 
 using namespace Smb4KGlobal;
 
+//
+// Minimal and maximal interval in msec the network items are refreshed with
+// and the random deviation from it in percent
+//
+#define MIN_REFRESH_INTERVAL 120000
+#define MAX_REFRESH_INTERVAL 1800000
+#define REFRESH_JITTER 10
+
+//
+// Delay in msec after which a refresh is tried again when it had to wait
+// for other lookups
+//
+#define REFRESH_RETRY_DELAY 5000
+
+//
+// Time in msec to wait for the running lookups when the application quits
+//
+#define QUIT_TIMEOUT 3000
+
 Q_APPLICATION_STATIC(Smb4KClientStatic, p);
 
+//
+// The key used to identify the network items that are refreshed
+//
+static QString refreshKey(const NetworkItemPtr &item)
+{
+    return QString::number(item->type()) + item->url().toString(QUrl::RemoveUserInfo | QUrl::RemovePort).toCaseFolded();
+}
+
+//
+// Vary the refresh interval, so that the lookups of items with the same
+// interval do not always coincide
+//
+static int jitteredInterval(int interval)
+{
+    int jitter = interval * REFRESH_JITTER / 100;
+    return interval + QRandomGenerator::global()->bounded(-jitter, jitter + 1);
+}
+
 Smb4KClient::Smb4KClient(QObject *parent)
     : KCompositeJob(parent)
     , d(new Smb4KClientPrivate)
 {
+    d->searchRunning = false;
+    d->searchLookup = false;
+    d->refreshLookup = false;
+    d->searchPhase = Smb4KClientPrivate::SearchDomains;
+    d->wakeUpDone = false;
+    d->threadPool = new QThreadPool();
+
     connect(QCoreApplication::instance(), &QCoreApplication::aboutToQuit, this, &Smb4KClient::slotAboutToQuit);
+    connect(Smb4KWakeOnLan::self(), &Smb4KWakeOnLan::wokenUp, this, &Smb4KClient::slotHostWokenUp);
     connect(Smb4KCredentialsManager::self(), &Smb4KCredentialsManager::credentialsUpdated, this, &Smb4KClient::slotCredentialsUpdated);
+
+    //
+    // Idle contexts were set up with the old settings, so drop them
+    //
+    connect(Smb4KSettings::self(), &Smb4KSettings::configChanged, this, []() {
+        Smb4KClientContextPool::self()->clear();
+    });
+
+    //
+    // Refresh the network neighborhood in the background
+    //
+    d->refreshTimer.setSingleShot(true);
+
+    connect(&d->refreshTimer, &QTimer::timeout, this, [this]() {
+        refreshNetworkNeighborhood();
+    });
+
+    connect(Smb4KSettings::self(), &Smb4KSettings::configChanged, this, [this]() {
+        startRefreshTimer();
+    });
+
+    //
+    // Initialize the thread support of the client library, since the
+    // lookups are run on the threads of the thread pool
+    //
+    smbc_thread_posix();
 }
 
 Smb4KClient::~Smb4KClient()
 {
+    //
+    // The destructor of the thread pool waits for the running lookups. If
+    // some of them hang inside the client library, the pool is abandoned.
+    //
+    if (d->threadPool->activeThreadCount() == 0) {
+        delete d->threadPool;
+    }
 }
 
 Smb4KClient *Smb4KClient::self()
@@ -56,6 +138,45 @@ void Smb4KClient::start()
     // Connect to the online state monitoring
     //
     connect(Smb4KHardwareInterface::self(), &Smb4KHardwareInterface::onlineStateChanged, this, &Smb4KClient::slotOnlineStateChanged, Qt::UniqueConnection);
+    connect(Smb4KHardwareInterface::self(),
+            &Smb4KHardwareInterface::systemSleepStateChanged,
+            this,
+            &Smb4KClient::slotSystemSleepStateChanged,
+            Qt::UniqueConnection);
+
+    //
+    // Show the network neighborhood known from the last session. The
+    // cached items are replaced or confirmed by the following scans.
+    //
+    if (Smb4KNetworkCache::self()->load()) {
+        Q_EMIT workgroupsChanged(workgroupsList(), QList<WorkgroupPtr>(), QList<WorkgroupPtr>());
+        Q_EMIT workgroups();
+
+        const QList<WorkgroupPtr> knownWorkgroups = workgroupsList();
+
+        for (const WorkgroupPtr &workgroup : knownWorkgroups) {
+            Q_EMIT hostsChanged(workgroup, workgroupMembers(workgroup), QList<HostPtr>(), QList<HostPtr>());
+            Q_EMIT hosts(workgroup);
+        }
+
+        const QList<HostPtr> knownHosts = hostsList();
+
+        for (const HostPtr &host : knownHosts) {
+            QList<SharePtr> knownShares = sharedResources(host);
+
+            if (!knownShares.isEmpty()) {
+                Q_EMIT sharesChanged(host, knownShares, QList<SharePtr>(), QList<SharePtr>());
+                Q_EMIT shares(host);
+            }
+        }
+    }
+
+    //
+    // The list of workgroups is always refreshed
+    //
+    NetworkItemPtr networkItem = NetworkItemPtr::create(Network);
+    networkItem->setUrl(QUrl(QStringLiteral("smb://")));
+    setAutoRefresh(networkItem, true);
 
     //
     // Start the scanning
@@ -67,60 +188,58 @@ void Smb4KClient::start()
 
 bool Smb4KClient::isRunning()
 {
-    return hasSubjobs();
+    return hasSubjobs() || !d->wakingHosts.isEmpty();
 }
 
 void Smb4KClient::abort()
 {
+    d->staleItems.clear();
+
+    //
+    // Do not wait for the servers to wake up anymore
+    //
+    if (!d->wakingHosts.isEmpty()) {
+        d->wakingHosts.clear();
+        Q_EMIT finished(d->wakeUpItem, WakeUp);
+        d->wakeUpItem.clear();
+    }
+
+    //
+    // Stop the search before the jobs are killed, so that the crawl is
+    // not continued when they report their results
+    //
+    bool searchRunning = d->searchRunning;
+    d->searchRunning = false;
+
     QListIterator<KJob *> it(subjobs());
 
     while (it.hasNext()) {
         it.next()->kill(KJob::EmitResult);
     }
+
+    d->searchJobs.clear();
+
+    if (searchRunning) {
+        finishSearch();
+    }
 }
 
 void Smb4KClient::lookupDomains()
 {
     //
-    // Send Wakeup-On-LAN packets
+    // Wake up the servers first. The lookup is started when all of them
+    // answered or the waiting time passed.
     //
-    if (Smb4KSettings::enableWakeOnLAN()) {
-        QList<CustomSettingsPtr> wakeOnLanEntries = Smb4KCustomSettingsManager::self()->wakeOnLanEntries();
-
-        if (!wakeOnLanEntries.isEmpty()) {
-            NetworkItemPtr item = NetworkItemPtr::create();
-            Q_EMIT aboutToStart(item, WakeUp);
-
-            for (auto entry : std::as_const(wakeOnLanEntries)) {
-                if (entry->wakeOnLanSendBeforeNetworkScan()) {
-                    QHostAddress addr;
-
-                    if (entry->hasIpAddress()) {
-                        addr.setAddress(entry->ipAddress());
-                    } else {
-                        addr.setAddress(QStringLiteral("255.255.255.255"));
-                    }
-
-                    // Magic Wake-On-LAN sequence
-                    QByteArray sequence = wakeOnLanMagicSequence(entry->macAddress());
-
-                    d->udpSocket.writeDatagram(sequence, addr, 9);
-                }
-            }
-
-            // Wait the defined time
-            int stop = 1000 * Smb4KSettings::wakeOnLANWaitingTime() / 250;
-            int i = 0;
-
-            while (i++ < stop) {
-                wait(250);
-            }
+    if (!d->wakingHosts.isEmpty()) {
+        return;
+    }
 
-            Q_EMIT finished(item, WakeUp);
-            item.clear();
-        }
+    if (!d->wakeUpDone && wakeUpHosts()) {
+        return;
     }
 
+    d->wakeUpDone = false;
+
     //
     // Setup network item
     //
@@ -133,6 +252,7 @@ void Smb4KClient::lookupDomains()
     Smb4KClientJob *clientJob = new Smb4KClientJob(this);
     clientJob->setNetworkItem(networkItem);
     clientJob->setProcess(LookupDomains);
+    clientJob->setThreadPool(threadPool());
 
 #ifdef USE_WS_DISCOVERY
     //
@@ -199,6 +319,34 @@ void Smb4KClient::lookupDomains()
     networkItem.clear();
 }
 
+bool Smb4KClient::wakeUpHosts()
+{
+    if (!Smb4KSettings::enableWakeOnLAN()) {
+        return false;
+    }
+
+    //
+    // Send the Wake-On-LAN packets to all servers in one pass
+    //
+    const QList<CustomSettingsPtr> wakeOnLanEntries = Smb4KCustomSettingsManager::self()->wakeOnLanEntries();
+
+    for (const CustomSettingsPtr &entry : wakeOnLanEntries) {
+        if (entry->wakeOnLanSendBeforeNetworkScan() && !entry->hostName().isEmpty()) {
+            d->wakingHosts.insert(entry->hostName().toCaseFolded());
+            Smb4KWakeOnLan::self()->wakeUp(entry->hostName(), entry->macAddress(), entry->hasIpAddress() ? entry->ipAddress() : QString());
+        }
+    }
+
+    if (d->wakingHosts.isEmpty()) {
+        return false;
+    }
+
+    d->wakeUpItem = NetworkItemPtr::create();
+    Q_EMIT aboutToStart(d->wakeUpItem, WakeUp);
+
+    return true;
+}
+
 void Smb4KClient::lookupDomainMembers(const WorkgroupPtr &workgroup)
 {
     //
@@ -207,6 +355,7 @@ void Smb4KClient::lookupDomainMembers(const WorkgroupPtr &workgroup)
     Smb4KClientJob *clientJob = new Smb4KClientJob(this);
     clientJob->setNetworkItem(workgroup);
     clientJob->setProcess(LookupDomainMembers);
+    clientJob->setThreadPool(threadPool());
 
 #ifdef USE_WS_DISCOVERY
     //
@@ -276,6 +425,7 @@ void Smb4KClient::lookupShares(const HostPtr &host)
     Smb4KClientJob *job = new Smb4KClientJob(this);
     job->setNetworkItem(host);
     job->setProcess(LookupShares);
+    job->setThreadPool(threadPool());
 
     //
     // Add the job to the subjobs
@@ -299,6 +449,12 @@ void Smb4KClient::lookupFiles(const NetworkItemPtr &item)
         Smb4KClientJob *job = new Smb4KClientJob(this);
         job->setNetworkItem(item);
         job->setProcess(LookupFiles);
+        job->setThreadPool(threadPool());
+
+        // The files are reported in chunks while the directory is read
+        connect(job, &Smb4KClientBaseJob::filesAvailable, this, [this, item](const QList<FilePtr> &list) {
+            processFiles(item, list);
+        });
 
         addSubjob(job);
 
@@ -344,66 +500,220 @@ void Smb4KClient::printFile(const SharePtr &share, const KFileItem &fileItem, in
 
 void Smb4KClient::search(const QString &item)
 {
+    //
+    // Stop a search that is still running
+    //
+    if (d->searchRunning) {
+        stopSearch();
+    }
+
     //
     // Create empty basic network item
     //
-    NetworkItemPtr networkItem = NetworkItemPtr::create();
+    d->searchItem = NetworkItemPtr::create();
+    d->searchTerm = item;
+    d->searchRunning = true;
+    d->searchPhase = Smb4KClientPrivate::SearchDomains;
+    d->searchResultKeys.clear();
+    d->crawlWorkgroups.clear();
+    d->crawlHosts.clear();
+
+    //
+    // The crawl below looks up everything, so there is no need to confirm
+    // the cached items separately
+    //
+    d->staleItems.clear();
 
     //
     // Emit the aboutToStart() signal
     //
-    Q_EMIT aboutToStart(networkItem, NetworkSearch);
+    Q_EMIT aboutToStart(d->searchItem, NetworkSearch);
+
+    //
+    // Report the results that are already known from the index
+    //
+    reportSearchResults();
 
     //
-    // Before doing the search, lookup all domains, servers and shares in the
-    // network neighborhood.
+    // Crawl the network neighborhood to find shares that are not indexed
+    // yet. The crawl continues in continueSearch() when lookups finished.
     //
+    d->searchLookup = true;
     lookupDomains();
+    d->searchLookup = false;
+}
+
+void Smb4KClient::setAutoRefresh(const NetworkItemPtr &item, bool refresh)
+{
+    QString key = refreshKey(item);
+
+    if (refresh) {
+        if (!d->refreshNodes.contains(key)) {
+            Smb4KClientPrivate::RefreshNode node;
+            node.networkItem = item;
+            node.interval = MIN_REFRESH_INTERVAL;
+            node.due.setRemainingTime(jitteredInterval(MIN_REFRESH_INTERVAL));
+
+            d->refreshNodes.insert(key, node);
+        }
+    } else {
+        d->refreshNodes.remove(key);
+    }
+
+    startRefreshTimer();
+}
+
+void Smb4KClient::continueSearch()
+{
+    if (!d->searchRunning) {
+        return;
+    }
+
+    switch (d->searchPhase) {
+    case Smb4KClientPrivate::SearchDomains: {
+        //
+        // The workgroups are merged when all lookups finished
+        //
+        if (isRunning()) {
+            return;
+        }
 
-    while (isRunning()) {
-        wait(50);
+        d->crawlWorkgroups = workgroupsList();
+        d->searchPhase = Smb4KClientPrivate::SearchMembers;
+
+        Q_FALLTHROUGH();
     }
+    case Smb4KClientPrivate::SearchMembers: {
+        //
+        // The members of each workgroup are merged separately, so look
+        // them up in parallel
+        //
+        d->searchLookup = true;
+
+        while (!d->crawlWorkgroups.isEmpty() && d->searchJobs.size() < Smb4KSettings::maximumConcurrentLookups()) {
+            lookupDomainMembers(d->crawlWorkgroups.takeFirst());
+        }
 
-    for (const WorkgroupPtr &workgroup : workgroupsList()) {
-        lookupDomainMembers(workgroup);
+        d->searchLookup = false;
 
-        while (isRunning()) {
-            wait(50);
+        if (!d->searchJobs.isEmpty() || !d->crawlWorkgroups.isEmpty()) {
+            return;
         }
+
+        d->crawlHosts = hostsList();
+        d->searchPhase = Smb4KClientPrivate::SearchShares;
+
+        Q_FALLTHROUGH();
     }
+    case Smb4KClientPrivate::SearchShares: {
+        //
+        // The shares of the hosts are processed independently, so look
+        // them up in parallel
+        //
+        d->searchLookup = true;
+
+        while (!d->crawlHosts.isEmpty() && d->searchJobs.size() < Smb4KSettings::maximumConcurrentLookups()) {
+            lookupShares(d->crawlHosts.takeFirst());
+        }
 
-    for (const HostPtr &host : hostsList()) {
-        lookupShares(host);
+        d->searchLookup = false;
 
-        while (isRunning()) {
-            wait(50);
+        if (d->searchJobs.isEmpty() && d->crawlHosts.isEmpty()) {
+            finishSearch();
         }
+
+        break;
+    }
+    default: {
+        break;
     }
+    }
+}
 
+void Smb4KClient::reportSearchResults()
+{
     //
-    // Do the actual search
+    // Only report the shares that were not reported before and that are
+    // present in the network neighborhood
     //
+    const QList<QUrl> urls = Smb4KSearchIndex::self()->search(d->searchTerm);
     QList<SharePtr> results;
 
-    for (const SharePtr &share : sharesList()) {
-        if (share->shareName().contains(item, Qt::CaseInsensitive)) {
+    for (const QUrl &url : urls) {
+        QString key = url.toString();
+
+        if (d->searchResultKeys.contains(key)) {
+            continue;
+        }
+
+        SharePtr share = findShare(url);
+
+        if (share) {
+            d->searchResultKeys.insert(key);
             results << share;
         }
     }
 
+    if (!results.isEmpty()) {
+        Q_EMIT searchResults(results);
+    }
+}
+
+void Smb4KClient::finishSearch()
+{
+    d->searchRunning = false;
+    d->searchPhase = Smb4KClientPrivate::SearchDomains;
+    d->crawlWorkgroups.clear();
+    d->crawlHosts.clear();
+
     //
-    // Emit the search results
+    // Emit the finished() signal
     //
-    Q_EMIT searchResults(results);
+    Q_EMIT finished(d->searchItem, NetworkSearch);
 
+    d->searchItem.clear();
+}
+
+void Smb4KClient::stopSearch()
+{
     //
-    // Emit the finished() signal
+    // Stop the search before its jobs are killed, so that the crawl is
+    // not continued when they report their results
+    //
+    d->searchRunning = false;
+
+    const QList<KJob *> searchJobs = d->searchJobs.values();
+    d->searchJobs.clear();
+
+    for (KJob *job : searchJobs) {
+        job->kill(KJob::EmitResult);
+    }
+
+    finishSearch();
+}
+
+QThreadPool *Smb4KClient::threadPool()
+{
+    //
+    // Apply the maximum number of concurrent lookups. This is done every time
+    // the thread pool is requested, so that changes of the setting are honored
+    // immediately.
     //
-    Q_EMIT finished(networkItem, NetworkSearch);
+    d->threadPool->setMaxThreadCount(Smb4KSettings::maximumConcurrentLookups());
+
+    return d->threadPool;
 }
 
 void Smb4KClient::processErrors(Smb4KClientBaseJob *job)
 {
+    //
+    // Do not bother the user with errors of lookups that were started
+    // in the background to confirm cached items or to refresh them
+    //
+    if ((d->reconciledItem && job->networkItem() == d->reconciledItem) || d->refreshJobs.contains(job)) {
+        return;
+    }
+
     switch (job->error()) {
     case Smb4KClientJob::AccessDeniedError: {
         switch (job->networkItem()->type()) {
@@ -457,6 +767,10 @@ void Smb4KClient::processErrors(Smb4KClientBaseJob *job)
 
         break;
     }
+    case KJob::KilledJobError: {
+        // The lookup was aborted, so there is nothing to report
+        break;
+    }
     default: {
         Smb4KNotification::networkCommunicationFailed(job->errorText());
         break;
@@ -464,6 +778,47 @@ void Smb4KClient::processErrors(Smb4KClientBaseJob *job)
     }
 }
 
+//
+// The keys used to compare discovered network items with the known ones
+//
+static QString workgroupKey(const WorkgroupPtr &workgroup)
+{
+    return workgroup->workgroupName().toCaseFolded();
+}
+
+static QString hostKey(const HostPtr &host)
+{
+    return host->workgroupName().toCaseFolded() + QStringLiteral("/") + host->hostName().toCaseFolded();
+}
+
+static QString shareKey(const SharePtr &share)
+{
+    return share->workgroupName().toCaseFolded() + QStringLiteral("/")
+        + share->url().toString(QUrl::RemoveUserInfo | QUrl::RemovePort).toCaseFolded();
+}
+
+//
+// Check whether updating a known network item with a discovered one would
+// change it
+//
+static bool workgroupChanged(const WorkgroupPtr &known, const WorkgroupPtr &discovered)
+{
+    return known->isCached() || known->masterBrowserName() != discovered->masterBrowserName()
+        || (discovered->hasMasterBrowserIpAddress() && known->masterBrowserIpAddress() != discovered->masterBrowserIpAddress());
+}
+
+static bool hostChanged(const HostPtr &known, const HostPtr &discovered)
+{
+    return known->isCached() || known->comment() != discovered->comment() || known->isMasterBrowser() != discovered->isMasterBrowser()
+        || known->url().userInfo() != discovered->url().userInfo() || (!known->hasIpAddress() && discovered->hasIpAddress());
+}
+
+static bool shareChanged(const SharePtr &known, const SharePtr &discovered)
+{
+    return known->isCached() || known->comment() != discovered->comment() || known->shareType() != discovered->shareType()
+        || known->hostIpAddress() != discovered->hostIpAddress() || known->url().userInfo() != discovered->url().userInfo();
+}
+
 void Smb4KClient::processWorkgroups(Smb4KClientBaseJob *job)
 {
     //
@@ -472,17 +827,11 @@ void Smb4KClient::processWorkgroups(Smb4KClientBaseJob *job)
     QList<WorkgroupPtr> discoveredWorkgroups = job->workgroups();
 
     for (const WorkgroupPtr &newWorkgroup : std::as_const(discoveredWorkgroups)) {
-        bool foundWorkgroup = false;
-
-        for (const WorkgroupPtr &workgroup : std::as_const(d->tempWorkgroupList)) {
-            if (workgroup->workgroupName() == newWorkgroup->workgroupName()) {
-                foundWorkgroup = true;
-                break;
-            }
-        }
+        QString key = workgroupKey(newWorkgroup);
 
-        if (!foundWorkgroup) {
+        if (!d->tempWorkgroupIndex.contains(key)) {
             d->tempWorkgroupList << newWorkgroup;
+            d->tempWorkgroupIndex.insert(key, newWorkgroup);
         }
     }
 
@@ -490,36 +839,36 @@ void Smb4KClient::processWorkgroups(Smb4KClientBaseJob *job)
     // When scanning finished, process the workgroups
     //
     if (!isRunning()) {
-        // Remove obsolete workgroups and their members
-        QListIterator<WorkgroupPtr> it(workgroupsList());
+        QList<WorkgroupPtr> addedWorkgroups, removedWorkgroups, changedWorkgroups;
 
-        while (it.hasNext()) {
-            WorkgroupPtr workgroup = it.next();
-
-            bool foundWorkgroup = false;
-
-            for (const WorkgroupPtr &w : std::as_const(d->tempWorkgroupList)) {
-                if (w->workgroupName() == workgroup->workgroupName()) {
-                    foundWorkgroup = true;
-                    break;
-                }
-            }
+        // Remove obsolete workgroups and their members
+        const QList<WorkgroupPtr> knownWorkgroups = workgroupsList();
 
-            if (!foundWorkgroup) {
+        for (const WorkgroupPtr &workgroup : knownWorkgroups) {
+            if (!d->tempWorkgroupIndex.contains(workgroupKey(workgroup))) {
                 QList<HostPtr> obsoleteHosts = workgroupMembers(workgroup);
 
                 while (!obsoleteHosts.isEmpty()) {
-                    removeHost(obsoleteHosts.takeFirst());
+                    HostPtr host = obsoleteHosts.takeFirst();
+                    Smb4KSearchIndex::self()->setShares(host, QList<SharePtr>());
+                    removeHost(host);
                 }
 
                 removeWorkgroup(workgroup);
+                removedWorkgroups << workgroup;
             }
         }
 
-        // Add new workgroups and update existing ones
+        // Add new workgroups and update the changed ones
+        QDateTime now = QDateTime::currentDateTime();
+
         for (const WorkgroupPtr &workgroup : std::as_const(d->tempWorkgroupList)) {
-            if (!findWorkgroup(workgroup->workgroupName())) {
+            WorkgroupPtr knownWorkgroup = findWorkgroup(workgroup->workgroupName());
+            workgroup->setLastSeen(now);
+
+            if (!knownWorkgroup) {
                 addWorkgroup(workgroup);
+                addedWorkgroups << workgroup;
 
                 // Since this is a new workgroup, no master browser is present.
                 HostPtr masterBrowser = HostPtr::create();
@@ -527,34 +876,66 @@ void Smb4KClient::processWorkgroups(Smb4KClientBaseJob *job)
                 masterBrowser->setHostName(workgroup->masterBrowserName());
                 masterBrowser->setIpAddress(workgroup->masterBrowserIpAddress());
                 masterBrowser->setIsMasterBrowser(true);
+                masterBrowser->setLastSeen(now);
 
                 addHost(masterBrowser);
-            } else {
+            } else if (workgroupChanged(knownWorkgroup, workgroup)) {
                 updateWorkgroup(workgroup);
+                knownWorkgroup->setCached(false);
+                changedWorkgroups << knownWorkgroup;
 
                 // Check if the master browser changed
-                QList<HostPtr> members = workgroupMembers(workgroup);
+                QList<HostPtr> members = workgroupMembers(knownWorkgroup);
 
                 for (const HostPtr &host : std::as_const(members)) {
-                    if (workgroup->masterBrowserName() == host->hostName()) {
+                    if (knownWorkgroup->masterBrowserName() == host->hostName()) {
                         host->setIsMasterBrowser(true);
 
-                        if (!host->hasIpAddress() && workgroup->hasMasterBrowserIpAddress()) {
-                            host->setIpAddress(workgroup->masterBrowserIpAddress());
+                        if (!host->hasIpAddress() && knownWorkgroup->hasMasterBrowserIpAddress()) {
+                            host->setIpAddress(knownWorkgroup->masterBrowserIpAddress());
                         }
                     } else {
                         host->setIsMasterBrowser(false);
                     }
                 }
             }
+
+            if (knownWorkgroup) {
+                knownWorkgroup->setLastSeen(now);
+            }
         }
 
         // Clear the temporary workgroup list
-        while (!d->tempWorkgroupList.isEmpty()) {
-            d->tempWorkgroupList.takeFirst().clear();
+        d->tempWorkgroupList.clear();
+        d->tempWorkgroupIndex.clear();
+
+        // Confirm the cached members of the workgroups in the background
+        const QList<WorkgroupPtr> confirmedWorkgroups = workgroupsList();
+
+        for (const WorkgroupPtr &workgroup : confirmedWorkgroups) {
+            const QList<HostPtr> members = workgroupMembers(workgroup);
+
+            for (const HostPtr &host : members) {
+                if (host->isCached()) {
+                    if (!d->staleItems.contains(workgroup)) {
+                        d->staleItems << workgroup;
+                    }
+
+                    break;
+                }
+            }
         }
 
-        Q_EMIT workgroups();
+        Smb4KNetworkCache::self()->scheduleSave();
+
+        Q_EMIT workgroupsChanged(addedWorkgroups, removedWorkgroups, changedWorkgroups);
+
+        if (!addedWorkgroups.isEmpty() || !removedWorkgroups.isEmpty() || !changedWorkgroups.isEmpty()) {
+            Q_EMIT workgroups();
+            adjustRefreshInterval(job->networkItem(), true);
+        } else {
+            adjustRefreshInterval(job->networkItem(), false);
+        }
     }
 }
 
@@ -565,88 +946,127 @@ void Smb4KClient::processHosts(Smb4KClientBaseJob *job)
     // insertion of hosts with a real workgroup/domain over
     // the ones with the DNS-SD domain (e.g. LOCAL).
     //
+    // The members of several workgroups might be looked up at the same
+    // time, so they are collected per workgroup.
+    //
+    WorkgroupPtr workgroup = job->networkItem().staticCast<Smb4KWorkgroup>();
+    QString groupKey = workgroupKey(workgroup);
+    QList<HostPtr> &collectedHosts = d->tempHostLists[groupKey];
+    QHash<QString, HostPtr> &collectedIndex = d->tempHostIndexes[groupKey];
     QList<HostPtr> discoveredHosts = job->hosts();
 
     for (const HostPtr &newHost : std::as_const(discoveredHosts)) {
-        bool foundHost = false;
-
-        QMutableListIterator<HostPtr> it(d->tempHostList);
-
-        while (it.hasNext()) {
-            HostPtr host = static_cast<HostPtr>(it.next());
-
-            if (newHost->url().matches(host->url(), QUrl::RemoveUserInfo | QUrl::RemovePort)) {
-                if (newHost->workgroupName() == host->workgroupName()) {
-                    foundHost = true;
-                } else if (host->dnsDiscovered()) {
-                    it.remove();
-                }
-
-                break;
+        QString key = newHost->url().toString(QUrl::RemoveUserInfo | QUrl::RemovePort);
+        HostPtr host = collectedIndex.value(key);
+
+        if (host) {
+            if (newHost->workgroupName() == host->workgroupName()) {
+                continue;
+            } else if (host->dnsDiscovered()) {
+                collectedHosts.removeOne(host);
+                collectedIndex.remove(key);
             }
         }
 
-        if (!foundHost) {
-            d->tempHostList << newHost;
+        collectedHosts << newHost;
+
+        if (!collectedIndex.contains(key)) {
+            collectedIndex.insert(key, newHost);
         }
     }
 
     //
-    // When scanning finished, process the hosts
+    // When all scans of the workgroup finished, process the hosts
     //
-    if (!isRunning()) {
-        // Get the workgroup pointer. Although several scans might have been
-        // running, the workgroup should have been always the same.
-        WorkgroupPtr workgroup = job->networkItem().staticCast<Smb4KWorkgroup>();
+    const QList<KJob *> jobs = subjobs();
 
-        // Remove obsolete workgroup/domain members
-        QList<HostPtr> members = workgroupMembers(workgroup);
-        QListIterator<HostPtr> it(members);
+    for (KJob *otherJob : jobs) {
+        Smb4KClientBaseJob *clientBaseJob = qobject_cast<Smb4KClientBaseJob *>(otherJob);
 
-        while (it.hasNext()) {
-            HostPtr host = it.next();
+        if (clientBaseJob && clientBaseJob->networkItem()->type() == Workgroup
+            && workgroupKey(clientBaseJob->networkItem().staticCast<Smb4KWorkgroup>()) == groupKey) {
+            return;
+        }
+    }
 
-            bool foundHost = false;
+    // Take the temporary host list of the workgroup
+    QList<HostPtr> tempHostList = d->tempHostLists.take(groupKey);
+    d->tempHostIndexes.remove(groupKey);
 
-            for (const HostPtr &h : std::as_const(d->tempHostList)) {
-                if (h->workgroupName() == host->workgroupName() && h->hostName() == host->hostName()) {
-                    foundHost = true;
-                    break;
-                }
-            }
+    QList<HostPtr> addedHosts, removedHosts, changedHosts;
+    QSet<QString> discoveredKeys;
+
+    for (const HostPtr &host : std::as_const(tempHostList)) {
+        discoveredKeys.insert(hostKey(host));
+    }
 
-            if (!foundHost) {
-                QList<SharePtr> obsoleteShares = sharedResources(host);
+    // Remove obsolete workgroup/domain members
+    const QList<HostPtr> members = workgroupMembers(workgroup);
 
-                while (!obsoleteShares.isEmpty()) {
-                    removeShare(obsoleteShares.takeFirst());
-                }
+    for (const HostPtr &host : members) {
+        if (!discoveredKeys.contains(hostKey(host))) {
+            QList<SharePtr> obsoleteShares = sharedResources(host);
 
-                removeHost(host);
+            while (!obsoleteShares.isEmpty()) {
+                removeShare(obsoleteShares.takeFirst());
             }
+
+            Smb4KSearchIndex::self()->setShares(host, QList<SharePtr>());
+            removeHost(host);
+            removedHosts << host;
         }
+    }
 
-        // Add new hosts and update existing ones
-        for (const HostPtr &host : std::as_const(d->tempHostList)) {
-            if (host->hostName() == workgroup->masterBrowserName()) {
-                host->setIsMasterBrowser(true);
-            } else {
-                host->setIsMasterBrowser(false);
-            }
+    // Add new hosts and update the changed ones
+    QDateTime now = QDateTime::currentDateTime();
 
-            if (!findHost(host->hostName(), host->workgroupName())) {
-                addHost(host);
-            } else {
-                updateHost(host);
-            }
+    for (const HostPtr &host : std::as_const(tempHostList)) {
+        host->setLastSeen(now);
+
+        if (host->hostName() == workgroup->masterBrowserName()) {
+            host->setIsMasterBrowser(true);
+        } else {
+            host->setIsMasterBrowser(false);
         }
 
-        // Clear the temporary host list
-        while (!d->tempHostList.isEmpty()) {
-            d->tempHostList.takeFirst().clear();
+        HostPtr knownHost = findHost(host->hostName(), host->workgroupName());
+
+        if (!knownHost) {
+            addHost(host);
+            addedHosts << host;
+        } else if (hostChanged(knownHost, host)) {
+            updateHost(host);
+            knownHost->setCached(false);
+            changedHosts << knownHost;
+        }
+
+        if (knownHost) {
+            knownHost->setLastSeen(now);
+
+            // Confirm the cached shares of the host in the background
+            const QList<SharePtr> knownShares = sharedResources(knownHost);
+
+            for (const SharePtr &share : knownShares) {
+                if (share->isCached()) {
+                    if (!d->staleItems.contains(knownHost)) {
+                        d->staleItems << knownHost;
+                    }
+
+                    break;
+                }
+            }
         }
+    }
 
+    Smb4KNetworkCache::self()->scheduleSave();
+
+    Q_EMIT hostsChanged(workgroup, addedHosts, removedHosts, changedHosts);
+
+    if (!addedHosts.isEmpty() || !removedHosts.isEmpty() || !changedHosts.isEmpty()) {
         Q_EMIT hosts(workgroup);
+        adjustRefreshInterval(workgroup, true);
+    } else {
+        adjustRefreshInterval(workgroup, false);
     }
 }
 
@@ -662,63 +1082,87 @@ void Smb4KClient::processShares(Smb4KClientBaseJob *job)
     HostPtr host = job->networkItem().staticCast<Smb4KHost>();
 
     //
-    // Copy the list of discovered shares
+    // Collect the discovered shares the user wants to see
     //
-    QList<SharePtr> discoveredShares = job->shares();
+    const QList<SharePtr> discoveredShares = job->shares();
+    QList<SharePtr> wantedShares;
+    QSet<QString> wantedKeys;
 
-    //
-    // Remove obsolete shares
-    //
-    QList<SharePtr> sharedRes = sharedResources(host);
-    QListIterator<SharePtr> it(sharedRes);
+    for (const SharePtr &share : discoveredShares) {
+        if (share->isHidden() && !Smb4KSettings::detectHiddenShares()) {
+            continue;
+        }
 
-    while (it.hasNext()) {
-        SharePtr share = it.next();
+        if (share->isPrinter() && !Smb4KSettings::detectPrinterShares()) {
+            continue;
+        }
+
+        wantedShares << share;
+        wantedKeys.insert(shareKey(share));
+    }
 
-        bool foundShare = false;
+    QList<SharePtr> addedShares, removedShares, changedShares;
 
-        for (const SharePtr &s : std::as_const(discoveredShares)) {
-            if (s->workgroupName() == share->workgroupName() && s->url().matches(share->url(), QUrl::RemoveUserInfo | QUrl::RemovePort)) {
-                foundShare = true;
-                break;
-            }
-        }
+    //
+    // Remove obsolete shares
+    //
+    const QList<SharePtr> sharedRes = sharedResources(host);
 
-        if (!foundShare || (share->isHidden() && !Smb4KSettings::detectHiddenShares()) || (share->isPrinter() && !Smb4KSettings::detectPrinterShares())) {
+    for (const SharePtr &share : sharedRes) {
+        if (!wantedKeys.contains(shareKey(share))) {
             removeShare(share);
+            removedShares << share;
         }
     }
 
     //
-    // Add new shares and update existing ones
+    // Add new shares and update the changed ones
     //
-    for (const SharePtr &share : std::as_const(discoveredShares)) {
-        // Process only those shares that the user wants to see
-        if (share->isHidden() && !Smb4KSettings::detectHiddenShares()) {
-            continue;
-        }
+    QDateTime now = QDateTime::currentDateTime();
 
-        if (share->isPrinter() && !Smb4KSettings::detectPrinterShares()) {
-            continue;
-        }
+    for (const SharePtr &share : std::as_const(wantedShares)) {
+        SharePtr knownShare = findShare(share->url(), share->workgroupName());
+        share->setLastSeen(now);
 
-        // Add or update the shares
-        if (!findShare(share->url(), share->workgroupName())) {
+        if (!knownShare) {
             addShare(share);
-        } else {
+            addedShares << share;
+        } else if (shareChanged(knownShare, share)) {
             updateShare(share);
+            knownShare->setCached(false);
+            changedShares << knownShare;
         }
+
+        if (knownShare) {
+            knownShare->setLastSeen(now);
+        }
+    }
+
+    Smb4KNetworkCache::self()->scheduleSave();
+    Smb4KSearchIndex::self()->setShares(host, sharedResources(host));
+
+    Q_EMIT sharesChanged(host, addedShares, removedShares, changedShares);
+
+    if (!addedShares.isEmpty() || !removedShares.isEmpty() || !changedShares.isEmpty()) {
+        Q_EMIT shares(host);
+        adjustRefreshInterval(host, true);
+    } else {
+        adjustRefreshInterval(host, false);
     }
 
-    Q_EMIT shares(host);
+    //
+    // Report new search results while the search is running
+    //
+    if (d->searchRunning) {
+        reportSearchResults();
+    }
 }
 
-void Smb4KClient::processFiles(Smb4KClientBaseJob *job)
+void Smb4KClient::processFiles(const NetworkItemPtr &item, const QList<FilePtr> &discoveredFiles)
 {
-    QList<FilePtr> discoveredFiles = job->files();
     QList<FilePtr> list;
 
-    for (const FilePtr &file : std::as_const(discoveredFiles)) {
+    for (const FilePtr &file : discoveredFiles) {
         if (file->isHidden() && !Smb4KSettings::previewHiddenItems()) {
             continue;
         }
@@ -726,7 +1170,223 @@ void Smb4KClient::processFiles(Smb4KClientBaseJob *job)
         list << file;
     }
 
-    Q_EMIT files(list);
+    if (!list.isEmpty()) {
+        Q_EMIT files(item, list);
+    }
+}
+
+void Smb4KClient::reconcileCache()
+{
+    //
+    // Only run one lookup at a time and do not interfere with the
+    // lookups started by the user
+    //
+    if (hasSubjobs() || d->searchRunning) {
+        return;
+    }
+
+    while (!d->staleItems.isEmpty()) {
+        NetworkItemPtr item = d->staleItems.takeFirst();
+
+        switch (item->type()) {
+        case Workgroup: {
+            WorkgroupPtr workgroup = findWorkgroup(item.staticCast<Smb4KWorkgroup>()->workgroupName());
+
+            if (workgroup) {
+                d->reconciledItem = workgroup;
+                lookupDomainMembers(workgroup);
+                return;
+            }
+
+            break;
+        }
+        case Host: {
+            HostPtr host = item.staticCast<Smb4KHost>();
+            HostPtr knownHost = findHost(host->hostName(), host->workgroupName());
+
+            if (knownHost && !knownHost->isCached()) {
+                d->reconciledItem = knownHost;
+                lookupShares(knownHost);
+                return;
+            }
+
+            break;
+        }
+        default: {
+            break;
+        }
+        }
+    }
+}
+
+void Smb4KClient::startRefreshTimer()
+{
+    d->refreshTimer.stop();
+
+    if (!Smb4KSettings::refreshNetworkNeighborhood() || !Smb4KHardwareInterface::self()->isOnline() || Smb4KHardwareInterface::self()->isSystemSleeping()
+        || d->refreshNodes.isEmpty()) {
+        return;
+    }
+
+    qint64 remainingTime = MAX_REFRESH_INTERVAL;
+
+    for (const Smb4KClientPrivate::RefreshNode &node : std::as_const(d->refreshNodes)) {
+        remainingTime = qMin(remainingTime, node.due.remainingTime());
+    }
+
+    d->refreshTimer.start(static_cast<int>(remainingTime));
+}
+
+void Smb4KClient::refreshNetworkNeighborhood()
+{
+    //
+    // Pause while the system is offline or asleep
+    //
+    if (!Smb4KSettings::refreshNetworkNeighborhood() || !Smb4KHardwareInterface::self()->isOnline() || Smb4KHardwareInterface::self()->isSystemSleeping()) {
+        return;
+    }
+
+    //
+    // Do not interfere with the search, the waking up of the servers
+    // and the confirmation of the cached items
+    //
+    if (d->searchRunning || !d->wakingHosts.isEmpty() || d->reconciledItem || !d->staleItems.isEmpty()) {
+        d->refreshTimer.start(REFRESH_RETRY_DELAY);
+        return;
+    }
+
+    //
+    // Collect the network items that are due, the most overdue first
+    //
+    QStringList dueKeys;
+
+    for (auto it = d->refreshNodes.constBegin(); it != d->refreshNodes.constEnd(); ++it) {
+        if (it->due.hasExpired() && !d->runningRefreshes.contains(it.key())) {
+            dueKeys << it.key();
+        }
+    }
+
+    std::sort(dueKeys.begin(), dueKeys.end(), [this](const QString &a, const QString &b) {
+        return d->refreshNodes.value(a).due < d->refreshNodes.value(b).due;
+    });
+
+    //
+    // The workgroups and the workgroup members are merged when all lookups
+    // finished, so they are never looked up together with other items
+    //
+    bool browsing = false;
+    const QList<KJob *> jobs = subjobs();
+
+    for (KJob *job : jobs) {
+        Smb4KClientBaseJob *clientBaseJob = qobject_cast<Smb4KClientBaseJob *>(job);
+
+        if (clientBaseJob && (clientBaseJob->process() == LookupDomains || clientBaseJob->process() == LookupDomainMembers)) {
+            browsing = true;
+            break;
+        }
+    }
+
+    //
+    // Leave room for the lookups started by the user
+    //
+    int budget = qMax(1, Smb4KSettings::maximumConcurrentLookups() / 2);
+
+    for (const QString &key : std::as_const(dueKeys)) {
+        NetworkItemPtr item = d->refreshNodes.value(key).networkItem;
+        bool started = false;
+
+        switch (item->type()) {
+        case Network: {
+            if (!hasSubjobs()) {
+                d->runningRefreshes.insert(key);
+
+                // Do not wake up the servers for a background refresh
+                d->wakeUpDone = true;
+                d->refreshLookup = true;
+                lookupDomains();
+                d->refreshLookup = false;
+
+                browsing = true;
+                started = true;
+            }
+
+            break;
+        }
+        case Workgroup: {
+            WorkgroupPtr workgroup = findWorkgroup(item.staticCast<Smb4KWorkgroup>()->workgroupName());
+
+            if (!workgroup) {
+                d->refreshNodes.remove(key);
+                continue;
+            }
+
+            if (!hasSubjobs()) {
+                d->runningRefreshes.insert(key);
+                d->refreshLookup = true;
+                lookupDomainMembers(workgroup);
+                d->refreshLookup = false;
+
+                browsing = true;
+                started = true;
+            }
+
+            break;
+        }
+        case Host: {
+            HostPtr host = item.staticCast<Smb4KHost>();
+            HostPtr knownHost = findHost(host->hostName(), host->workgroupName());
+
+            if (!knownHost) {
+                d->refreshNodes.remove(key);
+                continue;
+            }
+
+            if (!browsing && d->runningRefreshes.size() < budget) {
+                d->runningRefreshes.insert(key);
+                d->refreshLookup = true;
+                lookupShares(knownHost);
+                d->refreshLookup = false;
+
+                started = true;
+            }
+
+            break;
+        }
+        default: {
+            break;
+        }
+        }
+
+        //
+        // The interval is adjusted when the results were processed
+        //
+        auto it = d->refreshNodes.find(key);
+
+        if (it != d->refreshNodes.end()) {
+            it->due.setRemainingTime(started ? jitteredInterval(it->interval) : REFRESH_RETRY_DELAY);
+        }
+    }
+
+    startRefreshTimer();
+}
+
+void Smb4KClient::adjustRefreshInterval(const NetworkItemPtr &item, bool changed)
+{
+    auto it = d->refreshNodes.find(refreshKey(item));
+
+    if (it == d->refreshNodes.end()) {
+        return;
+    }
+
+    if (changed) {
+        it->interval = qMax(MIN_REFRESH_INTERVAL, it->interval / 4);
+    } else {
+        it->interval = qMin(MAX_REFRESH_INTERVAL, it->interval * 2);
+    }
+
+    it->due.setRemainingTime(jitteredInterval(it->interval));
+
+    startRefreshTimer();
 }
 
 void Smb4KClient::slotStartJobs()
@@ -736,19 +1396,53 @@ void Smb4KClient::slotStartJobs()
 
 void Smb4KClient::slotOnlineStateChanged(bool online)
 {
+    //
+    // The network changed, so the cached IP addresses might be stale
+    //
+    Smb4KHostResolver::self()->clear();
+    Smb4KClientContextPool::self()->clear();
+
     if (online) {
         slotStartJobs();
+        startRefreshTimer();
     } else {
+        d->refreshTimer.stop();
         abort();
     }
 }
 
+void Smb4KClient::slotSystemSleepStateChanged(bool sleep)
+{
+    //
+    // The refresh is resumed when the online state was checked after
+    // the system woke up
+    //
+    if (sleep) {
+        d->refreshTimer.stop();
+        Smb4KClientContextPool::self()->clear();
+    }
+}
+
+bool Smb4KClient::addSubjob(KJob *job)
+{
+    if (d->searchLookup) {
+        d->searchJobs.insert(job);
+    }
+
+    if (d->refreshLookup) {
+        d->refreshJobs.insert(job);
+    }
+
+    return KCompositeJob::addSubjob(job);
+}
+
 void Smb4KClient::slotResult(KJob *job)
 {
     //
     // Remove the job
     //
     removeSubjob(job);
+    d->searchJobs.remove(job);
 
     //
     // Get the client base job
@@ -782,14 +1476,10 @@ void Smb4KClient::slotResult(KJob *job)
             processShares(clientBaseJob);
             break;
         }
-        case Share: {
-            processFiles(clientBaseJob);
-            break;
-        }
+        case Share:
         case FileOrDirectory: {
-            if (networkItem.staticCast<Smb4KFile>()->isDirectory()) {
-                processFiles(clientBaseJob);
-            }
+            // The files and directories were already reported while the
+            // directory was read
             break;
         }
         default: {
@@ -800,11 +1490,51 @@ void Smb4KClient::slotResult(KJob *job)
         processErrors(clientBaseJob);
     }
 
+    //
+    // The background refresh of the network item finished when all of
+    // its lookups returned
+    //
+    if (d->refreshJobs.remove(job)) {
+        QString key = refreshKey(networkItem);
+        bool finishedRefresh = true;
+
+        for (KJob *refreshJob : std::as_const(d->refreshJobs)) {
+            Smb4KClientBaseJob *otherJob = qobject_cast<Smb4KClientBaseJob *>(refreshJob);
+
+            if (otherJob && refreshKey(otherJob->networkItem()) == key) {
+                finishedRefresh = false;
+                break;
+            }
+        }
+
+        if (finishedRefresh) {
+            d->runningRefreshes.remove(key);
+        }
+    }
+
+    //
+    // Continue the search
+    //
+    if (d->searchRunning) {
+        continueSearch();
+    }
+
     //
     // Emit the finished signal when all subjobs finished
     //
     if (!hasSubjobs()) {
         Q_EMIT finished(networkItem, process);
+
+        //
+        // Continue to confirm the cached items
+        //
+        d->reconciledItem.clear();
+
+        if (!d->staleItems.isEmpty()) {
+            QTimer::singleShot(0, this, [this]() {
+                reconcileCache();
+            });
+        }
     }
 
     //
@@ -813,9 +1543,47 @@ void Smb4KClient::slotResult(KJob *job)
     networkItem.clear();
 }
 
+void Smb4KClient::slotHostWokenUp(const QString &host, bool ready)
+{
+    Q_UNUSED(ready);
+
+    if (!d->wakingHosts.remove(host.toCaseFolded()) || !d->wakingHosts.isEmpty()) {
+        return;
+    }
+
+    Q_EMIT finished(d->wakeUpItem, WakeUp);
+    d->wakeUpItem.clear();
+
+    //
+    // Start the lookup that waited for the servers. Servers that did not
+    // answer in time are looked up nonetheless.
+    //
+    d->wakeUpDone = true;
+    d->searchLookup = d->searchRunning && d->searchPhase == Smb4KClientPrivate::SearchDomains;
+    lookupDomains();
+    d->searchLookup = false;
+}
+
 void Smb4KClient::slotAboutToQuit()
 {
     abort();
+
+    //
+    // Do not start the queued lookups anymore and give the running ones
+    // some time to return. Lookups that hang on an unresponsive server
+    // are abandoned, so that the application does not hang on exit.
+    //
+    d->threadPool->clear();
+
+    if (!d->threadPool->waitForDone(QUIT_TIMEOUT)) {
+        const QList<Smb4KClientJob *> jobs = findChildren<Smb4KClientJob *>(Qt::FindDirectChildrenOnly);
+
+        for (Smb4KClientJob *job : jobs) {
+            job->abandon();
+        }
+    }
+
+    Smb4KClientContextPool::self()->clear();
 }
 
 void Smb4KClient::slotAbort()
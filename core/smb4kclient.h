@@ -24,6 +24,7 @@ class Smb4KClientPrivate;
 class Smb4KBasicNetworkItem;
 class Smb4KClientBaseJob;
 class Smb4KPreviewDialog;
+class QThreadPool;
 
 class SMB4KCORE_EXPORT Smb4KClient : public KCompositeJob
 {
@@ -106,12 +107,27 @@ public:
     void printFile(const SharePtr &share, const KFileItem &fileItem, int copies);
 
     /**
-     * Perform a search on the entire network neighborhood
+     * Perform a search on the entire network neighborhood. The shares that
+     * are already known from the search index are reported right away. The
+     * network neighborhood is then crawled and new matches are reported
+     * with the searchResults() signal as soon as they are found.
      *
      * @param item            The search item
      */
     void search(const QString &item);
 
+    /**
+     * Refresh the workgroup or host @p item periodically in the background,
+     * e.g. because it is expanded in the network browser. The list of
+     * workgroups is always refreshed. The interval grows while the results
+     * stay the same and shrinks when they change.
+     *
+     * @param item            The workgroup or host
+     *
+     * @param refresh         TRUE if the item should be refreshed
+     */
+    void setAutoRefresh(const NetworkItemPtr &item, bool refresh);
+
 Q_SIGNALS:
     /**
      * This signal is emitted when the client starts its work.
@@ -130,33 +146,76 @@ Q_SIGNALS:
     void finished(const NetworkItemPtr &item, int type);
 
     /**
-     * Emitted when the requested list of workgroups was acquired
+     * Emitted when the requested list of workgroups was acquired and
+     * the global list of workgroups changed
      */
     void workgroups();
 
     /**
      * Emitted when the requested list of workgroup members was acquired
+     * and the members of the workgroup changed
      *
      * @param workgroup     The workgroup that was queried
      */
     void hosts(const WorkgroupPtr &workgroup);
 
     /**
-     * Emitted when the requested list of shares was acquired
+     * Emitted when the requested list of shares was acquired and the
+     * shares of the host changed
      *
      * @param host          The host that was queried
      */
     void shares(const HostPtr &host);
 
     /**
-     * Emitted when the requested list of files and directories was acquired
+     * Emitted when the requested list of workgroups was acquired. The
+     * lists contain the changes that were applied to the global list
+     * of workgroups. They are empty if nothing changed.
+     *
+     * @param added         The workgroups that were added
+     * @param removed       The workgroups that were removed
+     * @param changed       The workgroups that were updated
+     */
+    void workgroupsChanged(const QList<WorkgroupPtr> &added, const QList<WorkgroupPtr> &removed, const QList<WorkgroupPtr> &changed);
+
+    /**
+     * Emitted when the requested list of workgroup members was acquired.
+     * The lists contain the changes that were applied to the global list
+     * of hosts. They are empty if nothing changed.
+     *
+     * @param workgroup     The workgroup that was queried
+     * @param added         The hosts that were added
+     * @param removed       The hosts that were removed
+     * @param changed       The hosts that were updated
+     */
+    void hostsChanged(const WorkgroupPtr &workgroup, const QList<HostPtr> &added, const QList<HostPtr> &removed, const QList<HostPtr> &changed);
+
+    /**
+     * Emitted when the requested list of shares was acquired. The lists
+     * contain the changes that were applied to the global list of shares.
+     * They are empty if nothing changed.
+     *
+     * @param host          The host that was queried
+     * @param added         The shares that were added
+     * @param removed       The shares that were removed
+     * @param changed       The shares that were updated
+     */
+    void sharesChanged(const HostPtr &host, const QList<SharePtr> &added, const QList<SharePtr> &removed, const QList<SharePtr> &changed);
+
+    /**
+     * Emitted while the contents of a share or directory are read. The
+     * signal is emitted several times for large directories, each time
+     * with the files and directories discovered since the last emission.
      *
+     * @param item          The share or directory that is read
      * @param list          The list of files and directories
      */
-    void files(const QList<FilePtr> &list);
+    void files(const NetworkItemPtr &item, const QList<FilePtr> &list);
 
     /**
-     * Emitted when a search was done
+     * Emitted when shares matching the search term were found. The signal
+     * is emitted several times during a search, each time with the shares
+     * that were not reported yet.
      *
      * @param list          The list of search results
      */
@@ -170,6 +229,14 @@ Q_SIGNALS:
      */
     void requestCredentials(const NetworkItemPtr &networkItem);
 
+protected:
+    /**
+     * Add a job to the subjobs. The jobs started by the network search are
+     * remembered, so that they can be stopped separately. Reimplemented from
+     * KCompositeJob.
+     */
+    bool addSubjob(KJob *job) override;
+
 protected Q_SLOTS:
     /**
      * Start the composite job
@@ -181,6 +248,11 @@ protected Q_SLOTS:
      */
     void slotOnlineStateChanged(bool online);
 
+    /**
+     * Pause the background refresh while the system is asleep
+     */
+    void slotSystemSleepStateChanged(bool sleep);
+
     /**
      * Called when a job finished. Reimplemented from KCompositeJob.
      */
@@ -201,7 +273,24 @@ protected Q_SLOTS:
      */
     void slotCredentialsUpdated(const QUrl &url);
 
+    /**
+     * Called when a server was woken up
+     */
+    void slotHostWokenUp(const QString &host, bool ready);
+
 private:
+    /**
+     * Returns the thread pool the lookups are run on
+     */
+    QThreadPool *threadPool();
+
+    /**
+     * Send the Wake-On-LAN packets to the servers that should be woken up
+     * before the network scan. Returns TRUE if the scan has to wait for
+     * the servers.
+     */
+    bool wakeUpHosts();
+
     /**
      * Process errors
      */
@@ -231,9 +320,54 @@ private:
     /**
      * Process the files and directories
      *
-     * @param job             The client job
+     * @param item            The share or directory that is read
+     * @param files           The discovered files and directories
+     */
+    void processFiles(const NetworkItemPtr &item, const QList<FilePtr> &files);
+
+    /**
+     * Look up the members of a workgroup or the shares of a host that were
+     * loaded from the network neighborhood cache to confirm them. Only one
+     * lookup is run at a time.
+     */
+    void reconcileCache();
+
+    /**
+     * Start the next lookups of the network search
+     */
+    void continueSearch();
+
+    /**
+     * Report the search results that were not reported yet
+     */
+    void reportSearchResults();
+
+    /**
+     * Finish the network search
+     */
+    void finishSearch();
+
+    /**
+     * Stop the running network search. Only the lookups started by the
+     * search are aborted.
+     */
+    void stopSearch();
+
+    /**
+     * Start the refresh timer for the network item that is due next
+     */
+    void startRefreshTimer();
+
+    /**
+     * Refresh the network items that are due within the concurrency budget
+     */
+    void refreshNetworkNeighborhood();
+
+    /**
+     * Adjust the refresh interval of @p item depending on whether the last
+     * lookup @p changed the list of its children
      */
-    void processFiles(Smb4KClientBaseJob *job);
+    void adjustRefreshInterval(const NetworkItemPtr &item, bool changed);
 
     /**
      * Pointer to the Smb4KClientPrivate class
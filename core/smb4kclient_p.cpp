@@ -18,14 +18,24 @@
 #include <sys/stat.h>
 
 // Qt includes
+#if (QT_VERSION >= QT_VERSION_CHECK(6, 8, 0))
+#include <QApplicationStatic>
+#else
+#include <qapplicationstatic.h>
+#endif
 #include <QAbstractSocket>
+#include <QCryptographicHash>
 #include <QDebug>
 #include <QDir>
+#include <QElapsedTimer>
 #include <QHostInfo>
 #include <QNetworkInterface>
+#include <QMutexLocker>
 #include <QPrinter>
+#include <QSharedPointer>
 #include <QTemporaryDir>
 #include <QTextDocument>
+#include <QThread>
 #include <QUuid>
 
 // KDE includes
@@ -37,13 +47,677 @@
 #include <KDSoapClient/KDSoapClientInterface>
 #include <KDSoapClient/KDSoapMessage>
 #include <KDSoapClient/KDSoapMessageAddressingProperties>
+#include <KDSoapClient/KDSoapPendingCall>
+#include <KDSoapClient/KDSoapPendingCallWatcher>
 #include <WSDiscoveryTargetService>
 #endif
 
 #define SMBC_DEBUG 0
 
+//
+// Maximum number of files and directories and maximum time in msec
+// before the entries read so far are reported
+//
+#define FILE_CHUNK_SIZE 256
+#define FILE_CHUNK_INTERVAL 50
+
 using namespace Smb4KGlobal;
 
+//
+// Host resolver
+//
+
+//
+// Time in msec successful and failed lookups are kept in the cache
+//
+#define POSITIVE_CACHE_TIMEOUT 300000
+#define NEGATIVE_CACHE_TIMEOUT 30000
+
+Q_APPLICATION_STATIC(Smb4KHostResolver, resolver);
+
+//
+// Get the IP address for the host. For the time being, prefer the
+// IPv4 address over the IPv6 address. Only global addresses are used.
+//
+static QHostAddress preferredAddress(const QList<QHostAddress> &addresses)
+{
+    QHostAddress ipAddress;
+
+    for (const QHostAddress &addr : addresses) {
+        if (addr.isGlobal()) {
+            if (addr.protocol() == QAbstractSocket::IPv4Protocol) {
+                ipAddress = addr;
+                break;
+            } else if (addr.protocol() == QAbstractSocket::IPv6Protocol) {
+                // FIXME: Use the right address here.
+                ipAddress = addr;
+            }
+        }
+    }
+
+    return ipAddress;
+}
+
+Smb4KHostResolver::Smb4KHostResolver()
+{
+}
+
+Smb4KHostResolver::~Smb4KHostResolver()
+{
+}
+
+Smb4KHostResolver *Smb4KHostResolver::self()
+{
+    return resolver;
+}
+
+void Smb4KHostResolver::resolve(const QStringList &names, QObject *receiver, const std::function<void(const QHash<QString, QHostAddress> &)> &callback)
+{
+    //
+    // The state of the lookups. It is only accessed in the thread of the
+    // receiver, so no locking is needed.
+    //
+    struct Lookups {
+        QHash<QString, QHostAddress> addresses;
+        int pending = 0;
+    };
+
+    QSharedPointer<Lookups> lookups = QSharedPointer<Lookups>::create();
+    QStringList pendingNames;
+
+    //
+    // Take the addresses from the cache if possible
+    //
+    for (const QString &name : names) {
+        QString key = name.toUpper();
+
+        if (lookups->addresses.contains(key) || pendingNames.contains(key)) {
+            continue;
+        }
+
+        QHostAddress ipAddress;
+
+        if (findCachedAddress(key, &ipAddress)) {
+            lookups->addresses.insert(key, ipAddress);
+        } else if (key == QHostInfo::localHostName().toUpper() || key == machineNetbiosName().toUpper()) {
+            //
+            // The IP address of the local machine is determined with
+            // QNetworkInterface
+            //
+            ipAddress = preferredAddress(QNetworkInterface::allAddresses());
+            insertAddress(key, ipAddress);
+            lookups->addresses.insert(key, ipAddress);
+        } else {
+            pendingNames << key;
+        }
+    }
+
+    if (pendingNames.isEmpty()) {
+        callback(lookups->addresses);
+        return;
+    }
+
+    //
+    // Look up the remaining names in parallel
+    //
+    lookups->pending = pendingNames.size();
+
+    for (const QString &name : std::as_const(pendingNames)) {
+        QHostInfo::lookupHost(name, receiver, [this, name, lookups, callback](const QHostInfo &hostInfo) {
+            QHostAddress ipAddress;
+
+            if (hostInfo.error() == QHostInfo::NoError) {
+                ipAddress = preferredAddress(hostInfo.addresses());
+            }
+
+            insertAddress(name, ipAddress);
+            lookups->addresses.insert(name, ipAddress);
+
+            if (--lookups->pending == 0) {
+                callback(lookups->addresses);
+            }
+        });
+    }
+}
+
+void Smb4KHostResolver::insert(const QString &name, const QHostAddress &address)
+{
+    insertAddress(name.toUpper(), address);
+}
+
+void Smb4KHostResolver::clear()
+{
+    QMutexLocker locker(&m_mutex);
+    m_cache.clear();
+}
+
+bool Smb4KHostResolver::findCachedAddress(const QString &key, QHostAddress *address)
+{
+    QMutexLocker locker(&m_mutex);
+
+    auto it = m_cache.constFind(key);
+
+    if (it != m_cache.constEnd() && !it->expiry.hasExpired()) {
+        *address = it->address;
+        return true;
+    }
+
+    return false;
+}
+
+void Smb4KHostResolver::insertAddress(const QString &key, const QHostAddress &address)
+{
+    QMutexLocker locker(&m_mutex);
+
+    CacheEntry entry;
+    entry.address = address;
+    entry.expiry.setRemainingTime(address.isNull() ? NEGATIVE_CACHE_TIMEOUT : POSITIVE_CACHE_TIMEOUT);
+
+    m_cache.insert(key, entry);
+}
+
+//
+// Context pool
+//
+
+//
+// Maximum number of idle contexts kept in the pool
+//
+#define MAX_IDLE_CONTEXTS 16
+
+Q_APPLICATION_STATIC(Smb4KClientContextPool, contextPool);
+
+Smb4KClientContextPool::Smb4KClientContextPool()
+{
+    m_timer.setSingleShot(true);
+    QObject::connect(&m_timer, &QTimer::timeout, [this]() {
+        purge();
+    });
+}
+
+Smb4KClientContextPool::~Smb4KClientContextPool()
+{
+    clear();
+}
+
+Smb4KClientContextPool *Smb4KClientContextPool::self()
+{
+    return contextPool;
+}
+
+SMBCCTX *Smb4KClientContextPool::acquire(const QString &key)
+{
+    purge();
+
+    //
+    // Prefer the context that was used most recently
+    //
+    for (int i = m_contexts.size() - 1; i >= 0; --i) {
+        if (m_contexts.at(i).key == key) {
+            return m_contexts.takeAt(i).context;
+        }
+    }
+
+    return nullptr;
+}
+
+void Smb4KClientContextPool::release(const QString &key, SMBCCTX *context)
+{
+    int idleTime = 1000 * Smb4KSettings::clientContextIdleTime();
+
+    if (idleTime == 0) {
+        smbc_free_context(context, 1);
+        return;
+    }
+
+    //
+    // The context must not point to the finished job anymore
+    //
+    smbc_setOptionUserData(context, nullptr);
+
+    IdleContext idleContext;
+    idleContext.key = key;
+    idleContext.context = context;
+    idleContext.expiry.setRemainingTime(idleTime);
+
+    m_contexts << idleContext;
+
+    while (m_contexts.size() > MAX_IDLE_CONTEXTS) {
+        smbc_free_context(m_contexts.takeFirst().context, 1);
+    }
+
+    purge();
+}
+
+void Smb4KClientContextPool::clear()
+{
+    m_timer.stop();
+
+    while (!m_contexts.isEmpty()) {
+        smbc_free_context(m_contexts.takeFirst().context, 1);
+    }
+}
+
+void Smb4KClientContextPool::purge()
+{
+    m_timer.stop();
+
+    //
+    // Free the contexts that were idle for too long. This also closes
+    // the connections to the servers.
+    //
+    QMutableListIterator<IdleContext> it(m_contexts);
+    qint64 remainingTime = -1;
+
+    while (it.hasNext()) {
+        IdleContext &idleContext = it.next();
+
+        if (idleContext.expiry.hasExpired()) {
+            smbc_free_context(idleContext.context, 1);
+            it.remove();
+        } else if (remainingTime == -1 || idleContext.expiry.remainingTime() < remainingTime) {
+            remainingTime = idleContext.expiry.remainingTime();
+        }
+    }
+
+    if (remainingTime != -1) {
+        m_timer.start(remainingTime);
+    }
+}
+
+//
+// libsmbclient backend
+//
+
+//
+// Convert a time stamp returned by readdirplus
+//
+static QDateTime fileDateTime(const struct timespec &time)
+{
+    if (time.tv_sec == 0 && time.tv_nsec == 0) {
+        return QDateTime();
+    }
+
+    return QDateTime::fromMSecsSinceEpoch(static_cast<qint64>(time.tv_sec) * 1000 + time.tv_nsec / 1000000);
+}
+
+Smb4KLibsmbclientBackend::Smb4KLibsmbclientBackend(SMBCCTX *context)
+    : m_context(context)
+    , m_directory(nullptr)
+    , m_withAttributes(false)
+{
+}
+
+Smb4KLibsmbclientBackend::~Smb4KLibsmbclientBackend()
+{
+    closeDirectory();
+}
+
+int Smb4KLibsmbclientBackend::openDirectory(const QUrl &url, bool withAttributes)
+{
+    //
+    // Do not set the context globally with smbc_set_context() here, because
+    // several lookups might run in parallel on different threads. Only use
+    // the functions provided by the context.
+    //
+    smbc_opendir_fn openDirectoryFunction = smbc_getFunctionOpendir(m_context);
+
+    if (!openDirectoryFunction) {
+        return errno;
+    }
+
+    m_directory = openDirectoryFunction(m_context, url.toString().toUtf8().data());
+
+    if (!m_directory) {
+        return errno;
+    }
+
+    m_withAttributes = withAttributes;
+
+    return 0;
+}
+
+bool Smb4KLibsmbclientBackend::readDirectory(Entry *entry)
+{
+    if (!m_directory) {
+        return false;
+    }
+
+    if (m_withAttributes) {
+        //
+        // Read the contents of the share or directory with readdirplus. It
+        // returns the size, the time stamps and the attributes along with
+        // the names, so no file needs to be stat'ed separately.
+        //
+        smbc_readdirplus_fn readDirectoryPlus = smbc_getFunctionReaddirPlus(m_context);
+        const struct libsmb_file_info *fileInfo = readDirectoryPlus ? readDirectoryPlus(m_context, m_directory) : nullptr;
+
+        if (!fileInfo) {
+            return false;
+        }
+
+        entry->type = (fileInfo->attrs & SMBC_DOS_MODE_DIRECTORY) ? DirectoryEntry : FileEntry;
+        entry->name = QString::fromUtf8(fileInfo->name, -1);
+        entry->comment.clear();
+        entry->size = static_cast<qint64>(fileInfo->size);
+        entry->hidden = fileInfo->attrs & SMBC_DOS_MODE_HIDDEN;
+        entry->readOnly = fileInfo->attrs & SMBC_DOS_MODE_READONLY;
+        entry->lastModified = fileDateTime(fileInfo->mtime_ts);
+        entry->created = fileDateTime(fileInfo->btime_ts);
+
+        return true;
+    }
+
+    smbc_readdir_fn readDirectoryFunction = smbc_getFunctionReaddir(m_context);
+    struct smbc_dirent *directoryEntry = readDirectoryFunction ? readDirectoryFunction(m_context, m_directory) : nullptr;
+
+    if (!directoryEntry) {
+        return false;
+    }
+
+    switch (directoryEntry->smbc_type) {
+    case SMBC_WORKGROUP: {
+        entry->type = WorkgroupEntry;
+        break;
+    }
+    case SMBC_SERVER: {
+        entry->type = ServerEntry;
+        break;
+    }
+    case SMBC_FILE_SHARE: {
+        entry->type = FileShareEntry;
+        break;
+    }
+    case SMBC_PRINTER_SHARE: {
+        entry->type = PrinterShareEntry;
+        break;
+    }
+    case SMBC_IPC_SHARE: {
+        entry->type = IpcShareEntry;
+        break;
+    }
+    case SMBC_DIR: {
+        entry->type = DirectoryEntry;
+        break;
+    }
+    case SMBC_FILE: {
+        entry->type = FileEntry;
+        break;
+    }
+    case SMBC_LINK: {
+        entry->type = LinkEntry;
+        break;
+    }
+    default: {
+        entry->type = UnknownEntry;
+        break;
+    }
+    }
+
+    entry->name = QString::fromUtf8(directoryEntry->name, -1);
+    entry->comment = QString::fromUtf8(directoryEntry->comment, -1);
+    entry->size = -1;
+    entry->hidden = false;
+    entry->readOnly = false;
+    entry->lastModified = QDateTime();
+    entry->created = QDateTime();
+
+    return true;
+}
+
+void Smb4KLibsmbclientBackend::closeDirectory()
+{
+    if (!m_directory) {
+        return;
+    }
+
+    smbc_closedir_fn closeDirectoryFunction = smbc_getFunctionClosedir(m_context);
+
+    if (closeDirectoryFunction) {
+        (void)closeDirectoryFunction(m_context, m_directory);
+    }
+
+    m_directory = nullptr;
+}
+
+void Smb4KLibsmbclientBackend::lookupIpAddresses(const QStringList &names,
+                                                 QObject *receiver,
+                                                 const std::function<void(const QHash<QString, QHostAddress> &)> &callback)
+{
+    Smb4KHostResolver::self()->resolve(names, receiver, callback);
+}
+
+//
+// Synthetic backend
+//
+// The synthetic backend generates a network neighborhood of the size given
+// with the SMB4K_SYNTHETIC_NETWORK environment variable, so that the scanning
+// can be profiled without a real network. Example:
+//
+//   SMB4K_SYNTHETIC_NETWORK="workgroups=200,hosts=500,shares=50,files=100,latency=20,failures=1"
+//
+// The latency is the time in msec it takes to open a directory and the
+// failures are the percentage of workgroups, hosts, shares and directories
+// that cannot be read. Every tenth entry of a share or directory is a
+// directory.
+//
+
+//
+// Maximum depth of the generated directory trees
+//
+#define SYNTHETIC_MAX_DEPTH 3
+
+struct Smb4KSyntheticNetwork {
+    bool enabled;
+    int workgroups;
+    int hosts;
+    int shares;
+    int files;
+    int latency;
+    int failures;
+};
+
+static const Smb4KSyntheticNetwork &syntheticNetwork()
+{
+    static const Smb4KSyntheticNetwork network = []() {
+        Smb4KSyntheticNetwork n;
+        n.enabled = qEnvironmentVariableIsSet("SMB4K_SYNTHETIC_NETWORK");
+        n.workgroups = 10;
+        n.hosts = 50;
+        n.shares = 10;
+        n.files = 100;
+        n.latency = 0;
+        n.failures = 0;
+
+        const QStringList parameters = qEnvironmentVariable("SMB4K_SYNTHETIC_NETWORK").split(QStringLiteral(","), Qt::SkipEmptyParts);
+
+        for (const QString &parameter : parameters) {
+            QString key = parameter.section(QStringLiteral("="), 0, 0).trimmed();
+            int value = qMax(0, parameter.section(QStringLiteral("="), 1, 1).trimmed().toInt());
+
+            if (key == QStringLiteral("workgroups")) {
+                n.workgroups = value;
+            } else if (key == QStringLiteral("hosts")) {
+                n.hosts = value;
+            } else if (key == QStringLiteral("shares")) {
+                n.shares = value;
+            } else if (key == QStringLiteral("files")) {
+                n.files = value;
+            } else if (key == QStringLiteral("latency")) {
+                n.latency = value;
+            } else if (key == QStringLiteral("failures")) {
+                n.failures = qMin(value, 100);
+            }
+        }
+
+        return n;
+    }();
+
+    return network;
+}
+
+Smb4KSyntheticBackend::Smb4KSyntheticBackend()
+    : m_index(0)
+{
+}
+
+Smb4KSyntheticBackend::~Smb4KSyntheticBackend()
+{
+}
+
+bool Smb4KSyntheticBackend::isEnabled()
+{
+    return syntheticNetwork().enabled;
+}
+
+int Smb4KSyntheticBackend::openDirectory(const QUrl &url, bool withAttributes)
+{
+    const Smb4KSyntheticNetwork &network = syntheticNetwork();
+
+    m_entries.clear();
+    m_index = 0;
+
+    if (network.latency > 0) {
+        QThread::msleep(network.latency);
+    }
+
+    auto createEntry = [](EntryType type, const QString &name, const QString &comment) {
+        Entry entry;
+        entry.type = type;
+        entry.name = name;
+        entry.comment = comment;
+        entry.size = -1;
+        entry.hidden = false;
+        entry.readOnly = false;
+        return entry;
+    };
+
+    QString host = url.host().toUpper();
+    QStringList path = url.path().split(QStringLiteral("/"), Qt::SkipEmptyParts);
+
+    //
+    // The network neighborhood
+    //
+    if (host.isEmpty()) {
+        for (int i = 0; i < network.workgroups; ++i) {
+            m_entries << createEntry(WorkgroupEntry, QStringLiteral("WORKGROUP%1").arg(i), QStringLiteral("HOST-%1-0").arg(i));
+        }
+
+        return 0;
+    }
+
+    //
+    // The same hosts, shares and directories always fail
+    //
+    if (network.failures > 0 && qHash(host + url.path()) % 100 < static_cast<uint>(network.failures)) {
+        return EHOSTUNREACH;
+    }
+
+    bool ok = false;
+
+    if (host.startsWith(QStringLiteral("WORKGROUP"))) {
+        //
+        // The members of a workgroup
+        //
+        int workgroup = host.mid(9).toInt(&ok);
+
+        if (!ok || workgroup >= network.workgroups || !path.isEmpty()) {
+            return ENOENT;
+        }
+
+        for (int i = 0; i < network.hosts; ++i) {
+            m_entries << createEntry(ServerEntry, QStringLiteral("HOST-%1-%2").arg(workgroup).arg(i), QStringLiteral("Synthetic host"));
+        }
+
+        return 0;
+    }
+
+    if (!host.startsWith(QStringLiteral("HOST-")) || host.section(QStringLiteral("-"), 1, 1).toInt(&ok) >= network.workgroups || !ok
+        || host.section(QStringLiteral("-"), 2, 2).toInt(&ok) >= network.hosts || !ok) {
+        return ENOENT;
+    }
+
+    //
+    // The shares of a host
+    //
+    if (path.isEmpty()) {
+        for (int i = 0; i < network.shares; ++i) {
+            m_entries << createEntry(FileShareEntry, QStringLiteral("share%1").arg(i), QStringLiteral("Synthetic share"));
+        }
+
+        m_entries << createEntry(IpcShareEntry, QStringLiteral("IPC$"), QStringLiteral("IPC Service"));
+
+        return 0;
+    }
+
+    //
+    // The contents of a share or directory
+    //
+    if (!withAttributes) {
+        return EINVAL;
+    }
+
+    QDateTime lastModified = QDateTime::fromSecsSinceEpoch(1767225600);
+
+    for (int i = 0; i < network.files; ++i) {
+        if (i % 10 == 9 && path.size() < SYNTHETIC_MAX_DEPTH) {
+            Entry entry = createEntry(DirectoryEntry, QStringLiteral("directory%1").arg(i), QString());
+            entry.lastModified = lastModified.addSecs(3600 * i);
+            entry.created = lastModified;
+            m_entries << entry;
+        } else {
+            Entry entry = createEntry(FileEntry, QStringLiteral("file%1.dat").arg(i), QString());
+            entry.size = 1024 * (i + 1);
+            entry.hidden = (i % 50 == 0);
+            entry.readOnly = (i % 7 == 0);
+            entry.lastModified = lastModified.addSecs(3600 * i);
+            entry.created = lastModified;
+            m_entries << entry;
+        }
+    }
+
+    return 0;
+}
+
+bool Smb4KSyntheticBackend::readDirectory(Entry *entry)
+{
+    if (m_index >= m_entries.size()) {
+        return false;
+    }
+
+    *entry = m_entries.at(m_index++);
+
+    return true;
+}
+
+void Smb4KSyntheticBackend::closeDirectory()
+{
+    m_entries.clear();
+    m_index = 0;
+}
+
+void Smb4KSyntheticBackend::lookupIpAddresses(const QStringList &names,
+                                              QObject *receiver,
+                                              const std::function<void(const QHash<QString, QHostAddress> &)> &callback)
+{
+    Q_UNUSED(receiver);
+
+    //
+    // Every synthetic host gets a stable address in 10.0.0.0/8
+    //
+    QHash<QString, QHostAddress> addresses;
+
+    for (const QString &name : names) {
+        QString key = name.toUpper();
+
+        if (key.startsWith(QStringLiteral("HOST-"))) {
+            addresses.insert(key, QHostAddress(0x0A000000 | (qHash(key) & 0x00FFFFFF)));
+        }
+    }
+
+    callback(addresses);
+}
+
 //
 // Client base job
 //
@@ -106,75 +780,17 @@ QList<WorkgroupPtr> Smb4KClientBaseJob::workgroups()
 
 QList<HostPtr> Smb4KClientBaseJob::hosts()
 {
-    return m_hosts;
-}
-
-QList<SharePtr> Smb4KClientBaseJob::shares()
-{
-    return m_shares;
-}
-
-QList<FilePtr> Smb4KClientBaseJob::files()
-{
-    return m_files;
-}
-
-QHostAddress Smb4KClientBaseJob::lookupIpAddress(const QString &name)
-{
-    //
-    // The IP address object
-    //
-    QHostAddress ipAddress;
-
-    //
-    // Get the IP address
-    //
-    // If the IP address is not to be determined for the local machine, we can use QHostInfo to
-    // determine it. Otherwise we need to use QNetworkInterface for it.
-    //
-    if (name.toUpper() == QHostInfo::localHostName().toUpper() || name.toUpper() == machineNetbiosName().toUpper()) {
-        // FIXME: Do we need to honor 'interfaces' here?
-        QList<QHostAddress> addresses = QNetworkInterface::allAddresses();
+    return m_hosts;
+}
 
-        // Get the IP address for the host. For the time being, prefer the
-        // IPv4 address over the IPv6 address.
-        for (const QHostAddress &addr : std::as_const(addresses)) {
-            // We only use global addresses.
-            if (addr.isGlobal()) {
-                if (addr.protocol() == QAbstractSocket::IPv4Protocol) {
-                    ipAddress = addr;
-                    break;
-                } else if (addr.protocol() == QAbstractSocket::IPv6Protocol) {
-                    // FIXME: Use the right address here.
-                    ipAddress = addr;
-                }
-            }
-        }
-    } else {
-        // Get the IP address
-        QHostInfo hostInfo = QHostInfo::fromName(name);
-
-        if (hostInfo.error() == QHostInfo::NoError) {
-            QList<QHostAddress> addresses = hostInfo.addresses();
-
-            // Get the IP address for the host. For the time being, prefer the
-            // IPv4 address over the IPv6 address.
-            for (const QHostAddress &addr : std::as_const(addresses)) {
-                // We only use global addresses.
-                if (addr.isGlobal()) {
-                    if (addr.protocol() == QAbstractSocket::IPv4Protocol) {
-                        ipAddress = addr;
-                        break;
-                    } else if (addr.protocol() == QAbstractSocket::IPv6Protocol) {
-                        // FIXME: Use the right address here.
-                        ipAddress = addr;
-                    }
-                }
-            }
-        }
-    }
+QList<SharePtr> Smb4KClientBaseJob::shares()
+{
+    return m_shares;
+}
 
-    return ipAddress;
+QList<FilePtr> Smb4KClientBaseJob::files()
+{
+    return m_files;
 }
 
 //
@@ -202,8 +818,41 @@ static void get_auth_data_with_context_fn(SMBCCTX *context,
 //
 // Client job
 //
+
+//
+// Create a copy of the network item that is independent of the original
+//
+static NetworkItemPtr copyNetworkItem(const NetworkItemPtr &item)
+{
+    switch (item->type()) {
+    case Workgroup: {
+        return WorkgroupPtr::create(*item.staticCast<Smb4KWorkgroup>());
+    }
+    case Host: {
+        return HostPtr::create(*item.staticCast<Smb4KHost>());
+    }
+    case Share: {
+        return SharePtr::create(*item.staticCast<Smb4KShare>());
+    }
+    case FileOrDirectory: {
+        return FilePtr::create(*item.staticCast<Smb4KFile>());
+    }
+    default: {
+        break;
+    }
+    }
+
+    return NetworkItemPtr::create(*item);
+}
+
 Smb4KClientJob::Smb4KClientJob(QObject *parent)
     : Smb4KClientBaseJob(parent)
+    , m_context(nullptr)
+    , m_backend(nullptr)
+    , m_copies(1)
+    , m_threadPool(nullptr)
+    , m_aborted(0)
+    , m_workerRunning(false)
 {
 }
 
@@ -237,6 +886,37 @@ int Smb4KClientJob::printCopies() const
     return m_copies;
 }
 
+void Smb4KClientJob::setThreadPool(QThreadPool *pool)
+{
+    m_threadPool = pool;
+}
+
+void Smb4KClientJob::abandon()
+{
+    if (m_workerRunning) {
+        m_aborted.storeRelaxed(1);
+        setAutoDelete(false);
+        setParent(nullptr);
+    }
+}
+
+bool Smb4KClientJob::doKill()
+{
+    //
+    // A lookup that is running on a worker thread cannot be interrupted
+    // inside libsmbclient. Tell it to stop reading the directory and keep
+    // the job alive until it returned. The job is reported as killed right
+    // away, so that the partial results are never processed.
+    //
+    m_aborted.storeRelaxed(1);
+
+    if (m_workerRunning) {
+        setAutoDelete(false);
+    }
+
+    return true;
+}
+
 void Smb4KClientJob::get_auth_data_fn(const char *server,
                                       const char * /*share*/,
                                       char *workgroup,
@@ -245,10 +925,35 @@ void Smb4KClientJob::get_auth_data_fn(const char *server,
                                       int maxLenUsername,
                                       char *password,
                                       int maxLenPassword)
+{
+    //
+    // This function might be called from a worker thread. The credentials
+    // have already been read in the main thread by readAuthData(), so only
+    // copy them here.
+    //
+    if (m_authUserName.isEmpty()) {
+        return;
+    }
+
+    //
+    // For workgroups, only pass the authentication data to the master browser
+    //
+    if (m_lookupItem->type() == Workgroup && QString::fromUtf8(server, -1).toUpper() == QString::fromUtf8(workgroup, -1).toUpper()) {
+        return;
+    }
+
+    qstrncpy(username, m_authUserName.toUtf8().data(), maxLenUsername);
+    qstrncpy(password, m_authPassword.toUtf8().data(), maxLenPassword);
+}
+
+void Smb4KClientJob::readAuthData()
 {
     //
     // Authentication
     //
+    // The credentials are read here in the main thread, because the keychain
+    // cannot be accessed safely from the worker threads.
+    //
     switch ((*pNetworkItem)->type()) {
     case Network: {
         //
@@ -261,27 +966,27 @@ void Smb4KClientJob::get_auth_data_fn(const char *server,
         // Only request authentication data, if the master browsers require
         // authentication data.
         //
-        if (Smb4KSettings::masterBrowsersRequireAuth()) {
-            if (QString::fromUtf8(server, -1).toUpper() != QString::fromUtf8(workgroup, -1).toUpper()) {
-                //
-                // This is the master browser. Create a host object for it.
-                //
-                HostPtr masterBrowser = HostPtr::create();
-                masterBrowser->setWorkgroupName(QString::fromUtf8(workgroup, -1));
-                masterBrowser->setHostName(QString::fromUtf8(server, -1));
+        WorkgroupPtr workgroup = (*pNetworkItem).staticCast<Smb4KWorkgroup>();
 
-                //
-                // Get the authentication data
-                //
-                Smb4KCredentialsManager::self()->readLoginCredentials(masterBrowser);
+        if (Smb4KSettings::masterBrowsersRequireAuth() && workgroup->hasMasterBrowser()) {
+            //
+            // Create a host object for the master browser.
+            //
+            HostPtr masterBrowser = HostPtr::create();
+            masterBrowser->setWorkgroupName(workgroup->workgroupName());
+            masterBrowser->setHostName(workgroup->masterBrowserName());
 
-                //
-                // Copy the authentication data
-                //
-                if (masterBrowser->hasUserInfo()) {
-                    qstrncpy(username, masterBrowser->userName().toUtf8().data(), maxLenUsername);
-                    qstrncpy(password, masterBrowser->password().toUtf8().data(), maxLenPassword);
-                }
+            //
+            // Get the authentication data
+            //
+            Smb4KCredentialsManager::self()->readLoginCredentials(masterBrowser);
+
+            //
+            // Copy the authentication data
+            //
+            if (masterBrowser->hasUserInfo()) {
+                m_authUserName = masterBrowser->userName();
+                m_authPassword = masterBrowser->password();
             }
         }
 
@@ -302,8 +1007,8 @@ void Smb4KClientJob::get_auth_data_fn(const char *server,
         // Copy the authentication data
         //
         if (host->hasUserInfo()) {
-            qstrncpy(username, host->userName().toUtf8().data(), maxLenUsername);
-            qstrncpy(password, host->password().toUtf8().data(), maxLenPassword);
+            m_authUserName = host->userName();
+            m_authPassword = host->password();
         }
 
         break;
@@ -323,8 +1028,8 @@ void Smb4KClientJob::get_auth_data_fn(const char *server,
         // Copy the authentication data
         //
         if (share->hasUserInfo()) {
-            qstrncpy(username, share->userName().toUtf8().data(), maxLenUsername);
-            qstrncpy(password, share->password().toUtf8().data(), maxLenPassword);
+            m_authUserName = share->userName();
+            m_authPassword = share->password();
         }
 
         break;
@@ -352,8 +1057,8 @@ void Smb4KClientJob::get_auth_data_fn(const char *server,
             // Copy the authentication data
             //
             if (share->hasUserInfo()) {
-                qstrncpy(username, share->userName().toUtf8().data(), maxLenUsername);
-                qstrncpy(password, share->password().toUtf8().data(), maxLenPassword);
+                m_authUserName = share->userName();
+                m_authPassword = share->password();
             }
         }
 
@@ -365,50 +1070,18 @@ void Smb4KClientJob::get_auth_data_fn(const char *server,
     }
 }
 
-void Smb4KClientJob::initClientLibrary()
+bool Smb4KClientJob::initClientLibrary()
 {
-    //
-    // Get new context
-    //
-    m_context = smbc_new_context();
-
-    if (!m_context) {
-        int errorCode = errno;
-
-        setError(ClientError);
-        setErrorText(QString::fromUtf8(strerror(errorCode), -1));
-
-        emitResult();
-        return;
-    }
-
-    //
-    // Init the context
-    //
-    m_context = smbc_init_context(m_context);
-
-    if (!m_context) {
-        int errorCode = errno;
-
-        setError(ClientError);
-        setErrorText(QString::fromUtf8(strerror(errorCode), -1));
-        emitResult();
-        return;
-    }
-
     //
     // Get the custom options
     //
     CustomSettingsPtr options = Smb4KCustomSettingsManager::self()->findCustomSettings(*pNetworkItem);
 
     //
-    // Set debug level
+    // Determine the NetBIOS name and the workgroup to make connections
     //
-    smbc_setDebug(m_context, SMBC_DEBUG);
+    QString netbiosName, workgroupName;
 
-    //
-    // Set the NetBIOS name and the workgroup to make connections
-    //
     switch ((*pNetworkItem)->type()) {
     case Network: {
         //
@@ -424,7 +1097,7 @@ void Smb4KClientJob::initClientLibrary()
         // Only set the NetBIOS name, if the workgroup entry has a master browser
         //
         if (workgroup->hasMasterBrowser()) {
-            smbc_setNetbiosName(m_context, workgroup->masterBrowserName().toUtf8().data());
+            netbiosName = workgroup->masterBrowserName();
         }
 
         //
@@ -433,7 +1106,7 @@ void Smb4KClientJob::initClientLibrary()
         // the workgroup if no DNS-SD discovery was used.
         //
         if (!workgroup->dnsDiscovered()) {
-            smbc_setWorkgroup(m_context, workgroup->workgroupName().toUtf8().data());
+            workgroupName = workgroup->workgroupName();
         }
 
         break;
@@ -448,13 +1121,13 @@ void Smb4KClientJob::initClientLibrary()
         WorkgroupPtr workgroup = findWorkgroup(host->workgroupName());
 
         if (workgroup && !workgroup->dnsDiscovered()) {
-            smbc_setWorkgroup(m_context, host->workgroupName().toUtf8().data());
+            workgroupName = host->workgroupName();
         }
 
         //
         // Set the NetBIOS name
         //
-        smbc_setNetbiosName(m_context, host->hostName().toUtf8().data());
+        netbiosName = host->hostName();
 
         break;
     }
@@ -468,13 +1141,13 @@ void Smb4KClientJob::initClientLibrary()
         WorkgroupPtr workgroup = findWorkgroup(share->workgroupName());
 
         if (workgroup && !workgroup->dnsDiscovered()) {
-            smbc_setWorkgroup(m_context, share->workgroupName().toUtf8().data());
+            workgroupName = share->workgroupName();
         }
 
         //
         // Set the NetBIOS name
         //
-        smbc_setNetbiosName(m_context, share->hostName().toUtf8().data());
+        netbiosName = share->hostName();
 
         break;
     }
@@ -490,13 +1163,13 @@ void Smb4KClientJob::initClientLibrary()
             WorkgroupPtr workgroup = findWorkgroup(file->workgroupName());
 
             if (workgroup && !workgroup->dnsDiscovered()) {
-                smbc_setWorkgroup(m_context, file->workgroupName().toUtf8().data());
+                workgroupName = file->workgroupName();
             }
 
             //
             // Set the NetBIOS name
             //
-            smbc_setNetbiosName(m_context, file->hostName().toUtf8().data());
+            netbiosName = file->hostName();
         }
 
         break;
@@ -507,34 +1180,21 @@ void Smb4KClientJob::initClientLibrary()
     }
 
     //
-    // Set the user for making the connection
+    // Determine the user for making the connection
     //
     // To be able to connect to a Windows 10 server and get the list
     // of shared resources, use the 'guest' user here, if the URL
     // does not provide a user name.
     //
-    if (!(*pNetworkItem)->url().userName().isEmpty()) {
-        smbc_setUser(m_context, (*pNetworkItem)->url().userName().toUtf8().data());
-    } else {
-        smbc_setUser(m_context, "guest");
-    }
-
-    //
-    // Set the user data (this class)
-    //
-    smbc_setOptionUserData(m_context, this);
+    QString userName = !(*pNetworkItem)->url().userName().isEmpty() ? (*pNetworkItem)->url().userName() : QStringLiteral("guest");
 
     //
-    // Set number of master browsers to be used
+    // Determine the number of master browsers to be used
     //
-    if (Smb4KSettings::largeNetworkNeighborhood()) {
-        smbc_setOptionBrowseMaxLmbCount(m_context, 3);
-    } else {
-        smbc_setOptionBrowseMaxLmbCount(m_context, 0 /* all master browsers */);
-    }
+    int maxLmbCount = Smb4KSettings::largeNetworkNeighborhood() ? 3 : 0 /* all master browsers */;
 
     //
-    // Set the protocol version if desired
+    // Determine the protocol version if desired
     //
     int minimal = -1;
     int maximal = -1;
@@ -590,27 +1250,23 @@ void Smb4KClientJob::initClientLibrary()
         }
     }
 
-    if (!minimalClientProtocolVersionString.isEmpty() && !maximalClientProtocolVersionString.isEmpty()) {
-        smbc_setOptionProtocols(m_context, minimalClientProtocolVersionString.toLatin1().data(), maximalClientProtocolVersionString.toLatin1().data());
-    } else {
-        smbc_setOptionProtocols(m_context, nullptr, nullptr);
-    }
-
     //
-    // Set the encryption level
+    // Determine the encryption level
     //
+    int encryptionLevel = -1;
+
     if (Smb4KSettings::useEncryptionLevel()) {
         switch (Smb4KSettings::encryptionLevel()) {
         case Smb4KSettings::EnumEncryptionLevel::None: {
-            smbc_setOptionSmbEncryptionLevel(m_context, SMBC_ENCRYPTLEVEL_NONE);
+            encryptionLevel = SMBC_ENCRYPTLEVEL_NONE;
             break;
         }
         case Smb4KSettings::EnumEncryptionLevel::Request: {
-            smbc_setOptionSmbEncryptionLevel(m_context, SMBC_ENCRYPTLEVEL_REQUEST);
+            encryptionLevel = SMBC_ENCRYPTLEVEL_REQUEST;
             break;
         }
         case Smb4KSettings::EnumEncryptionLevel::Require: {
-            smbc_setOptionSmbEncryptionLevel(m_context, SMBC_ENCRYPTLEVEL_REQUIRE);
+            encryptionLevel = SMBC_ENCRYPTLEVEL_REQUIRE;
             break;
         }
         default: {
@@ -619,6 +1275,123 @@ void Smb4KClientJob::initClientLibrary()
         }
     }
 
+    //
+    // Determine the usage of Kerberos
+    //
+    bool useKerberos = options ? options->useKerberos() : Smb4KSettings::useKerberos();
+
+    //
+    // Reuse an idle context that was set up the same way and has the same
+    // credentials. It still has its connections to the server, so browsing
+    // the same server again does not need a new session setup. Contexts
+    // used for printing are not reused.
+    //
+    m_contextKey.clear();
+
+    if (*pProcess != PrintFile) {
+        QStringList keyComponents;
+        keyComponents << (*pNetworkItem)->url().host().toCaseFolded();
+        keyComponents << workgroupName;
+        keyComponents << netbiosName;
+        keyComponents << userName;
+        keyComponents << m_authUserName;
+        keyComponents << QString::fromLatin1(QCryptographicHash::hash(m_authPassword.toUtf8(), QCryptographicHash::Sha256).toHex());
+        keyComponents << QString::number(maxLmbCount);
+        keyComponents << minimalClientProtocolVersionString;
+        keyComponents << maximalClientProtocolVersionString;
+        keyComponents << QString::number(encryptionLevel);
+        keyComponents << QString::number(Smb4KSettings::useWinbindCCache());
+        keyComponents << QString::number(useKerberos);
+
+        m_contextKey = keyComponents.join(QStringLiteral("|"));
+        m_context = Smb4KClientContextPool::self()->acquire(m_contextKey);
+
+        if (m_context) {
+            smbc_setOptionUserData(m_context, this);
+            return true;
+        }
+    }
+
+    //
+    // Get new context
+    //
+    m_context = smbc_new_context();
+
+    if (!m_context) {
+        int errorCode = errno;
+
+        setError(ClientError);
+        setErrorText(QString::fromUtf8(strerror(errorCode), -1));
+
+        return false;
+    }
+
+    //
+    // Init the context
+    //
+    SMBCCTX *context = smbc_init_context(m_context);
+
+    if (!context) {
+        int errorCode = errno;
+
+        smbc_free_context(m_context, 1);
+        m_context = nullptr;
+
+        setError(ClientError);
+        setErrorText(QString::fromUtf8(strerror(errorCode), -1));
+
+        return false;
+    }
+
+    m_context = context;
+
+    //
+    // Set debug level
+    //
+    smbc_setDebug(m_context, SMBC_DEBUG);
+
+    //
+    // Set the NetBIOS name and the workgroup to make connections
+    //
+    if (!netbiosName.isEmpty()) {
+        smbc_setNetbiosName(m_context, netbiosName.toUtf8().data());
+    }
+
+    if (!workgroupName.isEmpty()) {
+        smbc_setWorkgroup(m_context, workgroupName.toUtf8().data());
+    }
+
+    //
+    // Set the user for making the connection
+    //
+    smbc_setUser(m_context, userName.toUtf8().data());
+
+    //
+    // Set the user data (this class)
+    //
+    smbc_setOptionUserData(m_context, this);
+
+    //
+    // Set number of master browsers to be used
+    //
+    smbc_setOptionBrowseMaxLmbCount(m_context, maxLmbCount);
+
+    //
+    // Set the protocol version if desired
+    //
+    if (!minimalClientProtocolVersionString.isEmpty() && !maximalClientProtocolVersionString.isEmpty()) {
+        smbc_setOptionProtocols(m_context, minimalClientProtocolVersionString.toLatin1().data(), maximalClientProtocolVersionString.toLatin1().data());
+    } else {
+        smbc_setOptionProtocols(m_context, nullptr, nullptr);
+    }
+
+    //
+    // Set the encryption level
+    //
+    if (encryptionLevel != -1) {
+        smbc_setOptionSmbEncryptionLevel(m_context, static_cast<smbc_smb_encrypt_level>(encryptionLevel));
+    }
+
     //
     // Set the usage of anonymous login
     //
@@ -632,12 +1405,7 @@ void Smb4KClientJob::initClientLibrary()
     //
     // Set usage of Kerberos
     //
-    if (options) {
-        smbc_setOptionUseKerberos(m_context, options->useKerberos());
-    } else {
-        smbc_setOptionUseKerberos(m_context, Smb4KSettings::useKerberos());
-    }
-
+    smbc_setOptionUseKerberos(m_context, useKerberos);
     smbc_setOptionFallbackAfterKerberos(m_context, 1);
 
     //
@@ -649,27 +1417,12 @@ void Smb4KClientJob::initClientLibrary()
     // Set auth callback function
     //
     smbc_setFunctionAuthDataWithContext(m_context, get_auth_data_with_context_fn);
+
+    return true;
 }
 
 void Smb4KClientJob::doLookups()
 {
-    //
-    // Set the new context
-    //
-    (void)smbc_set_context(m_context);
-
-    //
-    // Get the function to open the directory.
-    //
-    smbc_opendir_fn openDirectory = smbc_getFunctionOpendir(m_context);
-
-    if (!openDirectory) {
-        int errorCode = errno;
-        setError(ClientError);
-        setErrorText(QString::fromUtf8(strerror(errorCode), -1));
-        return;
-    }
-
     //
     // Open the directory
     //
@@ -678,12 +1431,10 @@ void Smb4KClientJob::doLookups()
     // to stop here in that case, do not throw an error when using DNS-SD and
     // Network and Workgroup (parent) items.
     //
-    SMBCFILE *directory = openDirectory(m_context, (*pNetworkItem)->url().toString().toUtf8().data());
-
-    if (!directory) {
-        if (!(*pNetworkItem)->dnsDiscovered() && !((*pNetworkItem)->type() == Network || (*pNetworkItem)->type() == Workgroup)) {
-            int errorCode = errno;
+    int errorCode = m_backend->openDirectory(m_lookupItem->url(), *pProcess == LookupFiles);
 
+    if (errorCode != 0) {
+        if (!m_lookupItem->dnsDiscovered() && !(m_lookupItem->type() == Network || m_lookupItem->type() == Workgroup)) {
             switch (errorCode) {
             case EACCES:
             case EPERM: {
@@ -692,7 +1443,7 @@ void Smb4KClientJob::doLookups()
                 break;
             }
             case ENOENT: {
-                if ((*pNetworkItem)->type() != Network) {
+                if (m_lookupItem->type() != Network) {
                     setError(ClientError);
                     setErrorText(QString::fromUtf8(strerror(errorCode), -1));
                 }
@@ -706,25 +1457,86 @@ void Smb4KClientJob::doLookups()
             }
         }
 
-        return;
-    }
+        return;
+    }
+
+    //
+    // Files and directories are reported in chunks while the directory is
+    // read, so that they can be shown right away.
+    //
+    QList<FilePtr> fileChunk;
+    QElapsedTimer chunkTimer;
+    chunkTimer.start();
+
+    auto reportFiles = [&]() {
+        if (!fileChunk.isEmpty()) {
+            Q_EMIT filesAvailable(fileChunk);
+            fileChunk.clear();
+        }
+
+        chunkTimer.restart();
+    };
+
+    //
+    // Create a file or directory object for an entry of the listing of a
+    // share or directory. Returns a null pointer if the server went offline.
+    //
+    auto createFile = [&](const QString &name, bool isDirectory) {
+        //
+        // Create the URL for the discovered item
+        //
+        QUrl u = m_lookupItem->url();
+        u.setPath(m_lookupItem->url().path() + QDir::separator() + name);
+
+        //
+        // Create the file or directory object
+        //
+        FilePtr file = FilePtr::create(u);
+
+        if (isDirectory) {
+            file->setDirectory(true);
+        }
+
+        //
+        // Set the workgroup name
+        //
+        file->setWorkgroupName(m_lookupItem.staticCast<Smb4KShare>()->workgroupName());
+
+        //
+        // Set the authentication data
+        //
+        file->setUserName(m_lookupItem->url().userName());
+        file->setPassword(m_lookupItem->url().password());
+
+        //
+        // Process the IP address.
+        // If the address is null, the server most likely went offline. So, skip it
+        // and delete the pointer.
+        //
+        if (!m_hostAddress.isNull()) {
+            file->setHostIpAddress(m_hostAddress);
+        } else {
+            file.clear();
+        }
+
+        return file;
+    };
 
     //
     // Read the directory
     //
-    struct smbc_dirent *directoryEntry = nullptr;
-    smbc_readdir_fn readDirectory = smbc_getFunctionReaddir(m_context);
+    Smb4KClientBackend::Entry entry;
 
-    if (!readDirectory) {
-        int errorCode = errno;
-        setError(ClientError);
-        setErrorText(QString::fromUtf8(strerror(errorCode), -1));
-        return;
-    }
+    while (m_backend->readDirectory(&entry)) {
+        //
+        // Stop reading the directory if the job was killed
+        //
+        if (m_aborted.loadRelaxed()) {
+            break;
+        }
 
-    while ((directoryEntry = readDirectory(m_context, directory)) != nullptr) {
-        switch (directoryEntry->smbc_type) {
-        case SMBC_WORKGROUP: {
+        switch (entry.type) {
+        case Smb4KClientBackend::WorkgroupEntry: {
             //
             // Create a workgroup pointer
             //
@@ -733,35 +1545,23 @@ void Smb4KClientJob::doLookups()
             //
             // Set the workgroup name
             //
-            QString workgroupName = QString::fromUtf8(directoryEntry->name, -1);
+            QString workgroupName = entry.name;
             workgroup->setWorkgroupName(workgroupName);
 
             //
             // Set the master browser
             //
-            QString masterBrowserName = QString::fromUtf8(directoryEntry->comment, -1);
+            QString masterBrowserName = entry.comment;
             workgroup->setMasterBrowserName(masterBrowserName);
 
             //
-            // Lookup IP address
-            //
-            QHostAddress address = lookupIpAddress(masterBrowserName);
-
-            //
-            // Process the IP address.
-            // If the address is null, the server most likely went offline. So, skip the
-            // workgroup and delete the pointer.
+            // The IP address is looked up after the directory was read
             //
-            if (!address.isNull()) {
-                workgroup->setMasterBrowserIpAddress(address);
-                *pWorkgroups << workgroup;
-            } else {
-                workgroup.clear();
-            }
+            m_discoveredWorkgroups << workgroup;
 
             break;
         }
-        case SMBC_SERVER: {
+        case Smb4KClientBackend::ServerEntry: {
             //
             // Create a host pointer
             //
@@ -770,40 +1570,28 @@ void Smb4KClientJob::doLookups()
             //
             // Set the workgroup name
             //
-            host->setWorkgroupName((*pNetworkItem)->url().host());
+            host->setWorkgroupName(m_lookupItem->url().host());
 
             //
             // Set the host name
             //
-            QString hostName = QString::fromUtf8(directoryEntry->name, -1);
+            QString hostName = entry.name;
             host->setHostName(hostName);
 
             //
             // Set the comment
             //
-            QString comment = QString::fromUtf8(directoryEntry->comment, -1);
+            QString comment = entry.comment;
             host->setComment(comment);
 
             //
-            // Lookup IP address
-            //
-            QHostAddress address = lookupIpAddress(hostName);
-
-            //
-            // Process the IP address.
-            // If the address is null, the server most likely went offline. So, skip it
-            // and delete the pointer.
+            // The IP address is looked up after the directory was read
             //
-            if (!address.isNull()) {
-                host->setIpAddress(address);
-                *pHosts << host;
-            } else {
-                host.clear();
-            }
+            m_discoveredHosts << host;
 
             break;
         }
-        case SMBC_FILE_SHARE: {
+        case Smb4KClientBackend::FileShareEntry: {
             //
             // Create a share pointer
             //
@@ -812,22 +1600,22 @@ void Smb4KClientJob::doLookups()
             //
             // Set the workgroup name
             //
-            share->setWorkgroupName((*pNetworkItem).staticCast<Smb4KHost>()->workgroupName());
+            share->setWorkgroupName(m_lookupItem.staticCast<Smb4KHost>()->workgroupName());
 
             //
             // Set the host name
             //
-            share->setHostName((*pNetworkItem)->url().host());
+            share->setHostName(m_lookupItem->url().host());
 
             //
             // Set the share name
             //
-            share->setShareName(QString::fromUtf8(directoryEntry->name, -1));
+            share->setShareName(entry.name);
 
             //
             // Set the comment
             //
-            share->setComment(QString::fromUtf8(directoryEntry->comment, -1));
+            share->setComment(entry.comment);
 
             //
             // Set share type
@@ -837,21 +1625,16 @@ void Smb4KClientJob::doLookups()
             //
             // Set the authentication data
             //
-            share->setUserName((*pNetworkItem)->url().userName());
-            share->setPassword((*pNetworkItem)->url().password());
-
-            //
-            // Lookup IP address
-            //
-            QHostAddress address = lookupIpAddress((*pNetworkItem)->url().host());
+            share->setUserName(m_lookupItem->url().userName());
+            share->setPassword(m_lookupItem->url().password());
 
             //
             // Process the IP address.
             // If the address is null, the server most likely went offline. So, skip it
             // and delete the pointer.
             //
-            if (!address.isNull()) {
-                share->setHostIpAddress(address);
+            if (!m_hostAddress.isNull()) {
+                share->setHostIpAddress(m_hostAddress);
                 *pShares << share;
             } else {
                 share.clear();
@@ -859,7 +1642,7 @@ void Smb4KClientJob::doLookups()
 
             break;
         }
-        case SMBC_PRINTER_SHARE: {
+        case Smb4KClientBackend::PrinterShareEntry: {
             //
             // Create a share pointer
             //
@@ -868,22 +1651,22 @@ void Smb4KClientJob::doLookups()
             //
             // Set the workgroup name
             //
-            share->setWorkgroupName((*pNetworkItem).staticCast<Smb4KHost>()->workgroupName());
+            share->setWorkgroupName(m_lookupItem.staticCast<Smb4KHost>()->workgroupName());
 
             //
             // Set the host name
             //
-            share->setHostName((*pNetworkItem)->url().host());
+            share->setHostName(m_lookupItem->url().host());
 
             //
             // Set the share name
             //
-            share->setShareName(QString::fromUtf8(directoryEntry->name, -1));
+            share->setShareName(entry.name);
 
             //
             // Set the comment
             //
-            share->setComment(QString::fromUtf8(directoryEntry->comment, -1));
+            share->setComment(entry.comment);
 
             //
             // Set share type
@@ -893,21 +1676,16 @@ void Smb4KClientJob::doLookups()
             //
             // Set the authentication data
             //
-            share->setUserName((*pNetworkItem)->url().userName());
-            share->setPassword((*pNetworkItem)->url().password());
-
-            //
-            // Lookup IP address
-            //
-            QHostAddress address = lookupIpAddress((*pNetworkItem)->url().host());
+            share->setUserName(m_lookupItem->url().userName());
+            share->setPassword(m_lookupItem->url().password());
 
             //
             // Process the IP address.
             // If the address is null, the server most likely went offline. So, skip it
             // and delete the pointer.
             //
-            if (!address.isNull()) {
-                share->setHostIpAddress(address);
+            if (!m_hostAddress.isNull()) {
+                share->setHostIpAddress(m_hostAddress);
                 *pShares << share;
             } else {
                 share.clear();
@@ -915,7 +1693,7 @@ void Smb4KClientJob::doLookups()
 
             break;
         }
-        case SMBC_IPC_SHARE: {
+        case Smb4KClientBackend::IpcShareEntry: {
             //
             // Create a share pointer
             //
@@ -924,22 +1702,22 @@ void Smb4KClientJob::doLookups()
             //
             // Set the workgroup name
             //
-            share->setWorkgroupName((*pNetworkItem).staticCast<Smb4KHost>()->workgroupName());
+            share->setWorkgroupName(m_lookupItem.staticCast<Smb4KHost>()->workgroupName());
 
             //
             // Set the host name
             //
-            share->setHostName((*pNetworkItem)->url().host());
+            share->setHostName(m_lookupItem->url().host());
 
             //
             // Set the share name
             //
-            share->setShareName(QString::fromUtf8(directoryEntry->name, -1));
+            share->setShareName(entry.name);
 
             //
             // Set the comment
             //
-            share->setComment(QString::fromUtf8(directoryEntry->comment, -1));
+            share->setComment(entry.comment);
 
             //
             // Set share type
@@ -949,21 +1727,16 @@ void Smb4KClientJob::doLookups()
             //
             // Set the authentication data
             //
-            share->setUserName((*pNetworkItem)->url().userName());
-            share->setPassword((*pNetworkItem)->url().password());
-
-            //
-            // Lookup IP address
-            //
-            QHostAddress address = lookupIpAddress((*pNetworkItem)->url().host());
+            share->setUserName(m_lookupItem->url().userName());
+            share->setPassword(m_lookupItem->url().password());
 
             //
             // Process the IP address.
             // If the address is null, the server most likely went offline. So, skip it
             // and delete the pointer.
             //
-            if (!address.isNull()) {
-                share->setHostIpAddress(address);
+            if (!m_hostAddress.isNull()) {
+                share->setHostIpAddress(m_hostAddress);
                 *pShares << share;
             } else {
                 share.clear();
@@ -971,130 +1744,113 @@ void Smb4KClientJob::doLookups()
 
             break;
         }
-        case SMBC_DIR: {
+        case Smb4KClientBackend::FileEntry:
+        case Smb4KClientBackend::DirectoryEntry: {
             //
             // Do not process '.' and '..' directories
             //
-            QString name = QString::fromUtf8(directoryEntry->name, -1);
-
-            if (name != QStringLiteral(".") && name != QStringLiteral("..")) {
-                //
-                // Create the URL for the discovered item
-                //
-                QUrl u = (*pNetworkItem)->url();
-                u.setPath((*pNetworkItem)->url().path() + QDir::separator() + QString::fromUtf8(directoryEntry->name, -1));
-
-                //
-                // We do not stat directories. Directly create the directory object
-                //
-                FilePtr dir = FilePtr::create(u);
-                dir->setDirectory(true);
-
-                //
-                // Set the workgroup name
-                //
-                dir->setWorkgroupName((*pNetworkItem).staticCast<Smb4KShare>()->workgroupName());
-
-                //
-                // Set the authentication data
-                //
-                dir->setUserName((*pNetworkItem)->url().userName());
-                dir->setPassword((*pNetworkItem)->url().password());
-
-                //
-                // Lookup IP address
-                //
-                QHostAddress address = lookupIpAddress((*pNetworkItem)->url().host());
-
-                //
-                // Process the IP address.
-                // If the address is null, the server most likely went offline. So, skip it
-                // and delete the pointer.
-                //
-                if (!address.isNull()) {
-                    dir->setHostIpAddress(address);
-                    *pFiles << dir;
-                } else {
-                    dir.clear();
-                }
+            if (entry.name == QStringLiteral(".") || entry.name == QStringLiteral("..")) {
+                break;
             }
 
-            break;
-        }
-        case SMBC_FILE: {
-            //
-            // Create the URL for the discovered item
-            //
-            QUrl u = (*pNetworkItem)->url();
-            u.setPath((*pNetworkItem)->url().path() + QDir::separator() + QString::fromUtf8(directoryEntry->name, -1));
-
-            //
-            // Create the file object
-            //
-            FilePtr file = FilePtr::create(u);
-
-            //
-            // Set the workgroup name
-            //
-            file->setWorkgroupName((*pNetworkItem).staticCast<Smb4KShare>()->workgroupName());
+            FilePtr file = createFile(entry.name, entry.type == Smb4KClientBackend::DirectoryEntry);
 
-            //
-            // Stat the file
-            //
-            // FIXME
+            if (file) {
+                if (!file->isDirectory()) {
+                    file->setSize(entry.size);
+                }
 
-            //
-            // Set the authentication data
-            //
-            file->setUserName((*pNetworkItem)->url().userName());
-            file->setPassword((*pNetworkItem)->url().password());
+                file->setHidden(entry.hidden);
+                file->setReadOnly(entry.readOnly);
+                file->setLastModified(entry.lastModified);
+                file->setCreated(entry.created);
 
-            //
-            // Lookup IP address
-            //
-            QHostAddress address = lookupIpAddress((*pNetworkItem)->url().host());
+                fileChunk << file;
+            }
 
-            //
-            // Process the IP address.
-            // If the address is null, the server most likely went offline. So, skip it
-            // and delete the pointer.
-            //
-            if (!address.isNull()) {
-                file->setHostIpAddress(address);
-                *pFiles << file;
-            } else {
-                file.clear();
+            if (fileChunk.size() >= FILE_CHUNK_SIZE || (!fileChunk.isEmpty() && chunkTimer.hasExpired(FILE_CHUNK_INTERVAL))) {
+                reportFiles();
             }
 
             break;
         }
-        case SMBC_LINK: {
+        case Smb4KClientBackend::LinkEntry: {
             qDebug() << "Processing links is not implemented.";
-            qDebug() << directoryEntry->name;
-            qDebug() << directoryEntry->comment;
+            qDebug() << entry.name;
+            qDebug() << entry.comment;
             break;
         }
         default: {
-            qDebug() << "Need to process network item " << directoryEntry->name;
+            qDebug() << "Need to process network item " << entry.name;
             break;
         }
         }
     }
 
+    reportFiles();
+
     //
     // Close the directory
     //
-    smbc_closedir_fn closeDirectory = smbc_getFunctionClosedir(m_context);
-
-    if (!closeDirectory) {
-        int errorCode = errno;
+    m_backend->closeDirectory();
+}
 
-        setError(ClientError);
-        setErrorText(QString::fromUtf8(strerror(errorCode), -1));
+void Smb4KClientJob::finishLookups()
+{
+    if (m_discoveredWorkgroups.isEmpty() && m_discoveredHosts.isEmpty()) {
+        emitResult();
         return;
     }
 
-    (void)closeDirectory(m_context, directory);
+    //
+    // Look up the IP addresses of the discovered master browsers and hosts
+    // in parallel.
+    //
+    QStringList names;
+
+    for (const WorkgroupPtr &workgroup : std::as_const(m_discoveredWorkgroups)) {
+        names << workgroup->masterBrowserName();
+    }
+
+    for (const HostPtr &host : std::as_const(m_discoveredHosts)) {
+        names << host->hostName();
+    }
+
+    m_backend->lookupIpAddresses(names, this, [this](const QHash<QString, QHostAddress> &addresses) {
+        //
+        // A killed job already reported its result
+        //
+        if (m_aborted.loadRelaxed()) {
+            return;
+        }
+
+        //
+        // If the address is null, the server most likely went offline. So, skip
+        // the workgroup or host.
+        //
+        for (const WorkgroupPtr &workgroup : std::as_const(m_discoveredWorkgroups)) {
+            QHostAddress address = addresses.value(workgroup->masterBrowserName().toUpper());
+
+            if (!address.isNull()) {
+                workgroup->setMasterBrowserIpAddress(address);
+                *pWorkgroups << workgroup;
+            }
+        }
+
+        for (const HostPtr &host : std::as_const(m_discoveredHosts)) {
+            QHostAddress address = addresses.value(host->hostName().toUpper());
+
+            if (!address.isNull()) {
+                host->setIpAddress(address);
+                *pHosts << host;
+            }
+        }
+
+        m_discoveredWorkgroups.clear();
+        m_discoveredHosts.clear();
+
+        emitResult();
+    });
 }
 
 void Smb4KClientJob::doPrinting()
@@ -1253,23 +2009,73 @@ void Smb4KClientJob::doPrinting()
 void Smb4KClientJob::slotStartJob()
 {
     //
-    // Initialize the client library
+    // Do not start the job if it was killed in the meantime. It already
+    // reported its result.
+    //
+    if (m_aborted.loadRelaxed()) {
+        return;
+    }
+
+    //
+    // The lookups work on a copy of the network item, because the
+    // original might be changed in the main thread in the meantime.
+    //
+    m_lookupItem = copyNetworkItem(*pNetworkItem);
+
+    //
+    // Use the synthetic network instead of the client library, if it
+    // was requested. Printing always needs the client library.
     //
-    initClientLibrary();
+    if (Smb4KSyntheticBackend::isEnabled() && *pProcess != PrintFile) {
+        m_backend = new Smb4KSyntheticBackend();
+    } else {
+        //
+        // Read the credentials. They are needed to find a suitable context
+        // for reuse and later for the lookups or the printing.
+        //
+        readAuthData();
+
+        //
+        // Initialize the client library
+        //
+        if (!initClientLibrary()) {
+            emitResult();
+            return;
+        }
+
+        m_backend = new Smb4KLibsmbclientBackend(m_context);
+    }
 
     //
     // Process the given URL according to the passed process
     //
     switch (*pProcess) {
     case LookupDomains:
-    case LookupDomainMembers:
+    case LookupDomainMembers: {
+        startLookups();
+        return;
+    }
     case LookupShares:
     case LookupFiles: {
         //
-        // Do lookups using the client library
+        // All shares, files and directories reside on the same host. So, look
+        // up its IP address only once before the directory is read.
         //
-        doLookups();
-        break;
+        QString hostName = m_lookupItem->url().host();
+
+        m_backend->lookupIpAddresses({hostName}, this, [this, hostName](const QHash<QString, QHostAddress> &addresses) {
+            //
+            // A killed job already reported its result
+            //
+            if (m_aborted.loadRelaxed()) {
+                return;
+            }
+
+            m_hostAddress = addresses.value(hostName.toUpper());
+            startLookups();
+        });
+
+        return;
     }
     case PrintFile: {
         //
@@ -1289,13 +2095,77 @@ void Smb4KClientJob::slotStartJob()
     emitResult();
 }
 
+void Smb4KClientJob::startLookups()
+{
+    //
+    // Do lookups using the client library. If a thread pool is available,
+    // run the lookups there, so that the main thread is not blocked while
+    // waiting for the server. The result is emitted in the main thread.
+    //
+    if (m_threadPool) {
+        m_workerRunning = true;
+
+        m_threadPool->start([this]() {
+            doLookups();
+            QMetaObject::invokeMethod(
+                this,
+                [this]() {
+                    m_workerRunning = false;
+
+                    //
+                    // A killed job already reported its result
+                    //
+                    if (m_aborted.loadRelaxed()) {
+                        slotFinishJob();
+                        deleteLater();
+                    } else {
+                        finishLookups();
+                    }
+                },
+                Qt::QueuedConnection);
+        });
+
+        return;
+    }
+
+    doLookups();
+    finishLookups();
+}
+
 void Smb4KClientJob::slotFinishJob()
 {
+    //
+    // The worker thread still uses the backend and the context
+    //
+    if (m_workerRunning) {
+        return;
+    }
+
+    //
+    // The backend does not own the context, so delete it first
+    //
+    delete m_backend;
+    m_backend = nullptr;
+
     if (m_context != nullptr) {
-        smbc_free_context(m_context, 1);
+        // Keep the context and its connections for the next lookup, if
+        // the lookup succeeded.
+        if (!m_contextKey.isEmpty() && error() == 0 && !m_aborted.loadRelaxed()) {
+            Smb4KClientContextPool::self()->release(m_contextKey, m_context);
+        } else {
+            smbc_free_context(m_context, 1);
+        }
+
+        m_context = nullptr;
     }
 }
 
+//
+// Maximum time in msec to wait for the resolution of the services
+// after browsing finished
+//
+#define SERVICE_RESOLVE_TIMEOUT 5000
+
 Smb4KDnsDiscoveryJob::Smb4KDnsDiscoveryJob(QObject *parent)
     : Smb4KClientBaseJob(parent)
 {
@@ -1303,16 +2173,34 @@ Smb4KDnsDiscoveryJob::Smb4KDnsDiscoveryJob(QObject *parent)
     // Set up the DNS-SD browser
     //
     m_serviceBrowser = new KDNSSD::ServiceBrowser(QStringLiteral("_smb._tcp"));
+    m_runningLookups = 0;
+    m_browsingFinished = false;
+
+    //
+    // Do not wait forever for services that do not answer
+    //
+    m_timer = new QTimer(this);
+    m_timer->setSingleShot(true);
+    m_timer->setInterval(SERVICE_RESOLVE_TIMEOUT);
 
     //
     // Connections
     //
     connect(m_serviceBrowser, &KDNSSD::ServiceBrowser::serviceAdded, this, &Smb4KDnsDiscoveryJob::slotServiceAdded);
     connect(m_serviceBrowser, &KDNSSD::ServiceBrowser::finished, this, &Smb4KDnsDiscoveryJob::slotFinished);
+    connect(m_timer, &QTimer::timeout, this, [this]() {
+        if (!isFinished()) {
+            emitResult();
+        }
+    });
 }
 
 Smb4KDnsDiscoveryJob::~Smb4KDnsDiscoveryJob()
 {
+    for (const KDNSSD::RemoteService::Ptr &service : std::as_const(m_resolvingServices)) {
+        service->disconnect(this);
+    }
+
     delete m_serviceBrowser;
 }
 
@@ -1388,82 +2276,184 @@ void Smb4KDnsDiscoveryJob::slotServiceAdded(KDNSSD::RemoteService::Ptr service)
     }
     case LookupDomainMembers: {
         //
-        // Check if the server is already known
+        // Check if the server is already known
+        //
+        bool foundServer = false;
+
+        for (const HostPtr &h : std::as_const(*pHosts)) {
+            //
+            // On a local network there will most likely be no two servers with
+            // identical name, thus, to avoid duplicates, only test the hostname
+            // here.
+            //
+            if (QString::compare(h->hostName(), service->serviceName(), Qt::CaseInsensitive) == 0) {
+                foundServer = true;
+                break;
+            }
+        }
+
+        for (const KDNSSD::RemoteService::Ptr &s : std::as_const(m_resolvingServices)) {
+            if (QString::compare(s->serviceName(), service->serviceName(), Qt::CaseInsensitive) == 0) {
+                foundServer = true;
+                break;
+            }
+        }
+
+        //
+        // If the server is not known yet, resolve the service. All services
+        // are resolved in parallel.
+        //
+        if (!foundServer) {
+            m_resolvingServices << service;
+
+            KDNSSD::RemoteService *remoteService = service.data();
+
+            connect(remoteService, &KDNSSD::RemoteService::resolved, this, [this, remoteService](bool successful) {
+                processResolvedService(remoteService, successful);
+            });
+
+            remoteService->resolveAsync();
+        }
+
+        break;
+    }
+    default: {
+        break;
+    }
+    }
+}
+
+void Smb4KDnsDiscoveryJob::slotFinished()
+{
+    m_browsingFinished = true;
+    m_timer->start();
+
+    finishIfDone();
+}
+
+void Smb4KDnsDiscoveryJob::processResolvedService(KDNSSD::RemoteService *service, bool successful)
+{
+    //
+    // Keep the service alive until this function returns
+    //
+    KDNSSD::RemoteService::Ptr servicePtr(service);
+    m_resolvingServices.removeOne(servicePtr);
+    service->disconnect(this);
+
+    //
+    // Create the host item
+    //
+    HostPtr host = HostPtr::create();
+
+    //
+    // Set the _DNS-SD_ host name
+    //
+    host->setHostName(service->serviceName());
+
+    //
+    // Set the _DNS-SD_ domain name
+    //
+    host->setWorkgroupName(service->domain());
+
+    //
+    // Tell the program that the host was discovered by DNS-SD
+    //
+    host->setDnsDiscovered(true);
+
+    if (successful && !service->hostName().isEmpty()) {
+        //
+        // Use the port the service announced if it differs from the default one
         //
-        bool foundServer = false;
-
-        for (const HostPtr &h : std::as_const(*pHosts)) {
-            //
-            // On a local network there will most likely be no two servers with
-            // identical name, thus, to avoid duplicates, only test the hostname
-            // here.
-            //
-            if (QString::compare(h->hostName(), service->serviceName(), Qt::CaseInsensitive) == 0) {
-                foundServer = true;
-                break;
-            }
+        if (service->port() > 0 && service->port() != 445) {
+            QUrl url = host->url();
+            url.setPort(service->port());
+            host->setUrl(url);
         }
 
         //
-        // If the server is not known yet, add it to the list
+        // Look up the IP address of the target host of the service. It was
+        // already resolved by the DNS-SD daemon, so the answer is available
+        // immediately.
         //
-        if (!foundServer) {
-            //
-            // Create the host item
-            //
-            HostPtr host = HostPtr::create();
+        QString serviceName = service->serviceName();
+        m_runningLookups++;
 
-            //
-            // Set the _DNS-SD_ host name
-            //
-            host->setHostName(service->serviceName());
+        QHostInfo::lookupHost(service->hostName(), this, [this, host, serviceName](const QHostInfo &hostInfo) {
+            m_runningLookups--;
 
-            //
-            // Set the _DNS-SD_ domain name
-            //
-            host->setWorkgroupName(service->domain());
+            if (hostInfo.error() == QHostInfo::NoError) {
+                QHostAddress address = preferredAddress(hostInfo.addresses());
 
-            //
-            // Tell the program that the host was discovered by DNS-SD
-            //
-            host->setDnsDiscovered(true);
+                //
+                // Process the IP address.
+                //
+                if (!address.isNull()) {
+                    host->setIpAddress(address);
+                    Smb4KHostResolver::self()->insert(serviceName, address);
+                }
+            }
 
-            //
-            // Lookup IP address
-            //
-            QHostAddress address = lookupIpAddress(service->serviceName());
+            finishIfDone();
+        });
+    }
 
-            //
-            // Process the IP address.
-            //
-            if (!address.isNull()) {
-                host->setIpAddress(address);
-            }
+    //
+    // Add the host
+    //
+    *pHosts << host;
 
-            //
-            // Add the host
-            //
-            *pHosts << host;
-        }
+    finishIfDone();
+}
 
-        break;
-    }
-    default: {
-        break;
+void Smb4KDnsDiscoveryJob::finishIfDone()
+{
+    if (m_browsingFinished && m_resolvingServices.isEmpty() && m_runningLookups == 0 && !isFinished()) {
+        m_timer->stop();
+        emitResult();
     }
+}
+
+#ifdef USE_WS_DISCOVERY
+//
+// Maximum number of metadata requests that are sent at the same time
+//
+#define MAX_METADATA_REQUESTS 8
+
+//
+// Timeout of a metadata request in msec
+//
+#define METADATA_REQUEST_TIMEOUT 5000
+
+Q_APPLICATION_STATIC(Smb4KWsDiscoveryCache, wsDiscoveryCache);
+
+Smb4KWsDiscoveryCache *Smb4KWsDiscoveryCache::self()
+{
+    return wsDiscoveryCache;
+}
+
+bool Smb4KWsDiscoveryCache::find(const QString &endpointReference, uint metadataVersion, QStringList *computers) const
+{
+    auto it = m_cache.constFind(endpointReference);
+
+    if (it != m_cache.constEnd() && it->metadataVersion == metadataVersion) {
+        *computers = it->computers;
+        return true;
     }
+
+    return false;
 }
 
-void Smb4KDnsDiscoveryJob::slotFinished()
+void Smb4KWsDiscoveryCache::insert(const QString &endpointReference, uint metadataVersion, const QStringList &computers)
 {
-    emitResult();
+    m_cache.insert(endpointReference, {metadataVersion, computers});
 }
 
-#ifdef USE_WS_DISCOVERY
 Smb4KWsDiscoveryJob::Smb4KWsDiscoveryJob(QObject *parent)
     : Smb4KClientBaseJob(parent)
 {
     m_discoveryClient = new WSDiscoveryClient(this);
+    m_runningLookups = 0;
+    m_discoveryFinished = false;
 
     m_timer = new QTimer(this);
     m_timer->setSingleShot(true);
@@ -1476,6 +2466,18 @@ Smb4KWsDiscoveryJob::Smb4KWsDiscoveryJob(QObject *parent)
 
 Smb4KWsDiscoveryJob::~Smb4KWsDiscoveryJob()
 {
+    //
+    // Delete the watchers before the client interfaces, because the
+    // network replies of the pending calls are owned by the latter.
+    // The client interfaces are deleted later, since the job might be
+    // destroyed while one of their replies is emitting a signal.
+    //
+    QList<MetadataRequest> runningRequests = m_runningRequests.values();
+    qDeleteAll(m_runningRequests.keys());
+
+    for (const MetadataRequest &request : std::as_const(runningRequests)) {
+        request.clientInterface->deleteLater();
+    }
 }
 
 void Smb4KWsDiscoveryJob::start()
@@ -1509,6 +2511,10 @@ void Smb4KWsDiscoveryJob::slotStartJob()
 
 void Smb4KWsDiscoveryJob::slotProbeMatchReceived(const WSDiscoveryTargetService &service)
 {
+    if (m_discoveryFinished) {
+        return;
+    }
+
     //
     // Stop the timer
     //
@@ -1516,390 +2522,328 @@ void Smb4KWsDiscoveryJob::slotProbeMatchReceived(const WSDiscoveryTargetService
 
     //
     // If there is no address, we need to resolve it. Otherwise,
-    // resolve the available addresses and add the discovered network
-    // items to the respective lists.
+    // request the metadata of the device.
     //
     if (service.xAddrList().isEmpty()) {
         m_discoveryClient->sendResolve(service.endpointReference());
     } else {
-        if (!service.xAddrList().isEmpty()) {
-            for (const QUrl &address : service.xAddrList()) {
-                KDSoapClientInterface clientInterface(address.toString(), QStringLiteral("http://schemas.xmlsoap.org/ws/2004/09/transfer"));
-                clientInterface.setSoapVersion(KDSoapClientInterface::SoapVersion::SOAP1_2);
-                clientInterface.setTimeout(5000);
-
-                KDSoapMessage soapMessage;
-                KDSoapMessageAddressingProperties soapMessageProperties;
-                soapMessageProperties.setAddressingNamespace(KDSoapMessageAddressingProperties::Addressing200408);
-                soapMessageProperties.setAction(QStringLiteral("http://schemas.xmlsoap.org/ws/2004/09/transfer/Get"));
-                soapMessageProperties.setMessageID(QStringLiteral("urn:uuid:") + QUuid::createUuid().toString(QUuid::WithoutBraces));
-                soapMessageProperties.setDestination(service.endpointReference());
-                soapMessageProperties.setReplyEndpointAddress(
-                    KDSoapMessageAddressingProperties::predefinedAddressToString(KDSoapMessageAddressingProperties::Anonymous,
-                                                                                 KDSoapMessageAddressingProperties::Addressing200408));
-                soapMessageProperties.setSourceEndpointAddress(QStringLiteral("urn:uuid:") + QUuid::createUuid().toString(QUuid::WithoutBraces));
-                soapMessage.setMessageAddressingProperties(soapMessageProperties);
-
-                KDSoapMessage response = clientInterface.call(QString(), soapMessage);
-
-                if (!response.isFault()) {
-                    KDSoapValueList childValues = response.childValues();
-
-                    for (const KDSoapValue &value : std::as_const(childValues)) {
-                        QString entry = value.childValues()
-                                            .child(QStringLiteral("Relationship"))
-                                            .childValues()
-                                            .child(QStringLiteral("Host"))
-                                            .childValues()
-                                            .child(QStringLiteral("Computer"))
-                                            .value()
-                                            .toString();
-
-                        switch (*pProcess) {
-                        case LookupDomains: {
-                            //
-                            // Get the name of the workgroup or domain
-                            //
-                            QString workgroupName = entry.section(QStringLiteral(":"), 1, -1);
-
-                            //
-                            // Work around an empty workgroup/domain name. Use the "LOCAL" domain from
-                            // DNS-SD for that.
-                            //
-                            if (workgroupName.isEmpty()) {
-                                workgroupName = QStringLiteral("LOCAL");
-                            }
-
-                            //
-                            // Process the workgroup name. Only add a new workgroup, if it
-                            // is not present already.
-                            //
-                            bool foundWorkgroup = false;
+        requestMetadata(service);
+    }
 
-                            for (const WorkgroupPtr &w : std::as_const(*pWorkgroups)) {
-                                if (QString::compare(w->workgroupName(), workgroupName, Qt::CaseInsensitive) == 0) {
-                                    foundWorkgroup = true;
-                                    break;
-                                }
-                            }
+    //
+    // Restart the timer
+    //
+    m_timer->start();
+}
 
-                            //
-                            // If the workgroup is unknown, add it to the list
-                            //
-                            if (!foundWorkgroup) {
-                                //
-                                // Create the workgroup object
-                                //
-                                WorkgroupPtr workgroup = WorkgroupPtr::create();
-
-                                //
-                                // Set the workgroup/domain name
-                                //
-                                workgroup->setWorkgroupName(workgroupName);
-
-                                //
-                                // Add the workgroup
-                                //
-                                *pWorkgroups << workgroup;
-                            }
+void Smb4KWsDiscoveryJob::slotResolveMatchReceived(const WSDiscoveryTargetService &service)
+{
+    if (m_discoveryFinished) {
+        return;
+    }
 
-                            break;
-                        }
-                        case LookupDomainMembers: {
-                            //
-                            // Get the workgroup name
-                            //
-                            QString workgroupName = entry.section(QStringLiteral(":"), 1, -1);
+    //
+    // Stop the timer
+    //
+    m_timer->stop();
 
-                            //
-                            // Work around an empty workgroup/domain name. Use the "LOCAL" domain from
-                            // DNS-SD for that.
-                            //
-                            if (workgroupName.isEmpty()) {
-                                workgroupName = QStringLiteral("LOCAL");
-                            }
+    //
+    // If there are addresses available, request the metadata of
+    // the device.
+    //
+    if (!service.xAddrList().isEmpty()) {
+        requestMetadata(service);
+    }
 
-                            //
-                            // Get the host name. Unfortunately, the delimiter depends on
-                            // whether the host is member of a workgroup (/) or domain (\).
-                            //
-                            QString hostName;
+    //
+    // Restart the timer
+    //
+    m_timer->start();
+}
 
-                            if (entry.contains(QStringLiteral("/"))) {
-                                hostName = entry.section(QStringLiteral("/"), 0, 0);
-                            } else if (entry.contains(QStringLiteral("\\"))) {
-                                hostName = entry.section(QStringLiteral("\\"), 0, 0);
-                            }
+void Smb4KWsDiscoveryJob::slotMetadataReceived(KDSoapPendingCallWatcher *watcher)
+{
+    MetadataRequest request = m_runningRequests.take(watcher);
+    KDSoapMessage response = watcher->returnMessage();
 
-                            //
-                            // Process the host name. Only add a new host, if it
-                            // is not present already.
-                            //
-                            if (!hostName.isEmpty()) {
-                                //
-                                // Check if the server is already known
-                                //
-                                bool foundServer = false;
-
-                                for (const HostPtr &h : std::as_const(*pHosts)) {
-                                    if (QString::compare(h->hostName(), hostName, Qt::CaseInsensitive) == 0
-                                        && QString::compare(h->workgroupName(), workgroupName, Qt::CaseInsensitive) == 0) {
-                                        foundServer = true;
-                                        break;
-                                    }
-                                }
-
-                                //
-                                // If the server is unknown, add it to the list
-                                //
-                                if (!foundServer) {
-                                    //
-                                    // Create the host object
-                                    //
-                                    HostPtr host = HostPtr::create();
-
-                                    //
-                                    // Set the workgroup/domain name
-                                    //
-                                    host->setWorkgroupName(workgroupName);
-
-                                    //
-                                    // Set the host name
-                                    //
-                                    host->setHostName(hostName);
-
-                                    //
-                                    // Lookup IP address
-                                    //
-                                    QHostAddress address = lookupIpAddress(hostName);
-
-                                    //
-                                    // Process the IP address.
-                                    //
-                                    if (!address.isNull()) {
-                                        host->setIpAddress(address);
-                                    }
-
-                                    //
-                                    // Add the host
-                                    //
-                                    *pHosts << host;
-                                }
-                            }
+    //
+    // The reply that is owned by the client interface is still emitting
+    // the signal, so do not delete anything right away
+    //
+    watcher->deleteLater();
+    request.clientInterface->deleteLater();
+    request.clientInterface = nullptr;
 
-                            break;
-                        }
-                        default: {
-                            break;
-                        }
-                        }
-                    }
-                }
-            }
+    if (!response.isFault()) {
+        //
+        // Extract the computer entries, cache them and add the
+        // discovered network items to the respective lists.
+        //
+        QStringList computers;
+        const KDSoapValueList childValues = response.childValues();
+
+        for (const KDSoapValue &value : childValues) {
+            computers << value.childValues()
+                             .child(QStringLiteral("Relationship"))
+                             .childValues()
+                             .child(QStringLiteral("Host"))
+                             .childValues()
+                             .child(QStringLiteral("Computer"))
+                             .value()
+                             .toString();
         }
+
+        Smb4KWsDiscoveryCache::self()->insert(request.endpointReference, request.metadataVersion, computers);
+        processComputers(computers);
+    } else if (!request.addresses.isEmpty()) {
+        //
+        // Try the next address of the device
+        //
+        m_pendingRequests.prepend(request);
     }
 
+    sendRequests();
+
+    finishIfDone();
+}
+
+void Smb4KWsDiscoveryJob::slotDiscoveryFinished()
+{
+    m_discoveryFinished = true;
+
     //
-    // Restart the timer
+    // Wait for the outstanding metadata requests and address lookups
     //
-    m_timer->start();
+    finishIfDone();
 }
 
-void Smb4KWsDiscoveryJob::slotResolveMatchReceived(const WSDiscoveryTargetService &service)
+void Smb4KWsDiscoveryJob::requestMetadata(const WSDiscoveryTargetService &service)
 {
     //
-    // Stop the timer
+    // Only request the metadata once per device, even if it answered
+    // the probe and the resolve message
     //
-    m_timer->stop();
+    if (m_requestedEndpoints.contains(service.endpointReference())) {
+        return;
+    }
+
+    m_requestedEndpoints.insert(service.endpointReference());
 
     //
-    // If there are addresses available, resolve them and add the
-    // discovered network items to the respective lists.
+    // Skip the request if the metadata did not change since the
+    // last time it was received
     //
-    if (!service.xAddrList().isEmpty()) {
-        for (const QUrl &address : service.xAddrList()) {
-            KDSoapClientInterface clientInterface(address.toString(), QStringLiteral("http://schemas.xmlsoap.org/ws/2004/09/transfer"));
-            clientInterface.setSoapVersion(KDSoapClientInterface::SoapVersion::SOAP1_2);
-            clientInterface.setTimeout(5000);
-
-            KDSoapMessage soapMessage;
-            KDSoapMessageAddressingProperties soapMessageProperties;
-            soapMessageProperties.setAddressingNamespace(KDSoapMessageAddressingProperties::Addressing200408);
-            soapMessageProperties.setAction(QStringLiteral("http://schemas.xmlsoap.org/ws/2004/09/transfer/Get"));
-            soapMessageProperties.setMessageID(QStringLiteral("urn:uuid:") + QUuid::createUuid().toString(QUuid::WithoutBraces));
-            soapMessageProperties.setDestination(service.endpointReference());
-            soapMessageProperties.setReplyEndpointAddress(
-                KDSoapMessageAddressingProperties::predefinedAddressToString(KDSoapMessageAddressingProperties::Anonymous,
-                                                                             KDSoapMessageAddressingProperties::Addressing200408));
-            soapMessageProperties.setSourceEndpointAddress(QStringLiteral("urn:uuid:") + QUuid::createUuid().toString(QUuid::WithoutBraces));
-            soapMessage.setMessageAddressingProperties(soapMessageProperties);
-
-            KDSoapMessage response = clientInterface.call(QString(), soapMessage);
-
-            if (!response.isFault()) {
-                KDSoapValueList childValues = response.childValues();
-
-                for (const KDSoapValue &value : std::as_const(childValues)) {
-                    QString entry = value.childValues()
-                                        .child(QStringLiteral("Relationship"))
-                                        .childValues()
-                                        .child(QStringLiteral("Host"))
-                                        .childValues()
-                                        .child(QStringLiteral("Computer"))
-                                        .value()
-                                        .toString();
-
-                    switch (*pProcess) {
-                    case LookupDomains: {
-                        //
-                        // Get the name of the workgroup or domain
-                        //
-                        QString workgroupName = entry.section(QStringLiteral(":"), 1, -1);
-
-                        //
-                        // Work around an empty workgroup/domain name. Use the "LOCAL" domain from
-                        // DNS-SD for that.
-                        //
-                        if (workgroupName.isEmpty()) {
-                            workgroupName = QStringLiteral("LOCAL");
-                        }
+    QStringList computers;
 
-                        //
-                        // Process the workgroup name. Only add a new workgroup, if it
-                        // is not present already.
-                        //
-                        bool foundWorkgroup = false;
+    if (Smb4KWsDiscoveryCache::self()->find(service.endpointReference(), service.metadataVersion(), &computers)) {
+        processComputers(computers);
+        return;
+    }
 
-                        for (const WorkgroupPtr &w : std::as_const(*pWorkgroups)) {
-                            if (QString::compare(w->workgroupName(), workgroupName, Qt::CaseInsensitive) == 0) {
-                                foundWorkgroup = true;
-                                break;
-                            }
-                        }
+    MetadataRequest request;
+    request.endpointReference = service.endpointReference();
+    request.metadataVersion = service.metadataVersion();
+    request.addresses = service.xAddrList();
+    request.clientInterface = nullptr;
 
-                        //
-                        // If the workgroup is unknown, add it to the list
-                        //
-                        if (!foundWorkgroup) {
-                            //
-                            // Create the workgroup object
-                            //
-                            WorkgroupPtr workgroup = WorkgroupPtr::create();
+    m_pendingRequests << request;
 
-                            //
-                            // Set the workgroup/domain name
-                            //
-                            workgroup->setWorkgroupName(workgroupName);
+    sendRequests();
+}
 
-                            //
-                            // Add the workgroup
-                            //
-                            *pWorkgroups << workgroup;
-                        }
+void Smb4KWsDiscoveryJob::sendRequests()
+{
+    while (!m_pendingRequests.isEmpty() && m_runningRequests.size() < MAX_METADATA_REQUESTS) {
+        sendRequest(m_pendingRequests.takeFirst());
+    }
+}
 
-                        break;
-                    }
-                    case LookupDomainMembers: {
-                        //
-                        // Get the workgroup name
-                        //
-                        QString workgroupName = entry.section(QStringLiteral(":"), 1, -1);
-
-                        //
-                        // Work around an empty workgroup/domain name. Use the "LOCAL" domain from
-                        // DNS-SD for that.
-                        //
-                        if (workgroupName.isEmpty()) {
-                            workgroupName = QStringLiteral("LOCAL");
-                        }
+void Smb4KWsDiscoveryJob::sendRequest(MetadataRequest request)
+{
+    QUrl address = request.addresses.takeFirst();
+
+    request.clientInterface = new KDSoapClientInterface(address.toString(), QStringLiteral("http://schemas.xmlsoap.org/ws/2004/09/transfer"));
+    request.clientInterface->setSoapVersion(KDSoapClientInterface::SoapVersion::SOAP1_2);
+    request.clientInterface->setTimeout(METADATA_REQUEST_TIMEOUT);
+
+    KDSoapMessage soapMessage;
+    KDSoapMessageAddressingProperties soapMessageProperties;
+    soapMessageProperties.setAddressingNamespace(KDSoapMessageAddressingProperties::Addressing200408);
+    soapMessageProperties.setAction(QStringLiteral("http://schemas.xmlsoap.org/ws/2004/09/transfer/Get"));
+    soapMessageProperties.setMessageID(QStringLiteral("urn:uuid:") + QUuid::createUuid().toString(QUuid::WithoutBraces));
+    soapMessageProperties.setDestination(request.endpointReference);
+    soapMessageProperties.setReplyEndpointAddress(
+        KDSoapMessageAddressingProperties::predefinedAddressToString(KDSoapMessageAddressingProperties::Anonymous,
+                                                                     KDSoapMessageAddressingProperties::Addressing200408));
+    soapMessageProperties.setSourceEndpointAddress(QStringLiteral("urn:uuid:") + QUuid::createUuid().toString(QUuid::WithoutBraces));
+    soapMessage.setMessageAddressingProperties(soapMessageProperties);
+
+    KDSoapPendingCallWatcher *watcher = new KDSoapPendingCallWatcher(request.clientInterface->asyncCall(QString(), soapMessage), this);
+    m_runningRequests.insert(watcher, request);
+
+    connect(watcher, &KDSoapPendingCallWatcher::finished, this, &Smb4KWsDiscoveryJob::slotMetadataReceived);
+}
 
-                        //
-                        // Get the host name. Unfortunately, the delimiter depends on
-                        // whether the host is member of a workgroup (/) or domain (\).
-                        //
-                        QString hostName;
+void Smb4KWsDiscoveryJob::processComputers(const QStringList &computers)
+{
+    for (const QString &entry : computers) {
+        switch (*pProcess) {
+        case LookupDomains: {
+            //
+            // Get the name of the workgroup or domain
+            //
+            QString workgroupName = entry.section(QStringLiteral(":"), 1, -1);
 
-                        if (entry.contains(QStringLiteral("/"))) {
-                            hostName = entry.section(QStringLiteral("/"), 0, 0);
-                        } else if (entry.contains(QStringLiteral("\\"))) {
-                            hostName = entry.section(QStringLiteral("\\"), 0, 0);
-                        }
+            //
+            // Work around an empty workgroup/domain name. Use the "LOCAL" domain from
+            // DNS-SD for that.
+            //
+            if (workgroupName.isEmpty()) {
+                workgroupName = QStringLiteral("LOCAL");
+            }
 
-                        //
-                        // Process the host name. Only add a new host, if it
-                        // is not present already.
-                        //
-                        if (!hostName.isEmpty()) {
-                            //
-                            // Check if the server is already known
-                            //
-                            bool foundServer = false;
-
-                            for (const HostPtr &h : std::as_const(*pHosts)) {
-                                if (QString::compare(h->hostName(), hostName, Qt::CaseInsensitive) == 0
-                                    && QString::compare(h->workgroupName(), workgroupName, Qt::CaseInsensitive) == 0) {
-                                    foundServer = true;
-                                    break;
-                                }
-                            }
+            //
+            // Process the workgroup name. Only add a new workgroup, if it
+            // is not present already.
+            //
+            bool foundWorkgroup = false;
+
+            for (const WorkgroupPtr &w : std::as_const(*pWorkgroups)) {
+                if (QString::compare(w->workgroupName(), workgroupName, Qt::CaseInsensitive) == 0) {
+                    foundWorkgroup = true;
+                    break;
+                }
+            }
+
+            //
+            // If the workgroup is unknown, add it to the list
+            //
+            if (!foundWorkgroup) {
+                //
+                // Create the workgroup object
+                //
+                WorkgroupPtr workgroup = WorkgroupPtr::create();
+
+                //
+                // Set the workgroup/domain name
+                //
+                workgroup->setWorkgroupName(workgroupName);
+
+                //
+                // Add the workgroup
+                //
+                *pWorkgroups << workgroup;
+            }
+
+            break;
+        }
+        case LookupDomainMembers: {
+            //
+            // Get the workgroup name
+            //
+            QString workgroupName = entry.section(QStringLiteral(":"), 1, -1);
+
+            //
+            // Work around an empty workgroup/domain name. Use the "LOCAL" domain from
+            // DNS-SD for that.
+            //
+            if (workgroupName.isEmpty()) {
+                workgroupName = QStringLiteral("LOCAL");
+            }
+
+            //
+            // Get the host name. Unfortunately, the delimiter depends on
+            // whether the host is member of a workgroup (/) or domain (\).
+            //
+            QString hostName;
+
+            if (entry.contains(QStringLiteral("/"))) {
+                hostName = entry.section(QStringLiteral("/"), 0, 0);
+            } else if (entry.contains(QStringLiteral("\\"))) {
+                hostName = entry.section(QStringLiteral("\\"), 0, 0);
+            }
+
+            //
+            // Process the host name. Only add a new host, if it
+            // is not present already.
+            //
+            if (!hostName.isEmpty()) {
+                //
+                // Check if the server is already known
+                //
+                bool foundServer = false;
+
+                for (const HostPtr &h : std::as_const(*pHosts)) {
+                    if (QString::compare(h->hostName(), hostName, Qt::CaseInsensitive) == 0
+                        && QString::compare(h->workgroupName(), workgroupName, Qt::CaseInsensitive) == 0) {
+                        foundServer = true;
+                        break;
+                    }
+                }
+
+                //
+                // If the server is unknown, add it to the list
+                //
+                if (!foundServer) {
+                    //
+                    // Create the host object
+                    //
+                    HostPtr host = HostPtr::create();
+
+                    //
+                    // Set the workgroup/domain name
+                    //
+                    host->setWorkgroupName(workgroupName);
+
+                    //
+                    // Set the host name
+                    //
+                    host->setHostName(hostName);
+
+                    //
+                    // Look up the IP address asynchronously, so that the
+                    // main thread is not blocked by slow name resolution.
+                    //
+                    m_runningLookups++;
+
+                    QHostInfo::lookupHost(hostName, this, [this, host, hostName](const QHostInfo &hostInfo) {
+                        m_runningLookups--;
+
+                        if (hostInfo.error() == QHostInfo::NoError) {
+                            QHostAddress address = preferredAddress(hostInfo.addresses());
 
                             //
-                            // If the server is unknown, add it to the list
+                            // Process the IP address.
                             //
-                            if (!foundServer) {
-                                //
-                                // Create the host object
-                                //
-                                HostPtr host = HostPtr::create();
-
-                                //
-                                // Set the workgroup/domain name
-                                //
-                                host->setWorkgroupName(workgroupName);
-
-                                //
-                                // Set the host name
-                                //
-                                host->setHostName(hostName);
-
-                                //
-                                // Lookup IP address
-                                //
-                                QHostAddress address = lookupIpAddress(hostName);
-
-                                //
-                                // Process the IP address.
-                                //
-                                if (!address.isNull()) {
-                                    host->setIpAddress(address);
-                                }
-
-                                //
-                                // Add the host
-                                //
-                                *pHosts << host;
+                            if (!address.isNull()) {
+                                host->setIpAddress(address);
+                                Smb4KHostResolver::self()->insert(hostName, address);
                             }
                         }
 
-                        break;
-                    }
-                    default: {
-                        break;
-                    }
-                    }
+                        finishIfDone();
+                    });
+
+                    //
+                    // Add the host
+                    //
+                    *pHosts << host;
                 }
             }
+
+            break;
+        }
+        default: {
+            break;
+        }
         }
     }
-
-    //
-    // Restart the timer
-    //
-    m_timer->start();
 }
 
-void Smb4KWsDiscoveryJob::slotDiscoveryFinished()
+void Smb4KWsDiscoveryJob::finishIfDone()
 {
-    emitResult();
+    if (m_discoveryFinished && m_pendingRequests.isEmpty() && m_runningRequests.isEmpty() && m_runningLookups == 0 && !isFinished()) {
+        emitResult();
+    }
 }
 #endif
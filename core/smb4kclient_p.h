@@ -16,13 +16,22 @@
 #include "smb4kshare.h"
 #include "smb4kworkgroup.h"
 
+// System includes
+#include <functional>
+
 // Samba includes
 #include <libsmbclient.h>
 
 // Qt includes
+#include <QAtomicInt>
+#include <QDateTime>
+#include <QDeadlineTimer>
+#include <QHash>
 #include <QHostAddress>
+#include <QMutex>
+#include <QSet>
+#include <QThreadPool>
 #include <QTimer>
-#include <QUdpSocket>
 #include <QUrl>
 
 // KDE includes
@@ -32,8 +41,245 @@
 
 #ifdef USE_WS_DISCOVERY
 #include <WSDiscoveryClient>
+
+class KDSoapClientInterface;
+class KDSoapPendingCallWatcher;
 #endif
 
+class Smb4KHostResolver
+{
+public:
+    /**
+     * Constructor
+     */
+    Smb4KHostResolver();
+
+    /**
+     * Destructor
+     */
+    ~Smb4KHostResolver();
+
+    /**
+     * Returns a static pointer to this class
+     */
+    static Smb4KHostResolver *self();
+
+    /**
+     * Resolve the IP addresses of all hosts in @p names without blocking. Cached
+     * entries are used if possible. All other names are looked up in parallel.
+     * When all lookups finished, @p callback is invoked in the thread of @p receiver
+     * with a hash that has the upper case host names as keys and the IP addresses
+     * as values. If all names were cached, @p callback is invoked right away. It
+     * is not invoked anymore if @p receiver was destroyed.
+     *
+     * This function must be called from the thread of @p receiver.
+     *
+     * @param names         The list of host names
+     * @param receiver      The context object of the callback
+     * @param callback      The function that receives the addresses
+     */
+    void resolve(const QStringList &names, QObject *receiver, const std::function<void(const QHash<QString, QHostAddress> &)> &callback);
+
+    /**
+     * Insert the IP address @p address of the host with the name @p name
+     * that was obtained elsewhere into the cache.
+     *
+     * @param name          The host name
+     * @param address       The IP address
+     */
+    void insert(const QString &name, const QHostAddress &address);
+
+    /**
+     * Clear the cache
+     */
+    void clear();
+
+private:
+    struct CacheEntry {
+        QHostAddress address;
+        QDeadlineTimer expiry;
+    };
+    bool findCachedAddress(const QString &key, QHostAddress *address);
+    void insertAddress(const QString &key, const QHostAddress &address);
+    QMutex m_mutex;
+    QHash<QString, CacheEntry> m_cache;
+};
+
+class SMB4KCORE_TESTS_EXPORT Smb4KClientContextPool
+{
+public:
+    /**
+     * Constructor
+     */
+    Smb4KClientContextPool();
+
+    /**
+     * Destructor
+     */
+    ~Smb4KClientContextPool();
+
+    /**
+     * Returns a static pointer to this class
+     */
+    static Smb4KClientContextPool *self();
+
+    /**
+     * Take an idle context that was set up with the settings described by
+     * @p key out of the pool. The context keeps its connections to the
+     * server, so no new session needs to be established.
+     *
+     * @param key           The key describing server, credentials and settings
+     *
+     * @returns an initialized context or NULL if none is available.
+     */
+    SMBCCTX *acquire(const QString &key);
+
+    /**
+     * Put the @p context back into the pool. It is freed when it was not
+     * used for the configured idle time.
+     *
+     * @param key           The key describing server, credentials and settings
+     * @param context       The context
+     */
+    void release(const QString &key, SMBCCTX *context);
+
+    /**
+     * Free all idle contexts
+     */
+    void clear();
+
+private:
+    struct IdleContext {
+        QString key;
+        SMBCCTX *context;
+        QDeadlineTimer expiry;
+    };
+    void purge();
+    QList<IdleContext> m_contexts;
+    QTimer m_timer;
+};
+
+class Smb4KClientBackend
+{
+public:
+    /**
+     * The type of a directory entry
+     */
+    enum EntryType {
+        WorkgroupEntry,
+        ServerEntry,
+        FileShareEntry,
+        PrinterShareEntry,
+        IpcShareEntry,
+        FileEntry,
+        DirectoryEntry,
+        LinkEntry,
+        UnknownEntry
+    };
+
+    /**
+     * A directory entry. The size, the time stamps and the attributes are
+     * only set for files and directories.
+     */
+    struct Entry {
+        EntryType type;
+        QString name;
+        QString comment;
+        qint64 size;
+        bool hidden;
+        bool readOnly;
+        QDateTime lastModified;
+        QDateTime created;
+    };
+
+    /**
+     * Destructor
+     */
+    virtual ~Smb4KClientBackend()
+    {
+    }
+
+    /**
+     * Open the directory @p url points to. If @p withAttributes is TRUE, the
+     * entries are files and directories and their attributes are read too.
+     *
+     * @returns 0 on success and the error number otherwise.
+     */
+    virtual int openDirectory(const QUrl &url, bool withAttributes) = 0;
+
+    /**
+     * Read the next entry of the opened directory.
+     *
+     * @returns FALSE if there are no more entries.
+     */
+    virtual bool readDirectory(Entry *entry) = 0;
+
+    /**
+     * Close the opened directory
+     */
+    virtual void closeDirectory() = 0;
+
+    /**
+     * Look up the IP addresses of the hosts @p names without blocking and pass
+     * them to @p callback. The keys of the hash are the upper case names. The
+     * callback is invoked in the thread of @p receiver, possibly right away.
+     */
+    virtual void lookupIpAddresses(const QStringList &names, QObject *receiver, const std::function<void(const QHash<QString, QHostAddress> &)> &callback) = 0;
+};
+
+class Smb4KLibsmbclientBackend : public Smb4KClientBackend
+{
+public:
+    /**
+     * Constructor. The @p context is not taken over.
+     */
+    explicit Smb4KLibsmbclientBackend(SMBCCTX *context);
+
+    /**
+     * Destructor
+     */
+    ~Smb4KLibsmbclientBackend();
+
+    int openDirectory(const QUrl &url, bool withAttributes) override;
+    bool readDirectory(Entry *entry) override;
+    void closeDirectory() override;
+    void lookupIpAddresses(const QStringList &names, QObject *receiver, const std::function<void(const QHash<QString, QHostAddress> &)> &callback) override;
+
+private:
+    SMBCCTX *m_context;
+    SMBCFILE *m_directory;
+    bool m_withAttributes;
+};
+
+class Smb4KSyntheticBackend : public Smb4KClientBackend
+{
+public:
+    /**
+     * Constructor
+     */
+    Smb4KSyntheticBackend();
+
+    /**
+     * Destructor
+     */
+    ~Smb4KSyntheticBackend();
+
+    /**
+     * Returns TRUE if a synthetic network was requested with the
+     * SMB4K_SYNTHETIC_NETWORK environment variable.
+     */
+    static bool isEnabled();
+
+    int openDirectory(const QUrl &url, bool withAttributes) override;
+    bool readDirectory(Entry *entry) override;
+    void closeDirectory() override;
+    void lookupIpAddresses(const QStringList &names, QObject *receiver, const std::function<void(const QHash<QString, QHostAddress> &)> &callback) override;
+
+private:
+    QList<Entry> m_entries;
+    int m_index;
+};
+
 class Smb4KClientBaseJob : public KJob
 {
     Q_OBJECT
@@ -104,6 +350,14 @@ public:
         PrintFileError
     };
 
+Q_SIGNALS:
+    /**
+     * Emitted while a directory is read with the files and directories
+     * that were discovered since the last emission. This signal might be
+     * emitted from a worker thread.
+     */
+    void filesAvailable(const QList<FilePtr> &files);
+
 protected:
     Smb4KGlobal::Process *pProcess;
     NetworkItemPtr *pNetworkItem;
@@ -111,7 +365,6 @@ protected:
     QList<HostPtr> *pHosts;
     QList<SharePtr> *pShares;
     QList<FilePtr> *pFiles;
-    QHostAddress lookupIpAddress(const QString &name);
 
 private:
     Smb4KGlobal::Process m_process;
@@ -162,6 +415,19 @@ public:
      */
     int printCopies() const;
 
+    /**
+     * Set the thread pool the lookups are run on. If no thread pool
+     * is set, the lookups are done in the main thread.
+     */
+    void setThreadPool(QThreadPool *pool);
+
+    /**
+     * Give up a lookup that is still running on a worker thread, e.g.
+     * because the application quits. The job is detached from its parent,
+     * so that it is not deleted while the worker thread still uses it.
+     */
+    void abandon();
+
     /**
      * The authentication function for libsmbclient
      */
@@ -174,17 +440,38 @@ public:
                           char *password,
                           int maxLenPassword);
 
+protected:
+    /**
+     * Reimplemented from KJob. Stops a running lookup and reports the job
+     * as killed.
+     */
+    bool doKill() override;
+
 protected Q_SLOTS:
     void slotStartJob();
     void slotFinishJob();
 
 private:
-    void initClientLibrary();
+    bool initClientLibrary();
+    void readAuthData();
+    void startLookups();
     void doLookups();
+    void finishLookups();
     void doPrinting();
     SMBCCTX *m_context;
+    Smb4KClientBackend *m_backend;
+    QString m_contextKey;
     KFileItem m_fileItem;
     int m_copies;
+    QThreadPool *m_threadPool;
+    QAtomicInt m_aborted;
+    bool m_workerRunning;
+    NetworkItemPtr m_lookupItem;
+    QHostAddress m_hostAddress;
+    QList<WorkgroupPtr> m_discoveredWorkgroups;
+    QList<HostPtr> m_discoveredHosts;
+    QString m_authUserName;
+    QString m_authPassword;
 };
 
 class Smb4KDnsDiscoveryJob : public Smb4KClientBaseJob
@@ -213,7 +500,13 @@ protected Q_SLOTS:
     void slotFinished();
 
 private:
+    void processResolvedService(KDNSSD::RemoteService *service, bool successful);
+    void finishIfDone();
     KDNSSD::ServiceBrowser *m_serviceBrowser;
+    QList<KDNSSD::RemoteService::Ptr> m_resolvingServices;
+    int m_runningLookups;
+    bool m_browsingFinished;
+    QTimer *m_timer;
 };
 
 #ifdef USE_WS_DISCOVERY
@@ -241,11 +534,64 @@ protected Q_SLOTS:
     void slotStartJob();
     void slotProbeMatchReceived(const WSDiscoveryTargetService &service);
     void slotResolveMatchReceived(const WSDiscoveryTargetService &service);
+    void slotMetadataReceived(KDSoapPendingCallWatcher *watcher);
     void slotDiscoveryFinished();
 
 private:
+    struct MetadataRequest {
+        QString endpointReference;
+        uint metadataVersion;
+        QList<QUrl> addresses;
+        KDSoapClientInterface *clientInterface;
+    };
+    void requestMetadata(const WSDiscoveryTargetService &service);
+    void sendRequests();
+    void sendRequest(MetadataRequest request);
+    void processComputers(const QStringList &computers);
+    void finishIfDone();
     WSDiscoveryClient *m_discoveryClient;
     QTimer *m_timer;
+    QList<MetadataRequest> m_pendingRequests;
+    QHash<KDSoapPendingCallWatcher *, MetadataRequest> m_runningRequests;
+    QSet<QString> m_requestedEndpoints;
+    int m_runningLookups;
+    bool m_discoveryFinished;
+};
+
+class Smb4KWsDiscoveryCache
+{
+public:
+    /**
+     * Returns a static pointer to this class
+     */
+    static Smb4KWsDiscoveryCache *self();
+
+    /**
+     * Find the computer entries the device with the endpoint reference
+     * @p endpointReference reported in its metadata. The entry is only
+     * used if the version of the metadata did not change.
+     *
+     * @param endpointReference The endpoint reference of the device
+     * @param metadataVersion   The current metadata version of the device
+     * @param computers         The list that is filled with the computer entries
+     *
+     * @returns TRUE if an up-to-date entry was found.
+     */
+    bool find(const QString &endpointReference, uint metadataVersion, QStringList *computers) const;
+
+    /**
+     * Insert the computer entries @p computers the device with the endpoint
+     * reference @p endpointReference reported in the metadata with version
+     * @p metadataVersion.
+     */
+    void insert(const QString &endpointReference, uint metadataVersion, const QStringList &computers);
+
+private:
+    struct CacheEntry {
+        uint metadataVersion;
+        QStringList computers;
+    };
+    QHash<QString, CacheEntry> m_cache;
 };
 #endif
 
@@ -258,10 +604,37 @@ public:
         KFileItem printFileItem;
         int printCopies;
     };
+    struct RefreshNode {
+        NetworkItemPtr networkItem;
+        int interval;
+        QDeadlineTimer due;
+    };
     QList<WorkgroupPtr> tempWorkgroupList;
-    QList<HostPtr> tempHostList;
+    QHash<QString, WorkgroupPtr> tempWorkgroupIndex;
+    QHash<QString, QList<HostPtr>> tempHostLists;
+    QHash<QString, QHash<QString, HostPtr>> tempHostIndexes;
     QList<QueueContainer> queue;
-    QUdpSocket udpSocket;
+    enum SearchPhase { SearchDomains, SearchMembers, SearchShares };
+    QList<NetworkItemPtr> staleItems;
+    NetworkItemPtr reconciledItem;
+    NetworkItemPtr searchItem;
+    QString searchTerm;
+    bool searchRunning;
+    bool searchLookup;
+    SearchPhase searchPhase;
+    QSet<KJob *> searchJobs;
+    QSet<QString> searchResultKeys;
+    QList<WorkgroupPtr> crawlWorkgroups;
+    QList<HostPtr> crawlHosts;
+    QSet<QString> wakingHosts;
+    NetworkItemPtr wakeUpItem;
+    bool wakeUpDone;
+    QThreadPool *threadPool;
+    QHash<QString, RefreshNode> refreshNodes;
+    QSet<QString> runningRefreshes;
+    bool refreshLookup;
+    QSet<KJob *> refreshJobs;
+    QTimer refreshTimer;
 };
 
 class Smb4KClientStatic
@@ -1,7 +1,7 @@
 /*
  *  This file provides export definitions for the core classes
  *
- *  SPDX-FileCopyrightText: 2024 Alexander Reinholdt <alexander.reinholdt@kdemail.net>
+ *  SPDX-FileCopyrightText: 2024-2026 Alexander Reinholdt <alexander.reinholdt@kdemail.net>
  *  SPDX-License-Identifier: GPL-2.0-or-later
  */
 
@@ -16,4 +16,13 @@
 #define SMB4KCORE_EXPORT Q_DECL_IMPORT
 #endif
 
+//
+// Private classes that are used by the benchmarks
+//
+#ifdef SMB4K_BUILD_TESTING
+#define SMB4KCORE_TESTS_EXPORT SMB4KCORE_EXPORT
+#else
+#define SMB4KCORE_TESTS_EXPORT
+#endif
+
 #endif
@@ -15,6 +15,7 @@
 #include "smb4kprofilemanager.h"
 #include "smb4ksettings.h"
 #include "smb4kshare.h"
+#include "smb4kwritescheduler.h"
 
 #if defined(Q_OS_LINUX)
 #include "smb4kmountsettings_linux.h"
@@ -30,6 +31,7 @@
 #endif
 #include <QDebug>
 #include <QRegularExpression>
+#include <QSaveFile>
 #include <QXmlStreamReader>
 #include <QXmlStreamWriter>
 
@@ -38,12 +40,165 @@
 
 using namespace Smb4KGlobal;
 
+//
+// The custom settings of a host and its shares
+//
+class Smb4KCustomSettingsNode
+{
+public:
+    QList<CustomSettingsPtr> hostSettings;
+    QHash<QString, QList<CustomSettingsPtr>> shareSettings;
+};
+
 class Smb4KCustomSettingsManagerPrivate
 {
 public:
+    void insert(const CustomSettingsPtr &settings);
+    void take(const CustomSettingsPtr &settings);
+    void rebuildIndex();
+    QList<CustomSettingsPtr> find(const QString &profile, const QUrl &url) const;
+    QList<CustomSettingsPtr> shares(const QString &profile, const QString &hostName) const;
+    QStringList profiles() const;
     QList<CustomSettingsPtr> customSettings;
+    QHash<QString, QHash<QString, Smb4KCustomSettingsNode>> index;
+    Smb4KWriteScheduler writeScheduler;
 };
 
+//
+// The key of the share in the index
+//
+static QString shareKey(const QUrl &url)
+{
+    QString path = url.adjusted(QUrl::StripTrailingSlash).path();
+
+    if (path.startsWith(QStringLiteral("/"))) {
+        path.remove(0, 1);
+    }
+
+    return path;
+}
+
+void Smb4KCustomSettingsManagerPrivate::insert(const CustomSettingsPtr &settings)
+{
+    Smb4KCustomSettingsNode &node = index[settings->profile()][settings->url().host().toUpper()];
+    QString share = shareKey(settings->url());
+
+    if (share.isEmpty()) {
+        node.hostSettings << settings;
+    } else {
+        node.shareSettings[share] << settings;
+    }
+}
+
+void Smb4KCustomSettingsManagerPrivate::take(const CustomSettingsPtr &settings)
+{
+    auto profileIt = index.find(settings->profile());
+
+    if (profileIt == index.end()) {
+        return;
+    }
+
+    auto hostIt = profileIt->find(settings->url().host().toUpper());
+
+    if (hostIt == profileIt->end()) {
+        return;
+    }
+
+    QString share = shareKey(settings->url());
+
+    if (share.isEmpty()) {
+        hostIt->hostSettings.removeOne(settings);
+    } else {
+        auto shareIt = hostIt->shareSettings.find(share);
+
+        if (shareIt != hostIt->shareSettings.end()) {
+            shareIt->removeOne(settings);
+
+            if (shareIt->isEmpty()) {
+                hostIt->shareSettings.erase(shareIt);
+            }
+        }
+    }
+
+    if (hostIt->hostSettings.isEmpty() && hostIt->shareSettings.isEmpty()) {
+        profileIt->erase(hostIt);
+    }
+
+    if (profileIt->isEmpty()) {
+        index.erase(profileIt);
+    }
+}
+
+void Smb4KCustomSettingsManagerPrivate::rebuildIndex()
+{
+    index.clear();
+
+    for (const CustomSettingsPtr &settings : std::as_const(customSettings)) {
+        insert(settings);
+    }
+}
+
+QList<CustomSettingsPtr> Smb4KCustomSettingsManagerPrivate::find(const QString &profile, const QUrl &url) const
+{
+    auto profileIt = index.constFind(profile);
+
+    if (profileIt == index.constEnd()) {
+        return QList<CustomSettingsPtr>();
+    }
+
+    auto hostIt = profileIt->constFind(url.host().toUpper());
+
+    if (hostIt == profileIt->constEnd()) {
+        return QList<CustomSettingsPtr>();
+    }
+
+    QString share = shareKey(url);
+
+    if (share.isEmpty()) {
+        return hostIt->hostSettings;
+    }
+
+    return hostIt->shareSettings.value(share);
+}
+
+QList<CustomSettingsPtr> Smb4KCustomSettingsManagerPrivate::shares(const QString &profile, const QString &hostName) const
+{
+    QList<CustomSettingsPtr> settingsList;
+    auto profileIt = index.constFind(profile);
+
+    if (profileIt != index.constEnd()) {
+        auto hostIt = profileIt->constFind(hostName);
+
+        if (hostIt != profileIt->constEnd()) {
+            for (const QList<CustomSettingsPtr> &list : std::as_const(hostIt->shareSettings)) {
+                settingsList << list;
+            }
+        }
+    }
+
+    return settingsList;
+}
+
+QStringList Smb4KCustomSettingsManagerPrivate::profiles() const
+{
+    //
+    // If profiles are not used, the custom settings of all profiles
+    // are considered. Those of the active profile take precedence.
+    //
+    QString activeProfile = Smb4KProfileManager::self()->activeProfile();
+    QStringList profileList = {activeProfile};
+
+    if (!Smb4KSettings::useProfiles()) {
+        for (auto it = index.constBegin(); it != index.constEnd(); ++it) {
+            if (it.key() != activeProfile) {
+                profileList << it.key();
+            }
+        }
+    }
+
+    return profileList;
+}
+
 class Smb4KCustomSettingsManagerStatic
 {
 public:
@@ -67,6 +222,7 @@ Smb4KCustomSettingsManager::Smb4KCustomSettingsManager(QObject *parent)
 
     read();
 
+    connect(&d->writeScheduler, &Smb4KWriteScheduler::write, this, &Smb4KCustomSettingsManager::write);
     connect(Smb4KProfileManager::self(), &Smb4KProfileManager::profileRemoved, this, &Smb4KCustomSettingsManager::slotProfileRemoved);
     connect(Smb4KProfileManager::self(), &Smb4KProfileManager::profileMigrated, this, &Smb4KCustomSettingsManager::slotProfileMigrated);
     connect(Smb4KProfileManager::self(), &Smb4KProfileManager::activeProfileChanged, this, &Smb4KCustomSettingsManager::slotActiveProfileChanged);
@@ -74,6 +230,7 @@ Smb4KCustomSettingsManager::Smb4KCustomSettingsManager(QObject *parent)
 
 Smb4KCustomSettingsManager::~Smb4KCustomSettingsManager()
 {
+    d->writeScheduler.flush();
 }
 
 Smb4KCustomSettingsManager *Smb4KCustomSettingsManager::self()
@@ -96,12 +253,14 @@ void Smb4KCustomSettingsManager::addRemount(const SharePtr &share, bool always)
         // If the options are already in the list, check if the share is
         // always to be remounted. If so, ignore the 'always' argument
         // and leave that option untouched.
+        int remount = settings->remount();
+
         if (settings->remount() != Smb4KCustomSettings::RemountAlways) {
             settings->setRemount(always ? Smb4KCustomSettings::RemountAlways : Smb4KCustomSettings::RemountOnce);
         }
 
-        if (addedSettings) {
-            write();
+        if (addedSettings || remount != settings->remount()) {
+            d->writeScheduler.schedule();
             Q_EMIT updated();
         }
     }
@@ -124,7 +283,7 @@ void Smb4KCustomSettingsManager::removeRemount(const SharePtr &share, bool force
             }
         }
 
-        write();
+        d->writeScheduler.schedule();
         Q_EMIT updated();
     }
 }
@@ -147,10 +306,15 @@ void Smb4KCustomSettingsManager::clearRemounts(bool force)
         }
     }
 
-    write();
+    d->writeScheduler.schedule();
     Q_EMIT updated();
 }
 
+void Smb4KCustomSettingsManager::flush()
+{
+    d->writeScheduler.flush();
+}
+
 QList<CustomSettingsPtr> Smb4KCustomSettingsManager::sharesToRemount()
 {
     QList<CustomSettingsPtr> settingsList = customSettings(false);
@@ -183,21 +347,21 @@ CustomSettingsPtr Smb4KCustomSettingsManager::findCustomSettings(const NetworkIt
 
 CustomSettingsPtr Smb4KCustomSettingsManager::findCustomSettings(const QUrl &url)
 {
-    CustomSettingsPtr settings;
-
     if (url.isValid() && url.scheme() == QStringLiteral("smb")) {
-        QList<CustomSettingsPtr> settingsList = customSettings(false);
+        const QStringList profiles = d->profiles();
+
+        for (const QString &profile : profiles) {
+            const QList<CustomSettingsPtr> settingsList = d->find(profile, url);
 
-        for (const CustomSettingsPtr &cs : std::as_const(settingsList)) {
-            if (cs->url().toString(QUrl::RemoveUserInfo | QUrl::RemovePort | QUrl::StripTrailingSlash)
-                == url.toString(QUrl::RemoveUserInfo | QUrl::RemovePort | QUrl::StripTrailingSlash)) {
-                settings = cs;
-                break;
+            for (const CustomSettingsPtr &settings : settingsList) {
+                if (settings->hasCustomSettings()) {
+                    return settings;
+                }
             }
         }
     }
 
-    return settings;
+    return CustomSettingsPtr();
 }
 
 QList<CustomSettingsPtr> Smb4KCustomSettingsManager::customSettings(bool withoutRemountOnce) const
@@ -220,7 +384,7 @@ QList<CustomSettingsPtr> Smb4KCustomSettingsManager::customSettings(bool without
 void Smb4KCustomSettingsManager::addCustomSettings(const CustomSettingsPtr &settings)
 {
     if (settings && add(settings)) {
-        write();
+        d->writeScheduler.schedule();
         Q_EMIT updated();
     }
 }
@@ -228,7 +392,7 @@ void Smb4KCustomSettingsManager::addCustomSettings(const CustomSettingsPtr &sett
 void Smb4KCustomSettingsManager::removeCustomSettings(const CustomSettingsPtr &settings)
 {
     if (settings && remove(settings)) {
-        write();
+        d->writeScheduler.schedule();
         Q_EMIT updated();
     }
 }
@@ -257,6 +421,7 @@ void Smb4KCustomSettingsManager::saveCustomSettings(const QList<CustomSettingsPt
 
         if (!Smb4KSettings::useProfiles() || (settings->profile() == Smb4KProfileManager::self()->activeProfile())) {
             it.remove();
+            d->take(settings);
             settings.clear();
         }
     }
@@ -265,7 +430,7 @@ void Smb4KCustomSettingsManager::saveCustomSettings(const QList<CustomSettingsPt
         add(settings);
     }
 
-    write();
+    d->writeScheduler.schedule();
     Q_EMIT updated();
 }
 
@@ -283,18 +448,23 @@ bool Smb4KCustomSettingsManager::add(const CustomSettingsPtr &settings)
                 settings->setProfile(Smb4KProfileManager::self()->activeProfile());
             }
             d->customSettings << settings;
+            d->insert(settings);
         }
 
         // Propagate the settings to the host's shares if the type is 'Host'
         if (settings->type() == Host) {
-            QList<CustomSettingsPtr> customSettingsList = customSettings(true);
+            const QStringList profiles = d->profiles();
 
-            for (const CustomSettingsPtr &cs : std::as_const(customSettingsList)) {
+            for (const QString &profile : profiles) {
                 // Since only the URL is important, do not check for the workgroup.
                 // Also, if the workgroup is a DNS-SD domain, it is most likely not
                 // a valid SMB workgroup or domain.
-                if (cs->type() == Share && cs->hostName() == settings->hostName()) {
-                    cs->update(settings.data());
+                const QList<CustomSettingsPtr> customSettingsList = d->shares(profile, settings->hostName());
+
+                for (const CustomSettingsPtr &cs : customSettingsList) {
+                    if (cs->type() == Share && cs->hasCustomSettings(true)) {
+                        cs->update(settings.data());
+                    }
                 }
             }
         }
@@ -307,19 +477,21 @@ bool Smb4KCustomSettingsManager::add(const CustomSettingsPtr &settings)
 
 bool Smb4KCustomSettingsManager::remove(const CustomSettingsPtr &settings)
 {
-    bool removedSettings = false;
+    const QStringList profiles = d->profiles();
+
+    for (const QString &profile : profiles) {
+        QList<CustomSettingsPtr> settingsList = d->find(profile, settings->url());
 
-    // FIXME: Use while loop here
-    for (int i = 0; i < d->customSettings.size(); i++) {
-        if ((!Smb4KSettings::useProfiles() || Smb4KProfileManager::self()->activeProfile() == d->customSettings.at(i)->profile())
-            && d->customSettings.at(i)->url().matches(settings->url(), QUrl::RemoveUserInfo | QUrl::RemovePort | QUrl::StripTrailingSlash)) {
-            d->customSettings.takeAt(i).clear();
-            removedSettings = true;
-            break;
+        if (!settingsList.isEmpty()) {
+            CustomSettingsPtr knownSettings = settingsList.first();
+            d->take(knownSettings);
+            d->customSettings.removeOne(knownSettings);
+            knownSettings.clear();
+            return true;
         }
     }
 
-    return removedSettings;
+    return false;
 }
 
 void Smb4KCustomSettingsManager::read()
@@ -328,6 +500,8 @@ void Smb4KCustomSettingsManager::read()
         d->customSettings.takeFirst().clear();
     }
 
+    d->index.clear();
+
     QFile xmlFile(dataLocation() + QDir::separator() + QStringLiteral("custom_options.xml"));
 
     if (xmlFile.open(QIODevice::ReadOnly | QIODevice::Text)) {
@@ -510,6 +684,7 @@ void Smb4KCustomSettingsManager::read()
                         }
 
                         d->customSettings << settings;
+                        d->insert(settings);
                     }
                 }
             }
@@ -529,13 +704,19 @@ void Smb4KCustomSettingsManager::read()
 
 void Smb4KCustomSettingsManager::write()
 {
-    QFile xmlFile(dataLocation() + QDir::separator() + QStringLiteral("custom_options.xml"));
+    QString fileName = dataLocation() + QDir::separator() + QStringLiteral("custom_options.xml");
 
     if (d->customSettings.isEmpty()) {
-        xmlFile.remove();
+        QFile::remove(fileName);
         return;
     }
 
+    //
+    // Write to a temporary file first, so that an interrupted write
+    // does not destroy the custom settings
+    //
+    QSaveFile xmlFile(fileName);
+
     if (xmlFile.open(QIODevice::WriteOnly | QIODevice::Text)) {
         QXmlStreamWriter xmlWriter(&xmlFile);
         xmlWriter.setAutoFormatting(true);
@@ -572,7 +753,10 @@ void Smb4KCustomSettingsManager::write()
         }
 
         xmlWriter.writeEndDocument();
-        xmlFile.close();
+
+        if (!xmlFile.commit()) {
+            Smb4KNotification::openingFileFailed(xmlFile);
+        }
     } else {
         Smb4KNotification::openingFileFailed(xmlFile);
     }
@@ -595,7 +779,9 @@ void Smb4KCustomSettingsManager::slotProfileRemoved(const QString &name)
         }
     }
 
-    write();
+    d->index.remove(name);
+
+    d->writeScheduler.schedule();
     Q_EMIT updated();
 }
 
@@ -607,7 +793,9 @@ void Smb4KCustomSettingsManager::slotProfileMigrated(const QString &oldName, con
         }
     }
 
-    write();
+    d->rebuildIndex();
+
+    d->writeScheduler.schedule();
     Q_EMIT updated();
 }
 
@@ -85,6 +85,12 @@ public:
      */
     void clearRemounts(bool force);
 
+    /**
+     * Writes pending changes of the custom settings to the disk immediately.
+     * Usually, changes are collected and written after a short delay.
+     */
+    void flush();
+
     /**
      * Returns the list of shares that are to be remounted.
      *
@@ -25,6 +25,11 @@ public:
     QString workgroupName;
     QHostAddress ip;
     bool isDirectory;
+    bool isHidden;
+    bool isReadOnly;
+    qint64 size;
+    QDateTime lastModified;
+    QDateTime created;
 };
 
 Smb4KFile::Smb4KFile(const QUrl &url)
@@ -34,6 +39,9 @@ Smb4KFile::Smb4KFile(const QUrl &url)
     *pUrl = url;
     *pIcon = KDE::icon(KIO::iconNameForUrl(url));
     d->isDirectory = false;
+    d->isHidden = false;
+    d->isReadOnly = false;
+    d->size = -1;
 }
 
 Smb4KFile::Smb4KFile(const Smb4KFile &file)
@@ -48,6 +56,9 @@ Smb4KFile::Smb4KFile()
     , d(new Smb4KFilePrivate)
 {
     d->isDirectory = false;
+    d->isHidden = false;
+    d->isReadOnly = false;
+    d->size = -1;
 }
 
 Smb4KFile::~Smb4KFile()
@@ -137,7 +148,52 @@ QString Smb4KFile::name() const
 
 bool Smb4KFile::isHidden() const
 {
-    return name().startsWith(QStringLiteral("."));
+    return d->isHidden || name().startsWith(QStringLiteral("."));
+}
+
+void Smb4KFile::setHidden(bool hidden) const
+{
+    d->isHidden = hidden;
+}
+
+void Smb4KFile::setReadOnly(bool readOnly) const
+{
+    d->isReadOnly = readOnly;
+}
+
+bool Smb4KFile::isReadOnly() const
+{
+    return d->isReadOnly;
+}
+
+void Smb4KFile::setSize(qint64 size) const
+{
+    d->size = size;
+}
+
+qint64 Smb4KFile::size() const
+{
+    return d->size;
+}
+
+void Smb4KFile::setLastModified(const QDateTime &dateTime) const
+{
+    d->lastModified = dateTime;
+}
+
+QDateTime Smb4KFile::lastModified() const
+{
+    return d->lastModified;
+}
+
+void Smb4KFile::setCreated(const QDateTime &dateTime) const
+{
+    d->created = dateTime;
+}
+
+QDateTime Smb4KFile::created() const
+{
+    return d->created;
 }
 
 Smb4KFile &Smb4KFile::operator=(const Smb4KFile &other)
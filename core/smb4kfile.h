@@ -13,6 +13,7 @@
 #include "smb4kcore_export.h"
 
 // Qt includes
+#include <QDateTime>
 #include <QHostAddress>
 #include <QScopedPointer>
 
@@ -150,6 +151,72 @@ public:
      */
     bool isHidden() const;
 
+    /**
+     * Set the hidden attribute reported by the server. Files and directories
+     * whose names start with a dot are always considered hidden.
+     *
+     * @param hidden        Set this to TRUE if the item has the hidden attribute
+     */
+    void setHidden(bool hidden) const;
+
+    /**
+     * Set the read-only attribute reported by the server.
+     *
+     * @param readOnly      Set this to TRUE if the item is read-only
+     */
+    void setReadOnly(bool readOnly) const;
+
+    /**
+     * Returns TRUE if the server reported the file or directory as read-only.
+     *
+     * @returns TRUE if the item is read-only
+     */
+    bool isReadOnly() const;
+
+    /**
+     * Set the size of the file in bytes.
+     *
+     * @param size          The size
+     */
+    void setSize(qint64 size) const;
+
+    /**
+     * Returns the size of the file in bytes or -1 if it is not known.
+     *
+     * @returns the size
+     */
+    qint64 size() const;
+
+    /**
+     * Set the time the file or directory was last modified.
+     *
+     * @param dateTime      The modification time
+     */
+    void setLastModified(const QDateTime &dateTime) const;
+
+    /**
+     * Returns the time the file or directory was last modified. The returned
+     * date and time is invalid if it is not known.
+     *
+     * @returns the modification time
+     */
+    QDateTime lastModified() const;
+
+    /**
+     * Set the time the file or directory was created.
+     *
+     * @param dateTime      The creation time
+     */
+    void setCreated(const QDateTime &dateTime) const;
+
+    /**
+     * Returns the time the file or directory was created. The returned
+     * date and time is invalid if it is not known.
+     *
+     * @returns the creation time
+     */
+    QDateTime created() const;
+
     /**
      * Copy assignment operator
      */
@@ -1,7 +1,7 @@
 /*
     This is the global namespace for Smb4K.
 
-    SPDX-FileCopyrightText: 2005-2025 Alexander Reinholdt <alexander.reinholdt@kdemail.net>
+    SPDX-FileCopyrightText: 2005-2026 Alexander Reinholdt <alexander.reinholdt@kdemail.net>
     SPDX-License-Identifier: GPL-2.0-or-later
 */
 
@@ -23,7 +23,7 @@
 #include <QDebug>
 #include <QDirIterator>
 #include <QEventLoop>
-#include <QRecursiveMutex>
+#include <QReadWriteLock>
 #include <QStandardPaths>
 #include <QTimer>
 #include <QUrl>
@@ -34,29 +34,123 @@
 #include <KProcess>
 
 Q_APPLICATION_STATIC(Smb4KGlobalPrivate, p);
-QRecursiveMutex mutex;
 
-const QList<WorkgroupPtr> &Smb4KGlobal::workgroupsList()
+//
+// The lists are protected by a read-write lock. Readers get a copy of the
+// list, which is implicitly shared and therefore cheap. Writers modify the
+// lists while holding the write lock. Since QList is copy-on-write, the copies
+// the readers hold are not affected by the modifications.
+//
+static QReadWriteLock listsLock;
+
+//
+// The following functions assume that the lock is already held.
+//
+static WorkgroupPtr findWorkgroupUnlocked(const QString &name)
 {
-    return p->workgroupsList;
+    return p->workgroupsIndex.value(name.toCaseFolded());
 }
 
-WorkgroupPtr Smb4KGlobal::findWorkgroup(const QString &name)
+static HostPtr findHostUnlocked(const QString &name, const QString &workgroup)
+{
+    const QList<HostPtr> hosts = p->hostsIndex.value(name.toCaseFolded());
+
+    for (const HostPtr &h : hosts) {
+        if (workgroup.isEmpty() || QString::compare(h->workgroupName(), workgroup, Qt::CaseInsensitive) == 0) {
+            return h;
+        }
+    }
+
+    return HostPtr();
+}
+
+static SharePtr findShareUnlocked(const QUrl &url, const QString &workgroup)
+{
+    const QList<SharePtr> shares = p->sharesIndex.value(Smb4KGlobalPrivate::urlKey(url));
+
+    for (const SharePtr &s : shares) {
+        if (workgroup.isEmpty() || QString::compare(s->workgroupName(), workgroup, Qt::CaseInsensitive) == 0) {
+            return s;
+        }
+    }
+
+    return SharePtr();
+}
+
+static SharePtr findShareByPathUnlocked(const QString &path)
+{
+    SharePtr share;
+
+    if (!path.isEmpty() && !p->mountedSharesList.isEmpty()) {
+        QString key = path.toCaseFolded();
+
+        share = p->mountedSharesPathIndex.value(key);
+
+        if (!share) {
+            SharePtr s = p->mountedSharesCanonicalPathIndex.value(key);
+
+            if (s && !s->isInaccessible()) {
+                share = s;
+            }
+        }
+    }
+
+    return share;
+}
+
+static QList<SharePtr> findShareByUrlUnlocked(const QUrl &url)
+{
+    QList<SharePtr> shares;
+
+    if (!url.isEmpty() && url.isValid() && !p->mountedSharesList.isEmpty()) {
+        const QList<SharePtr> mountedShares = p->mountedSharesUrlIndex.value(Smb4KGlobalPrivate::urlKey(url));
+
+        if (!mountedShares.isEmpty()) {
+            shares << mountedShares.first();
+        }
+    }
+
+    return shares;
+}
+
+static void copyMountDataUnlocked(const SharePtr &share)
 {
-    WorkgroupPtr workgroup;
+    //
+    // Set the share mounted
+    // Only honor shares that are owned by the user
+    //
+    const QList<SharePtr> mountedShares = findShareByUrlUnlocked(share->url());
 
-    mutex.lock();
+    for (const SharePtr &s : mountedShares) {
+        if (!s->isForeign()) {
+            share->setMountData(s.data());
+            break;
+        }
+    }
+}
 
-    for (const WorkgroupPtr &w : std::as_const(p->workgroupsList)) {
-        if (QString::compare(w->workgroupName(), name, Qt::CaseInsensitive) == 0) {
-            workgroup = w;
+static void updateOnlyForeignSharesUnlocked()
+{
+    p->onlyForeignShares = true;
+
+    for (const SharePtr &s : std::as_const(p->mountedSharesList)) {
+        if (!s->isForeign()) {
+            p->onlyForeignShares = false;
             break;
         }
     }
+}
 
-    mutex.unlock();
+QList<WorkgroupPtr> Smb4KGlobal::workgroupsList()
+{
+    QReadLocker locker(&listsLock);
+    return p->workgroupsList;
+}
 
-    return workgroup;
+WorkgroupPtr Smb4KGlobal::findWorkgroup(const QString &name)
+{
+    QReadLocker locker(&listsLock);
+    return findWorkgroupUnlocked(name);
 }
 
 bool Smb4KGlobal::addWorkgroup(WorkgroupPtr workgroup)
@@ -66,14 +160,13 @@ bool Smb4KGlobal::addWorkgroup(WorkgroupPtr workgroup)
     bool added = false;
 
     if (workgroup) {
-        mutex.lock();
+        QWriteLocker locker(&listsLock);
 
-        if (!findWorkgroup(workgroup->workgroupName())) {
+        if (!findWorkgroupUnlocked(workgroup->workgroupName())) {
             p->workgroupsList.append(workgroup);
+            p->indexWorkgroup(workgroup);
             added = true;
         }
-
-        mutex.unlock();
     }
 
     return added;
@@ -86,16 +179,14 @@ bool Smb4KGlobal::updateWorkgroup(WorkgroupPtr workgroup)
     bool updated = false;
 
     if (workgroup) {
-        mutex.lock();
+        QWriteLocker locker(&listsLock);
 
-        WorkgroupPtr existingWorkgroup = findWorkgroup(workgroup->workgroupName());
+        WorkgroupPtr existingWorkgroup = findWorkgroupUnlocked(workgroup->workgroupName());
 
         if (existingWorkgroup) {
             existingWorkgroup->update(workgroup.data());
             updated = true;
         }
-
-        mutex.unlock();
     }
 
     return updated;
@@ -108,31 +199,31 @@ bool Smb4KGlobal::removeWorkgroup(WorkgroupPtr workgroup)
     bool removed = false;
 
     if (workgroup) {
-        mutex.lock();
+        QWriteLocker locker(&listsLock);
 
         int index = p->workgroupsList.indexOf(workgroup);
 
         if (index != -1) {
             // The workgroup was found. Remove it.
-            p->workgroupsList.takeAt(index).clear();
+            p->unindexWorkgroup(workgroup);
+            p->workgroupsList.removeAt(index);
             removed = true;
         } else {
             // Try harder to find the workgroup.
-            WorkgroupPtr wg = findWorkgroup(workgroup->workgroupName());
+            WorkgroupPtr wg = findWorkgroupUnlocked(workgroup->workgroupName());
 
             if (wg) {
                 index = p->workgroupsList.indexOf(wg);
 
                 if (index != -1) {
-                    p->workgroupsList.takeAt(index).clear();
+                    p->unindexWorkgroup(wg);
+                    p->workgroupsList.removeAt(index);
                     removed = true;
                 }
             }
 
             workgroup.clear();
         }
-
-        mutex.unlock();
     }
 
     return removed;
@@ -140,37 +231,22 @@ bool Smb4KGlobal::removeWorkgroup(WorkgroupPtr workgroup)
 
 void Smb4KGlobal::clearWorkgroupsList()
 {
-    mutex.lock();
+    QWriteLocker locker(&listsLock);
 
-    while (!p->workgroupsList.isEmpty()) {
-        p->workgroupsList.takeFirst().clear();
-    }
-
-    mutex.unlock();
+    p->workgroupsIndex.clear();
+    p->workgroupsList.clear();
 }
 
-const QList<HostPtr> &Smb4KGlobal::hostsList()
+QList<HostPtr> Smb4KGlobal::hostsList()
 {
+    QReadLocker locker(&listsLock);
     return p->hostsList;
 }
 
 HostPtr Smb4KGlobal::findHost(const QString &name, const QString &workgroup)
 {
-    HostPtr host;
-
-    mutex.lock();
-
-    for (const HostPtr &h : std::as_const(p->hostsList)) {
-        if ((workgroup.isEmpty() || QString::compare(h->workgroupName(), workgroup, Qt::CaseInsensitive) == 0)
-            && QString::compare(h->hostName(), name, Qt::CaseInsensitive) == 0) {
-            host = h;
-            break;
-        }
-    }
-
-    mutex.unlock();
-
-    return host;
+    QReadLocker locker(&listsLock);
+    return findHostUnlocked(name, workgroup);
 }
 
 bool Smb4KGlobal::addHost(HostPtr host)
@@ -180,14 +256,13 @@ bool Smb4KGlobal::addHost(HostPtr host)
     bool added = false;
 
     if (host) {
-        mutex.lock();
+        QWriteLocker locker(&listsLock);
 
-        if (!findHost(host->hostName(), host->workgroupName())) {
+        if (!findHostUnlocked(host->hostName(), host->workgroupName())) {
             p->hostsList.append(host);
+            p->indexHost(host);
             added = true;
         }
-
-        mutex.unlock();
     }
 
     return added;
@@ -200,16 +275,14 @@ bool Smb4KGlobal::updateHost(HostPtr host)
     bool updated = false;
 
     if (host) {
-        mutex.lock();
+        QWriteLocker locker(&listsLock);
 
-        HostPtr existingHost = findHost(host->hostName(), host->workgroupName());
+        HostPtr existingHost = findHostUnlocked(host->hostName(), host->workgroupName());
 
         if (existingHost) {
             existingHost->update(host.data());
             updated = true;
         }
-
-        mutex.unlock();
     }
 
     return updated;
@@ -222,31 +295,31 @@ bool Smb4KGlobal::removeHost(HostPtr host)
     bool removed = false;
 
     if (host) {
-        mutex.lock();
+        QWriteLocker locker(&listsLock);
 
         int index = p->hostsList.indexOf(host);
 
         if (index != -1) {
             // The host was found. Remove it.
-            p->hostsList.takeAt(index).clear();
+            p->unindexHost(host);
+            p->hostsList.removeAt(index);
             removed = true;
         } else {
             // Try harder to find the host.
-            HostPtr h = findHost(host->hostName(), host->workgroupName());
+            HostPtr h = findHostUnlocked(host->hostName(), host->workgroupName());
 
             if (h) {
                 index = p->hostsList.indexOf(h);
 
                 if (index != -1) {
-                    p->hostsList.takeAt(index).clear();
+                    p->unindexHost(h);
+                    p->hostsList.removeAt(index);
                     removed = true;
                 }
             }
 
             host.clear();
         }
-
-        mutex.unlock();
     }
 
     return removed;
@@ -254,57 +327,29 @@ bool Smb4KGlobal::removeHost(HostPtr host)
 
 void Smb4KGlobal::clearHostsList()
 {
-    mutex.lock();
-
-    while (!p->hostsList.isEmpty()) {
-        p->hostsList.takeFirst().clear();
-    }
+    QWriteLocker locker(&listsLock);
 
-    mutex.unlock();
+    p->hostsIndex.clear();
+    p->workgroupMembersIndex.clear();
+    p->hostsList.clear();
 }
 
 QList<HostPtr> Smb4KGlobal::workgroupMembers(WorkgroupPtr workgroup)
 {
-    QList<HostPtr> hosts;
-
-    mutex.lock();
-
-    for (const HostPtr &h : std::as_const(p->hostsList)) {
-        if (QString::compare(h->workgroupName(), workgroup->workgroupName(), Qt::CaseInsensitive) == 0) {
-            hosts << h;
-        }
-    }
-
-    mutex.unlock();
-
-    return hosts;
+    QReadLocker locker(&listsLock);
+    return p->workgroupMembersIndex.value(workgroup->workgroupName().toCaseFolded());
 }
 
-const QList<SharePtr> &Smb4KGlobal::sharesList()
+QList<SharePtr> Smb4KGlobal::sharesList()
 {
+    QReadLocker locker(&listsLock);
     return p->sharesList;
 }
 
 SharePtr Smb4KGlobal::findShare(const QUrl &url, const QString &workgroup)
 {
-    SharePtr share;
-
-    mutex.lock();
-
-    for (const SharePtr &s : std::as_const(p->sharesList)) {
-        if (QString::compare(s->url().toString(QUrl::RemoveUserInfo | QUrl::RemovePort),
-                             url.toString(QUrl::RemoveUserInfo | QUrl::RemovePort),
-                             Qt::CaseInsensitive)
-                == 0
-            && (workgroup.isEmpty() || QString::compare(s->workgroupName(), workgroup, Qt::CaseInsensitive) == 0)) {
-            share = s;
-            break;
-        }
-    }
-
-    mutex.unlock();
-
-    return share;
+    QReadLocker locker(&listsLock);
+    return findShareUnlocked(url, workgroup);
 }
 
 bool Smb4KGlobal::addShare(SharePtr share)
@@ -314,39 +359,26 @@ bool Smb4KGlobal::addShare(SharePtr share)
     bool added = false;
 
     if (share) {
-        mutex.lock();
+        QWriteLocker locker(&listsLock);
 
         //
         // Add the share
         //
-        if (!findShare(share->url(), share->workgroupName())) {
+        if (!findShareUnlocked(share->url(), share->workgroupName())) {
             //
             // Set the share mounted
-            // Only honor shares that are owned by the user
             //
-            QList<SharePtr> mountedShares = findShareByUrl(share->url());
-
-            if (!mountedShares.isEmpty()) {
-                for (const SharePtr &s : std::as_const(mountedShares)) {
-                    if (!s->isForeign()) {
-                        share->setMountData(s.data());
-                        break;
-                    } else {
-                        continue;
-                    }
-                }
-            }
+            copyMountDataUnlocked(share);
 
             //
             // Add it
             //
             p->sharesList.append(share);
+            p->indexShare(share);
             added = true;
         }
     }
 
-    mutex.unlock();
-
     return added;
 }
 
@@ -357,30 +389,18 @@ bool Smb4KGlobal::updateShare(SharePtr share)
     bool updated = false;
 
     if (share) {
-        mutex.lock();
+        QWriteLocker locker(&listsLock);
 
         //
         // Updated the share
         //
-        SharePtr existingShare = findShare(share->url(), share->workgroupName());
+        SharePtr existingShare = findShareUnlocked(share->url(), share->workgroupName());
 
         if (existingShare) {
             //
             // Set the share mounted
-            // Only honor shares that are owned by the user
             //
-            QList<SharePtr> mountedShares = findShareByUrl(share->url());
-
-            if (!mountedShares.isEmpty()) {
-                for (const SharePtr &s : std::as_const(mountedShares)) {
-                    if (!s->isForeign()) {
-                        share->setMountData(s.data());
-                        break;
-                    } else {
-                        continue;
-                    }
-                }
-            }
+            copyMountDataUnlocked(share);
 
             //
             // Update it
@@ -388,8 +408,6 @@ bool Smb4KGlobal::updateShare(SharePtr share)
             existingShare->update(share.data());
             updated = true;
         }
-
-        mutex.unlock();
     }
 
     return updated;
@@ -402,31 +420,31 @@ bool Smb4KGlobal::removeShare(SharePtr share)
     bool removed = false;
 
     if (share) {
-        mutex.lock();
+        QWriteLocker locker(&listsLock);
 
         int index = p->sharesList.indexOf(share);
 
         if (index != -1) {
             // The share was found. Remove it.
-            p->sharesList.takeAt(index).clear();
+            p->unindexShare(share);
+            p->sharesList.removeAt(index);
             removed = true;
         } else {
             // Try harder to find the share.
-            SharePtr s = findShare(share->url(), share->workgroupName());
+            SharePtr s = findShareUnlocked(share->url(), share->workgroupName());
 
             if (s) {
                 index = p->sharesList.indexOf(s);
 
                 if (index != -1) {
-                    p->sharesList.takeAt(index).clear();
+                    p->unindexShare(s);
+                    p->sharesList.removeAt(index);
                     removed = true;
                 }
             }
 
             share.clear();
         }
-
-        mutex.unlock();
     }
 
     return removed;
@@ -434,87 +452,42 @@ bool Smb4KGlobal::removeShare(SharePtr share)
 
 void Smb4KGlobal::clearSharesList()
 {
-    mutex.lock();
-
-    while (!p->sharesList.isEmpty()) {
-        p->sharesList.takeFirst().clear();
-    }
+    QWriteLocker locker(&listsLock);
 
-    mutex.unlock();
+    p->sharesIndex.clear();
+    p->sharedResourcesIndex.clear();
+    p->sharesList.clear();
 }
 
 QList<SharePtr> Smb4KGlobal::sharedResources(HostPtr host)
 {
-    QList<SharePtr> shares;
-
-    mutex.lock();
-
-    for (const SharePtr &s : std::as_const(p->sharesList)) {
-        if (QString::compare(s->hostName(), host->hostName(), Qt::CaseInsensitive) == 0
-            && QString::compare(s->workgroupName(), host->workgroupName(), Qt::CaseInsensitive) == 0) {
-            shares += s;
-        }
-    }
-
-    mutex.unlock();
-
-    return shares;
+    QReadLocker locker(&listsLock);
+    return p->sharedResourcesIndex.value(Smb4KGlobalPrivate::hostKey(host->hostName(), host->workgroupName()));
 }
 
-const QList<SharePtr> &Smb4KGlobal::mountedSharesList()
+QList<SharePtr> Smb4KGlobal::mountedSharesList()
 {
+    QReadLocker locker(&listsLock);
     return p->mountedSharesList;
 }
 
 SharePtr Smb4KGlobal::findShareByPath(const QString &path)
 {
-    SharePtr share;
-
-    mutex.lock();
-
-    if (!path.isEmpty() && !p->mountedSharesList.isEmpty()) {
-        for (const SharePtr &s : std::as_const(p->mountedSharesList)) {
-            if (QString::compare(s->path(), path, Qt::CaseInsensitive) == 0
-                || (!s->isInaccessible() && QString::compare(s->canonicalPath(), path, Qt::CaseInsensitive) == 0)) {
-                share = s;
-                break;
-            }
-        }
-    }
-
-    mutex.unlock();
-
-    return share;
+    QReadLocker locker(&listsLock);
+    return findShareByPathUnlocked(path);
 }
 
 QList<SharePtr> Smb4KGlobal::findShareByUrl(const QUrl &url)
 {
-    QList<SharePtr> shares;
-
-    mutex.lock();
-
-    if (!url.isEmpty() && url.isValid() && !p->mountedSharesList.isEmpty()) {
-        for (const SharePtr &s : std::as_const(p->mountedSharesList)) {
-            if (QString::compare(s->url().toString(QUrl::RemoveUserInfo | QUrl::RemovePort),
-                                 url.toString(QUrl::RemoveUserInfo | QUrl::RemovePort),
-                                 Qt::CaseInsensitive)
-                == 0) {
-                shares << s;
-                break;
-            }
-        }
-    }
-
-    mutex.unlock();
-
-    return shares;
+    QReadLocker locker(&listsLock);
+    return findShareByUrlUnlocked(url);
 }
 
 QList<SharePtr> Smb4KGlobal::findInaccessibleShares()
 {
     QList<SharePtr> inaccessibleShares;
 
-    mutex.lock();
+    QReadLocker locker(&listsLock);
 
     for (const SharePtr &s : std::as_const(p->mountedSharesList)) {
         if (s->isInaccessible()) {
@@ -522,8 +495,6 @@ QList<SharePtr> Smb4KGlobal::findInaccessibleShares()
         }
     }
 
-    mutex.unlock();
-
     return inaccessibleShares;
 }
 
@@ -534,7 +505,7 @@ bool Smb4KGlobal::addMountedShare(SharePtr share)
     bool added = false;
 
     if (share) {
-        mutex.lock();
+        QWriteLocker locker(&listsLock);
 
         //
         // Copy the mount data to the network share if available.
@@ -542,18 +513,18 @@ bool Smb4KGlobal::addMountedShare(SharePtr share)
         //
         if (!share->isForeign()) {
             // Network share
-            SharePtr networkShare = findShare(share->url(), share->workgroupName());
+            SharePtr networkShare = findShareUnlocked(share->url(), share->workgroupName());
 
             if (networkShare) {
                 networkShare->setMountData(share.data());
             }
         }
 
-        if (!findShareByPath(share->path())) {
+        if (!findShareByPathUnlocked(share->path())) {
             //
             // Check if we have to add a workgroup name and/or IP address
             //
-            HostPtr networkHost = findHost(share->hostName(), share->workgroupName());
+            HostPtr networkHost = findHostUnlocked(share->hostName(), share->workgroupName());
 
             if (networkHost) {
                 // Set the IP address
@@ -568,19 +539,11 @@ bool Smb4KGlobal::addMountedShare(SharePtr share)
             }
 
             p->mountedSharesList.append(share);
+            p->indexMountedShare(share);
             added = true;
 
-            p->onlyForeignShares = true;
-
-            for (const SharePtr &s : std::as_const(p->mountedSharesList)) {
-                if (!s->isForeign()) {
-                    p->onlyForeignShares = false;
-                    break;
-                }
-            }
+            updateOnlyForeignSharesUnlocked();
         }
-
-        mutex.unlock();
     }
 
     return added;
@@ -593,27 +556,27 @@ bool Smb4KGlobal::updateMountedShare(SharePtr share)
     bool updated = false;
 
     if (share) {
-        mutex.lock();
+        QWriteLocker locker(&listsLock);
 
         //
         // Copy the mount data to the network share (needed for unmounting from the network browser)
         // Only honor shares that were mounted by the user.
         //
         if (!share->isForeign()) {
-            SharePtr networkShare = findShare(share->url(), share->workgroupName());
+            SharePtr networkShare = findShareUnlocked(share->url(), share->workgroupName());
 
             if (networkShare) {
                 networkShare->setMountData(share.data());
             }
         }
 
-        SharePtr mountedShare = findShareByPath(share->path());
+        SharePtr mountedShare = findShareByPathUnlocked(share->path());
 
         if (mountedShare) {
             //
             // Check if we have to add a workgroup name and/or IP address
             //
-            HostPtr networkHost = findHost(share->hostName(), share->workgroupName());
+            HostPtr networkHost = findHostUnlocked(share->hostName(), share->workgroupName());
 
             if (networkHost) {
                 // Set the IP address
@@ -633,8 +596,6 @@ bool Smb4KGlobal::updateMountedShare(SharePtr share)
             mountedShare->setMountData(share.data());
             updated = true;
         }
-
-        mutex.unlock();
     }
 
     return updated;
@@ -647,11 +608,11 @@ bool Smb4KGlobal::removeMountedShare(SharePtr share, bool takeOnly)
     bool removed = false;
 
     if (share) {
-        mutex.lock();
+        QWriteLocker locker(&listsLock);
 
         // Reset the mount data for the _network share_
         if (!share->isForeign()) {
-            SharePtr networkShare = findShare(share->url(), share->workgroupName());
+            SharePtr networkShare = findShareUnlocked(share->url(), share->workgroupName());
 
             if (networkShare) {
                 networkShare->resetMountData();
@@ -661,16 +622,18 @@ bool Smb4KGlobal::removeMountedShare(SharePtr share, bool takeOnly)
         int index = p->mountedSharesList.indexOf(share);
 
         if (index != -1) {
-            p->mountedSharesList.takeAt(index);
+            p->unindexMountedShare(share);
+            p->mountedSharesList.removeAt(index);
             removed = true;
         } else {
-            SharePtr s = findShareByPath(share->isInaccessible() ? share->path() : share->canonicalPath());
+            SharePtr s = findShareByPathUnlocked(share->isInaccessible() ? share->path() : share->canonicalPath());
 
             if (s) {
                 index = p->mountedSharesList.indexOf(s);
 
                 if (index != -1) {
-                    p->mountedSharesList.takeAt(index).clear();
+                    p->unindexMountedShare(s);
+                    p->mountedSharesList.removeAt(index);
                     removed = true;
                 }
             }
@@ -680,14 +643,7 @@ bool Smb4KGlobal::removeMountedShare(SharePtr share, bool takeOnly)
             share.clear();
         }
 
-        for (const SharePtr &s : std::as_const(p->mountedSharesList)) {
-            if (!s->isForeign()) {
-                p->onlyForeignShares = false;
-                break;
-            }
-        }
-
-        mutex.unlock();
+        updateOnlyForeignSharesUnlocked();
     }
 
     return removed;
@@ -695,6 +651,7 @@ bool Smb4KGlobal::removeMountedShare(SharePtr share, bool takeOnly)
 
 bool Smb4KGlobal::onlyForeignMountedShares()
 {
+    QReadLocker locker(&listsLock);
     return p->onlyForeignShares;
 }
 
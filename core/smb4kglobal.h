@@ -51,12 +51,13 @@ typedef QSharedPointer<Smb4KCustomSettings> CustomSettingsPtr;
 namespace Smb4KGlobal
 {
 /**
- * This function returns the global list of workgroups that were discovered by
- * Smb4K. Use this if you want to access and modify the list with your code.
+ * This function returns a snapshot of the global list of workgroups that were
+ * discovered by Smb4K. The snapshot is cheap to get and is not affected by later
+ * modifications of the global list, so it can safely be used from any thread.
  *
  * @returns the global list of known workgroups.
  */
-SMB4KCORE_EXPORT const QList<WorkgroupPtr> &workgroupsList();
+SMB4KCORE_EXPORT QList<WorkgroupPtr> workgroupsList();
 
 /**
  * This function returns the workgroup or domain that matches the name @p name or
@@ -110,12 +111,13 @@ SMB4KCORE_EXPORT bool removeWorkgroup(WorkgroupPtr workgroup);
 SMB4KCORE_EXPORT void clearWorkgroupsList();
 
 /**
- * This function returns the global list of hosts that were discovered by
- * Smb4K. Use this if you want to access and modify the list with your code.
+ * This function returns a snapshot of the global list of hosts that were
+ * discovered by Smb4K. The snapshot is cheap to get and is not affected by later
+ * modifications of the global list, so it can safely be used from any thread.
  *
  * @returns the global list of known hosts.
  */
-SMB4KCORE_EXPORT const QList<HostPtr> &hostsList();
+SMB4KCORE_EXPORT QList<HostPtr> hostsList();
 
 /**
  * This function returns the host matching the name @p name or NULL if there is no
@@ -186,12 +188,13 @@ SMB4KCORE_EXPORT void clearHostsList();
 SMB4KCORE_EXPORT QList<HostPtr> workgroupMembers(WorkgroupPtr workgroup);
 
 /**
- * This function returns the list of shares that were discovered by Smb4K.
- * Use this if you want to access and modify the list with your code.
+ * This function returns a snapshot of the list of shares that were discovered
+ * by Smb4K. The snapshot is cheap to get and is not affected by later modifications
+ * of the global list, so it can safely be used from any thread.
  *
  * @returns the global list of known shares.
  */
-SMB4KCORE_EXPORT const QList<SharePtr> &sharesList();
+SMB4KCORE_EXPORT QList<SharePtr> sharesList();
 
 /**
  * This function returns the share with URL @p url located in the workgroup or
@@ -262,12 +265,13 @@ SMB4KCORE_EXPORT void clearSharesList();
 SMB4KCORE_EXPORT QList<SharePtr> sharedResources(HostPtr host);
 
 /**
- * This function returns the global list of mounted shares that were discovered by
- * Smb4K. Use this if you want to access and modify the list with your code.
+ * This function returns a snapshot of the global list of mounted shares that were
+ * discovered by Smb4K. The snapshot is cheap to get and is not affected by later
+ * modifications of the global list, so it can safely be used from any thread.
  *
  * @returns the global list of known mounted shares.
  */
-SMB4KCORE_EXPORT const QList<SharePtr> &mountedSharesList();
+SMB4KCORE_EXPORT QList<SharePtr> mountedSharesList();
 
 /**
  * Find a mounted share by its path (i.e. mount point).
@@ -14,6 +14,7 @@
 
 // Qt includes
 #include <QCoreApplication>
+#include <QUrl>
 
 Smb4KGlobalPrivate::Smb4KGlobalPrivate()
 {
@@ -78,6 +79,130 @@ Smb4KGlobalPrivate::~Smb4KGlobalPrivate()
     }
 }
 
+void Smb4KGlobalPrivate::indexWorkgroup(const QSharedPointer<Smb4KWorkgroup> &workgroup)
+{
+    workgroupsIndex.insert(workgroup->workgroupName().toCaseFolded(), workgroup);
+}
+
+void Smb4KGlobalPrivate::unindexWorkgroup(const QSharedPointer<Smb4KWorkgroup> &workgroup)
+{
+    QString key = workgroup->workgroupName().toCaseFolded();
+
+    if (workgroupsIndex.value(key) == workgroup) {
+        workgroupsIndex.remove(key);
+    }
+}
+
+void Smb4KGlobalPrivate::indexHost(const QSharedPointer<Smb4KHost> &host)
+{
+    hostsIndex[host->hostName().toCaseFolded()].append(host);
+    workgroupMembersIndex[host->workgroupName().toCaseFolded()].append(host);
+}
+
+void Smb4KGlobalPrivate::unindexHost(const QSharedPointer<Smb4KHost> &host)
+{
+    QString nameKey = host->hostName().toCaseFolded();
+    QString workgroupKey = host->workgroupName().toCaseFolded();
+
+    auto hostIt = hostsIndex.find(nameKey);
+
+    if (hostIt != hostsIndex.end()) {
+        hostIt->removeOne(host);
+
+        if (hostIt->isEmpty()) {
+            hostsIndex.erase(hostIt);
+        }
+    }
+
+    auto membersIt = workgroupMembersIndex.find(workgroupKey);
+
+    if (membersIt != workgroupMembersIndex.end()) {
+        membersIt->removeOne(host);
+
+        if (membersIt->isEmpty()) {
+            workgroupMembersIndex.erase(membersIt);
+        }
+    }
+}
+
+void Smb4KGlobalPrivate::indexShare(const QSharedPointer<Smb4KShare> &share)
+{
+    sharesIndex[urlKey(share->url())].append(share);
+    sharedResourcesIndex[hostKey(share->hostName(), share->workgroupName())].append(share);
+}
+
+void Smb4KGlobalPrivate::unindexShare(const QSharedPointer<Smb4KShare> &share)
+{
+    auto shareIt = sharesIndex.find(urlKey(share->url()));
+
+    if (shareIt != sharesIndex.end()) {
+        shareIt->removeOne(share);
+
+        if (shareIt->isEmpty()) {
+            sharesIndex.erase(shareIt);
+        }
+    }
+
+    auto resourcesIt = sharedResourcesIndex.find(hostKey(share->hostName(), share->workgroupName()));
+
+    if (resourcesIt != sharedResourcesIndex.end()) {
+        resourcesIt->removeOne(share);
+
+        if (resourcesIt->isEmpty()) {
+            sharedResourcesIndex.erase(resourcesIt);
+        }
+    }
+}
+
+void Smb4KGlobalPrivate::indexMountedShare(const QSharedPointer<Smb4KShare> &share)
+{
+    mountedSharesPathIndex.insert(share->path().toCaseFolded(), share);
+    mountedSharesUrlIndex[urlKey(share->url())].append(share);
+
+    //
+    // Resolving the canonical path requires a system call, so only
+    // do it once when the share is added.
+    //
+    QString canonicalPathKey = share->canonicalPath().toCaseFolded();
+    mountedSharesCanonicalPathIndex.insert(canonicalPathKey, share);
+    mountedSharesCanonicalPathKeys.insert(share.data(), canonicalPathKey);
+}
+
+void Smb4KGlobalPrivate::unindexMountedShare(const QSharedPointer<Smb4KShare> &share)
+{
+    QString pathKey = share->path().toCaseFolded();
+
+    if (mountedSharesPathIndex.value(pathKey) == share) {
+        mountedSharesPathIndex.remove(pathKey);
+    }
+
+    QString canonicalPathKey = mountedSharesCanonicalPathKeys.take(share.data());
+
+    if (mountedSharesCanonicalPathIndex.value(canonicalPathKey) == share) {
+        mountedSharesCanonicalPathIndex.remove(canonicalPathKey);
+    }
+
+    auto urlIt = mountedSharesUrlIndex.find(urlKey(share->url()));
+
+    if (urlIt != mountedSharesUrlIndex.end()) {
+        urlIt->removeOne(share);
+
+        if (urlIt->isEmpty()) {
+            mountedSharesUrlIndex.erase(urlIt);
+        }
+    }
+}
+
+QString Smb4KGlobalPrivate::urlKey(const QUrl &url)
+{
+    return url.toString(QUrl::RemoveUserInfo | QUrl::RemovePort).toCaseFolded();
+}
+
+QString Smb4KGlobalPrivate::hostKey(const QString &hostName, const QString &workgroupName)
+{
+    return workgroupName.toCaseFolded() + QStringLiteral("/") + hostName.toCaseFolded();
+}
+
 void Smb4KGlobalPrivate::slotAboutToQuit()
 {
     Smb4KSettings::self()->save();
@@ -14,6 +14,7 @@
 #include "smb4kworkgroup.h"
 
 // Qt includes
+#include <QHash>
 #include <QList>
 #include <QObject>
 #include <QSharedPointer>
@@ -59,6 +60,102 @@ public:
      */
     QList<QSharedPointer<Smb4KShare>> sharesList;
 
+    /**
+     * Index of the workgroups. The key is the case-folded workgroup name.
+     */
+    QHash<QString, QSharedPointer<Smb4KWorkgroup>> workgroupsIndex;
+
+    /**
+     * Index of the hosts. The key is the case-folded host name.
+     */
+    QHash<QString, QList<QSharedPointer<Smb4KHost>>> hostsIndex;
+
+    /**
+     * Index of the workgroup members. The key is the case-folded workgroup name.
+     */
+    QHash<QString, QList<QSharedPointer<Smb4KHost>>> workgroupMembersIndex;
+
+    /**
+     * Index of the shares. The key is the case-folded URL without user info and port.
+     */
+    QHash<QString, QList<QSharedPointer<Smb4KShare>>> sharesIndex;
+
+    /**
+     * Index of the shared resources of a host. The key is composed of the
+     * case-folded workgroup and host name.
+     */
+    QHash<QString, QList<QSharedPointer<Smb4KShare>>> sharedResourcesIndex;
+
+    /**
+     * Index of the mounted shares. The key is the case-folded mount point.
+     */
+    QHash<QString, QSharedPointer<Smb4KShare>> mountedSharesPathIndex;
+
+    /**
+     * Index of the mounted shares. The key is the case-folded canonical mount point.
+     */
+    QHash<QString, QSharedPointer<Smb4KShare>> mountedSharesCanonicalPathIndex;
+
+    /**
+     * Index of the mounted shares. The key is the case-folded URL without user info and port.
+     */
+    QHash<QString, QList<QSharedPointer<Smb4KShare>>> mountedSharesUrlIndex;
+
+    /**
+     * The keys of the canonical mount points the mounted shares were indexed with
+     */
+    QHash<Smb4KShare *, QString> mountedSharesCanonicalPathKeys;
+
+    /**
+     * Add the workgroup to the index
+     */
+    void indexWorkgroup(const QSharedPointer<Smb4KWorkgroup> &workgroup);
+
+    /**
+     * Remove the workgroup from the index
+     */
+    void unindexWorkgroup(const QSharedPointer<Smb4KWorkgroup> &workgroup);
+
+    /**
+     * Add the host to the indexes
+     */
+    void indexHost(const QSharedPointer<Smb4KHost> &host);
+
+    /**
+     * Remove the host from the indexes
+     */
+    void unindexHost(const QSharedPointer<Smb4KHost> &host);
+
+    /**
+     * Add the share to the indexes
+     */
+    void indexShare(const QSharedPointer<Smb4KShare> &share);
+
+    /**
+     * Remove the share from the indexes
+     */
+    void unindexShare(const QSharedPointer<Smb4KShare> &share);
+
+    /**
+     * Add the mounted share to the indexes
+     */
+    void indexMountedShare(const QSharedPointer<Smb4KShare> &share);
+
+    /**
+     * Remove the mounted share from the indexes
+     */
+    void unindexMountedShare(const QSharedPointer<Smb4KShare> &share);
+
+    /**
+     * Returns the key for the URL @p url used by the share indexes
+     */
+    static QString urlKey(const QUrl &url);
+
+    /**
+     * Returns the key for the host @p hostName in workgroup @p workgroupName
+     */
+    static QString hostKey(const QString &hostName, const QString &workgroupName);
+
     /**
      * Boolean that is TRUE when only foreign shares
      * are in the list of mounted shares
@@ -7,9 +7,15 @@
 
 // application specific includes
 #include "smb4khardwareinterface.h"
+#include "smb4kmounttable.h"
 
 // system includes
 #include <unistd.h>
+#if defined(Q_OS_LINUX)
+#include <linux/netlink.h>
+#include <linux/rtnetlink.h>
+#include <sys/socket.h>
+#endif
 
 // Qt includes
 #if (QT_VERSION >= QT_VERSION_CHECK(6, 8, 0))
@@ -24,6 +30,7 @@
 #include <QDBusUnixFileDescriptor>
 #include <QDebug>
 #include <QNetworkInterface>
+#include <QSocketNotifier>
 #include <QString>
 #include <QStringList>
 #include <QTimer>
@@ -45,8 +52,24 @@ public:
     bool initialImportDone;
     QStringList udis;
     int timerId;
+    int netlinkSocket;
+    QSocketNotifier *netlinkNotifier;
+    QTimer onlineCheckTimer;
 };
 
+//
+// Delay between a change of the network interfaces reported by the kernel
+// and the check of the online state (in ms). Changes usually arrive in
+// bursts.
+//
+#define ONLINE_CHECK_DELAY 50
+
+//
+// Interval of the online check, if the kernel cannot report changes of
+// the network interfaces (in ms)
+//
+#define ONLINE_CHECK_INTERVAL 1000
+
 class Smb4KHardwareInterfaceStatic
 {
 public:
@@ -64,6 +87,8 @@ Smb4KHardwareInterface::Smb4KHardwareInterface(QObject *parent)
     d->initialImportDone = false;
     d->fileDescriptor.setFileDescriptor(-1);
     d->timerId = -1;
+    d->netlinkSocket = -1;
+    d->netlinkNotifier = nullptr;
 
     //
     // Set up the DBUS interface
@@ -92,10 +117,22 @@ Smb4KHardwareInterface::Smb4KHardwareInterface(QObject *parent)
     }
 
     //
-    // Check the online state
+    // Check the online state and watch for changes of the network
+    // interfaces
     //
     checkOnlineState(false);
 
+    d->onlineCheckTimer.setSingleShot(true);
+    d->onlineCheckTimer.setInterval(ONLINE_CHECK_DELAY);
+
+    connect(&d->onlineCheckTimer, &QTimer::timeout, this, [this]() {
+        if (!d->systemSleep) {
+            checkOnlineState();
+        }
+    });
+
+    watchNetworkInterfaces();
+
     //
     // Get the initial list of CIFS/SMB3/SMBFS shares mounted
     // on the system and then start the timer.
@@ -115,7 +152,10 @@ Smb4KHardwareInterface::Smb4KHardwareInterface(QObject *parent)
         }
 
         d->initialImportDone = true;
-        d->timerId = startTimer(1000);
+
+        if (d->netlinkSocket == -1) {
+            d->timerId = startTimer(ONLINE_CHECK_INTERVAL);
+        }
     });
 
     connect(Solid::DeviceNotifier::instance(), &Solid::DeviceNotifier::deviceAdded, this, &Smb4KHardwareInterface::slotDeviceAdded);
@@ -124,6 +164,9 @@ Smb4KHardwareInterface::Smb4KHardwareInterface(QObject *parent)
 
 Smb4KHardwareInterface::~Smb4KHardwareInterface()
 {
+    if (d->netlinkSocket != -1) {
+        close(d->netlinkSocket);
+    }
 }
 
 Smb4KHardwareInterface *Smb4KHardwareInterface::self()
@@ -136,6 +179,11 @@ bool Smb4KHardwareInterface::isOnline() const
     return d->systemOnline;
 }
 
+bool Smb4KHardwareInterface::isSystemSleeping() const
+{
+    return d->systemSleep;
+}
+
 void Smb4KHardwareInterface::inhibit()
 {
     if (d->fileDescriptor.isValid()) {
@@ -190,6 +238,42 @@ void Smb4KHardwareInterface::checkOnlineState(bool emitSignal)
     }
 }
 
+void Smb4KHardwareInterface::watchNetworkInterfaces()
+{
+#if defined(Q_OS_LINUX)
+    //
+    // Subscribe to the link and address changes reported by the kernel
+    //
+    d->netlinkSocket = socket(AF_NETLINK, SOCK_RAW | SOCK_CLOEXEC | SOCK_NONBLOCK, NETLINK_ROUTE);
+
+    if (d->netlinkSocket == -1) {
+        return;
+    }
+
+    struct sockaddr_nl address = {};
+    address.nl_family = AF_NETLINK;
+    address.nl_groups = RTMGRP_LINK | RTMGRP_IPV4_IFADDR | RTMGRP_IPV6_IFADDR;
+
+    if (bind(d->netlinkSocket, reinterpret_cast<struct sockaddr *>(&address), sizeof(address)) == -1) {
+        close(d->netlinkSocket);
+        d->netlinkSocket = -1;
+        return;
+    }
+
+    d->netlinkNotifier = new QSocketNotifier(d->netlinkSocket, QSocketNotifier::Read, this);
+
+    connect(d->netlinkNotifier, &QSocketNotifier::activated, this, [this]() {
+        // The messages themselves are not needed, only the fact that something changed
+        char buffer[8192];
+
+        while (recv(d->netlinkSocket, buffer, sizeof(buffer), MSG_DONTWAIT) > 0) {
+        }
+
+        d->onlineCheckTimer.start();
+    });
+#endif
+}
+
 bool Smb4KHardwareInterface::initialImportDone() const
 {
     return d->initialImportDone;
@@ -197,13 +281,7 @@ bool Smb4KHardwareInterface::initialImportDone() const
 
 QStringList Smb4KHardwareInterface::allMountPoints() const
 {
-    QStringList mountPoints;
-
-    for (const QString &udi : std::as_const(d->udis)) {
-        mountPoints << udi.section(QStringLiteral(":"), -1, -1).trimmed();
-    }
-
-    return mountPoints;
+    return Smb4KMountTable::self()->networkShareMountPoints();
 }
 
 void Smb4KHardwareInterface::timerEvent(QTimerEvent *event)
@@ -220,6 +298,7 @@ void Smb4KHardwareInterface::slotDeviceAdded(const QString &udi)
     const Solid::NetworkShare *networkShare = qobject_cast<const Solid::NetworkShare *>(iface);
 
     if (networkShare && (networkShare->type() == Solid::NetworkShare::Cifs || networkShare->type() == Solid::NetworkShare::Smb3)) {
+        Smb4KMountTable::self()->invalidate();
         d->udis << udi;
         QString mountpoint = udi.section(QStringLiteral(":"), -1, -1).trimmed();
         Q_EMIT networkShareAdded(mountpoint);
@@ -229,6 +308,7 @@ void Smb4KHardwareInterface::slotDeviceAdded(const QString &udi)
 void Smb4KHardwareInterface::slotDeviceRemoved(const QString &udi)
 {
     if (d->udis.contains(udi)) {
+        Smb4KMountTable::self()->invalidate();
         QString mountpoint = udi.section(QStringLiteral(":"), -1, -1).trimmed();
         Q_EMIT networkShareRemoved(mountpoint);
         d->udis.removeOne(udi);
@@ -241,8 +321,11 @@ void Smb4KHardwareInterface::slotSystemSleep(bool sleep)
     d->systemSleep = sleep;
 
     if (d->systemSleep) {
-        killTimer(d->timerId);
-        d->timerId = -1;
+        if (d->timerId != -1) {
+            killTimer(d->timerId);
+            d->timerId = -1;
+        }
+
         // The system will recover after a shutdown completely, so we
         // do not have the trigger any unmounts by emitting a signal
         // here. However, we will awake from a sleep later, so some things
@@ -250,8 +333,14 @@ void Smb4KHardwareInterface::slotSystemSleep(bool sleep)
         // signal.
         d->systemOnline = false;
     } else {
-        d->timerId = startTimer(1000);
+        if (d->netlinkSocket != -1) {
+            d->onlineCheckTimer.start();
+        } else {
+            d->timerId = startTimer(ONLINE_CHECK_INTERVAL);
+        }
     }
 
+    Q_EMIT systemSleepStateChanged(d->systemSleep);
+
     uninhibit();
 }
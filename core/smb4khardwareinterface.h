@@ -55,6 +55,14 @@ public:
      */
     bool isOnline() const;
 
+    /**
+     * This function returns TRUE if the system is about to enter or is
+     * in a sleep state and FALSE otherwise.
+     *
+     * @returns TRUE if the system is asleep.
+     */
+    bool isSystemSleeping() const;
+
     /**
      * Inhibit shutdown and sleep.
      */
@@ -83,9 +91,9 @@ public:
 
 protected:
     /**
-     * Reimplemented from QObject to check the online state and to check
-     * for mounts and unmounts on operating systems that are not fully
-     * supported by Solid, yet.
+     * Reimplemented from QObject to check the online state periodically
+     * on operating systems where the kernel does not report changes of
+     * the network interfaces.
      */
     void timerEvent(QTimerEvent *event) override;
 
@@ -110,6 +118,13 @@ Q_SIGNALS:
      */
     void onlineStateChanged(bool online);
 
+    /**
+     * This signal is emitted when the system prepares for sleep or has
+     * been woken up.
+     * @param sleep     TRUE if the system is about to enter a sleep state
+     */
+    void systemSleepStateChanged(bool sleep);
+
 protected Q_SLOTS:
     /**
      * This slot is called when a device was added to the system.
@@ -139,6 +154,12 @@ private:
      */
     void checkOnlineState(bool emitSignal = true);
 
+    /**
+     * Watch for changes of the network interfaces reported by the kernel.
+     * The online state is then only checked when something changed.
+     */
+    void watchNetworkInterfaces();
+
     /**
      * Pointer to private class
      */
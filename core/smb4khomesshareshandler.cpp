@@ -1,7 +1,7 @@
 /*
     This class handles the homes shares
 
-    SPDX-FileCopyrightText: 2006-2025 Alexander Reinholdt <alexander.reinholdt@kdemail.net>
+    SPDX-FileCopyrightText: 2006-2026 Alexander Reinholdt <alexander.reinholdt@kdemail.net>
     SPDX-License-Identifier: GPL-2.0-or-later
 */
 
@@ -11,6 +11,7 @@
 #include "smb4kprofilemanager.h"
 #include "smb4ksettings.h"
 #include "smb4kshare.h"
+#include "smb4kwritescheduler.h"
 
 // Qt includes
 #if (QT_VERSION >= QT_VERSION_CHECK(6, 8, 0))
@@ -19,6 +20,7 @@
 #include <qapplicationstatic.h>
 #endif
 #include <QFile>
+#include <QSaveFile>
 #include <QXmlStreamReader>
 #include <QXmlStreamWriter>
 
@@ -102,6 +104,7 @@ class Smb4KHomesSharesHandlerPrivate
 {
 public:
     QList<Smb4KHomesUsers *> homesUsers;
+    Smb4KWriteScheduler writeScheduler;
 };
 
 class Smb4KHomesSharesHandlerStatic
@@ -126,10 +129,14 @@ Smb4KHomesSharesHandler::Smb4KHomesSharesHandler(QObject *parent)
     }
 
     readUserNames();
+
+    connect(&d->writeScheduler, &Smb4KWriteScheduler::write, this, &Smb4KHomesSharesHandler::writeUserNames);
 }
 
 Smb4KHomesSharesHandler::~Smb4KHomesSharesHandler()
 {
+    d->writeScheduler.flush();
+
     while (!d->homesUsers.isEmpty()) {
         delete d->homesUsers.takeFirst();
     }
@@ -190,7 +197,7 @@ void Smb4KHomesSharesHandler::addHomesUsers(const SharePtr &share, const QString
         d->homesUsers << users;
     }
 
-    writeUserNames();
+    d->writeScheduler.schedule();
 }
 
 void Smb4KHomesSharesHandler::readUserNames()
@@ -309,9 +316,15 @@ void Smb4KHomesSharesHandler::readUserNames()
 void Smb4KHomesSharesHandler::writeUserNames()
 {
     // FIXME: Use the workgroup at all? We really only need the URL.
-    QFile xmlFile(dataLocation() + QDir::separator() + QStringLiteral("homes_shares.xml"));
+    QString fileName = dataLocation() + QDir::separator() + QStringLiteral("homes_shares.xml");
 
     if (!d->homesUsers.isEmpty()) {
+        //
+        // Write to a temporary file first, so that an interrupted write
+        // does not destroy the user names
+        //
+        QSaveFile xmlFile(fileName);
+
         if (xmlFile.open(QIODevice::WriteOnly | QIODevice::Text)) {
             QXmlStreamWriter xmlWriter(&xmlFile);
             xmlWriter.setAutoFormatting(true);
@@ -337,12 +350,15 @@ void Smb4KHomesSharesHandler::writeUserNames()
             }
 
             xmlWriter.writeEndDocument();
-            xmlFile.close();
+
+            if (!xmlFile.commit()) {
+                Smb4KNotification::openingFileFailed(xmlFile);
+            }
         } else {
             Smb4KNotification::openingFileFailed(xmlFile);
         }
     } else {
-        xmlFile.remove();
+        QFile::remove(fileName);
     }
 }
 
@@ -362,7 +378,7 @@ void Smb4KHomesSharesHandler::slotProfileRemoved(const QString &name)
         }
     }
 
-    writeUserNames();
+    d->writeScheduler.schedule();
 }
 
 void Smb4KHomesSharesHandler::slotProfileMigrated(const QString &oldName, const QString &newName)
@@ -373,5 +389,5 @@ void Smb4KHomesSharesHandler::slotProfileMigrated(const QString &oldName, const
         }
     }
 
-    writeUserNames();
+    d->writeScheduler.schedule();
 }
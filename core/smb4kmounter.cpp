@@ -12,10 +12,13 @@
 #include "smb4kcustomsettingsmanager.h"
 #include "smb4khardwareinterface.h"
 #include "smb4khomesshareshandler.h"
+#include "smb4kmounttable.h"
 #include "smb4knotification.h"
 #include "smb4kprofilemanager.h"
+#include "smb4kserverprober.h"
 #include "smb4ksettings.h"
 #include "smb4kshare.h"
+#include "smb4kwakeonlan.h"
 
 #if defined(Q_OS_LINUX)
 #include "smb4kmountsettings_linux.h"
@@ -34,19 +37,22 @@
 #include <qapplicationstatic.h>
 #endif
 #include <QDBusUnixFileDescriptor>
+#include <QDeadlineTimer>
 #include <QDebug>
 #include <QDir>
 #include <QFile>
 #include <QFileInfo>
+#include <QHash>
+#include <QMutex>
+#include <QSet>
+#include <QSharedPointer>
 #include <QStorageInfo>
-#include <QTcpSocket>
+#include <QThreadPool>
 #include <QTimer>
-#include <QUdpSocket>
 
 // KDE includes
 #include <KAuth/ExecuteJob>
 #include <KLocalizedString>
-#include <KMountPoint>
 #include <KShell>
 #include <KUser>
 #include <kauth_version.h>
@@ -55,6 +61,56 @@ using namespace Smb4KGlobal;
 
 const static int timeoutIncrement = 50;
 
+//
+// The mounted shares are checked with an adaptive interval between
+// MIN_CHECK_INTERVAL and MAX_CHECK_INTERVAL. A check that did not finish
+// after CHECK_TIMEOUT marks the share as inaccessible.
+//
+#define MIN_CHECK_INTERVAL 2500
+#define MAX_CHECK_INTERVAL 40000
+#define CHECK_TIMEOUT 10000
+#define MAX_CONCURRENT_CHECKS 8
+
+class Smb4KMountCheckResult
+{
+public:
+    bool accessible = false;
+    qint64 freeDiskSpace = 0;
+    qint64 totalDiskSpace = 0;
+    K_UID userId = 0;
+    K_GID groupId = 0;
+};
+
+class Smb4KMountCheck
+{
+public:
+    int interval = MIN_CHECK_INTERVAL;
+    QDeadlineTimer nextCheck = QDeadlineTimer(0);
+    QDeadlineTimer timeout;
+    bool running = false;
+};
+
+//
+// The checks of the mounted shares might block forever, so they are not
+// waited for when the application quits. The guard tells the checks that
+// are still running whether they may report their result.
+//
+class Smb4KMountCheckGuard
+{
+public:
+    QMutex mutex;
+    bool active = true;
+};
+
+class Smb4KPendingMount
+{
+public:
+    SharePtr share;
+    QString mountPoint;
+    QVariantMap arguments;
+    int fileDescriptor = -1;
+};
+
 class Smb4KMounterPrivate
 {
 public:
@@ -68,11 +124,80 @@ public:
     QList<SharePtr> remounts;
     bool detectAllShares;
     bool longActionRunning;
-    QStorageInfo storageInfo;
-    QUdpSocket udpSocket;
-    QTcpSocket tcpSocket;
+    QHash<QString, Smb4KMountCheck> checks;
+    QHash<QString, QList<SharePtr>> remountCandidates;
+    QHash<QString, QList<Smb4KPendingMount>> mountQueues;
+    QStringList mountQueueOrder;
+    QSet<QString> busyServers;
+    QSet<QString> pendingMountPoints;
+    int runningMounts;
+    bool mountBatchRunning;
+    QHash<QString, QList<Smb4KPendingMount>> wakingMounts;
+    QThreadPool *checkPool;
+    QSharedPointer<Smb4KMountCheckGuard> checkGuard;
 };
 
+//
+// Query the file system mounted at @p path. This function blocks if the
+// server does not respond, so it is run on the check pool.
+//
+static Smb4KMountCheckResult probeMountPoint(const QString &path)
+{
+    Smb4KMountCheckResult result;
+    result.userId = getuid();
+    result.groupId = getgid();
+
+    QStorageInfo storageInfo(path);
+
+    if (storageInfo.isValid() && storageInfo.isReady()) {
+        result.accessible = true;
+        result.freeDiskSpace = storageInfo.bytesAvailable(); // Bytes available to the user, might be less than bytesFree()
+        result.totalDiskSpace = storageInfo.bytesTotal();
+
+        QFileInfo fileInfo(path);
+        fileInfo.setCaching(false);
+
+        if (fileInfo.exists()) {
+            result.userId = static_cast<K_UID>(fileInfo.ownerId());
+            result.groupId = static_cast<K_GID>(fileInfo.groupId());
+        }
+    }
+
+    return result;
+}
+
+//
+// Apply the result of a check to the share. Returns TRUE if the share changed.
+//
+static bool applyMountCheckResult(const SharePtr &share, const Smb4KMountCheckResult &result)
+{
+    bool changed = false;
+
+    if (share->isInaccessible() == result.accessible) {
+        share->setInaccessible(!result.accessible);
+        changed = true;
+    }
+
+    if (share->freeDiskSpace() != result.freeDiskSpace || share->totalDiskSpace() != result.totalDiskSpace) {
+        share->setFreeDiskSpace(result.freeDiskSpace);
+        share->setTotalDiskSpace(result.totalDiskSpace);
+        changed = true;
+    }
+
+    // Only look up the user and group if the IDs changed
+    if (!share->user().isValid() || share->user().userId().nativeId() != result.userId) {
+        share->setUser(KUser(result.userId));
+        changed = true;
+    }
+
+    if (!share->group().isValid() || share->group().groupId().nativeId() != result.groupId) {
+        share->setGroup(KUserGroup(result.groupId));
+        changed = true;
+    }
+
+    return changed;
+}
+
 class Smb4KMounterStatic
 {
 public:
@@ -94,7 +219,14 @@ Smb4KMounter::Smb4KMounter(QObject *parent)
     d->remountAttempts = 0;
     d->checkTimeout = 0;
     d->longActionRunning = false;
+    d->runningMounts = 0;
+    d->mountBatchRunning = false;
     d->detectAllShares = Smb4KMountSettings::detectAllShares();
+    // The pool is never deleted, because its destructor would wait for
+    // checks that hang on unresponsive servers
+    d->checkPool = new QThreadPool();
+    d->checkPool->setMaxThreadCount(MAX_CONCURRENT_CHECKS);
+    d->checkGuard = QSharedPointer<Smb4KMountCheckGuard>::create();
 
     connect(Smb4KProfileManager::self(), &Smb4KProfileManager::aboutToChangeProfile, this, &Smb4KMounter::slotAboutToChangeProfile);
     connect(Smb4KProfileManager::self(), &Smb4KProfileManager::activeProfileChanged, this, &Smb4KMounter::slotActiveProfileChanged);
@@ -102,6 +234,8 @@ Smb4KMounter::Smb4KMounter(QObject *parent)
     connect(Smb4KMountSettings::self(), &Smb4KMountSettings::configChanged, this, &Smb4KMounter::slotConfigChanged);
 
     connect(Smb4KHardwareInterface::self(), &Smb4KHardwareInterface::onlineStateChanged, this, &Smb4KMounter::slotOnlineStateChanged);
+    connect(Smb4KServerProber::self(), &Smb4KServerProber::probed, this, &Smb4KMounter::slotServerProbed);
+    connect(Smb4KWakeOnLan::self(), &Smb4KWakeOnLan::wokenUp, this, &Smb4KMounter::slotHostWokenUp);
     connect(Smb4KHardwareInterface::self(), &Smb4KHardwareInterface::networkShareAdded, this, &Smb4KMounter::slotShareMounted);
     connect(Smb4KHardwareInterface::self(), &Smb4KHardwareInterface::networkShareRemoved, this, &Smb4KMounter::slotShareUnmounted);
 
@@ -110,6 +244,10 @@ Smb4KMounter::Smb4KMounter(QObject *parent)
 
 Smb4KMounter::~Smb4KMounter()
 {
+    d->checkGuard->mutex.lock();
+    d->checkGuard->active = false;
+    d->checkGuard->mutex.unlock();
+
     while (!d->newlyMounted.isEmpty()) {
         d->newlyMounted.takeFirst().clear();
     }
@@ -138,16 +276,52 @@ void Smb4KMounter::abort()
         return;
     }
 
+    // Drop the mounts that have not been started yet
+    for (const QList<Smb4KPendingMount> &queue : std::as_const(d->mountQueues)) {
+        for (const Smb4KPendingMount &pendingMount : queue) {
+            if (pendingMount.fileDescriptor >= 0) {
+                close(pendingMount.fileDescriptor);
+            }
+
+            d->pendingMountPoints.remove(pendingMount.mountPoint);
+        }
+    }
+
+    d->mountQueues.clear();
+    d->mountQueueOrder.clear();
+
+    // Do not wait for sleeping servers anymore
+    if (!d->wakingMounts.isEmpty()) {
+        for (const QList<Smb4KPendingMount> &mounts : std::as_const(d->wakingMounts)) {
+            for (const Smb4KPendingMount &pendingMount : mounts) {
+                if (pendingMount.fileDescriptor >= 0) {
+                    close(pendingMount.fileDescriptor);
+                }
+
+                d->pendingMountPoints.remove(pendingMount.mountPoint);
+            }
+        }
+
+        d->wakingMounts.clear();
+        Q_EMIT finished(WakeUp);
+    }
+
     QListIterator<KJob *> it(subjobs());
 
     while (it.hasNext()) {
         it.next()->kill(KJob::EmitResult);
     }
+
+    // Finish the mount batch if no mount is running anymore. Otherwise,
+    // this is done when the remaining mount jobs returned.
+    if (d->mountBatchRunning && d->runningMounts == 0) {
+        finishMountBatch();
+    }
 }
 
 bool Smb4KMounter::isRunning()
 {
-    return (hasSubjobs() || d->longActionRunning);
+    return (hasSubjobs() || d->longActionRunning || d->mountBatchRunning || !d->mountQueues.isEmpty() || !d->wakingMounts.isEmpty());
 }
 
 void Smb4KMounter::triggerRemounts(bool fillList)
@@ -158,6 +332,7 @@ void Smb4KMounter::triggerRemounts(bool fillList)
 
     if (fillList) {
         QList<CustomSettingsPtr> options = Smb4KCustomSettingsManager::self()->sharesToRemount();
+        QStringList servers;
 
         for (const CustomSettingsPtr &option : std::as_const(options)) {
             if (option->remount() == Smb4KCustomSettings::RemountOnce && !Smb4KMountSettings::remountShares()) {
@@ -175,30 +350,33 @@ void Smb4KMounter::triggerRemounts(bool fillList)
                 continue;
             }
 
-            bool createAndAddShare = true;
-
-            if (Smb4KMountSettings::checkServerOnlineState()) {
-                // Check if the server is online. We try to connect on default
-                // port 445. Prefer the IP address over the host name.
-                QString hostName = !option->ipAddress().isEmpty() ? option->ipAddress() : option->hostName();
-                d->tcpSocket.connectToHost(hostName, 445);
-                createAndAddShare = d->tcpSocket.waitForConnected(3000);
-                d->tcpSocket.abort();
-            }
-
-            if (!createAndAddShare) {
-                continue;
-            }
-
             share = SharePtr::create();
             share->setUrl(option->url());
             share->setWorkgroupName(option->workgroupName());
             share->setHostIpAddress(option->ipAddress());
 
-            if (share->url().isValid() && !share->url().isEmpty()) {
+            if (!share->url().isValid() || share->url().isEmpty()) {
+                continue;
+            }
+
+            if (Smb4KMountSettings::checkServerOnlineState()) {
+                // Check if the server is online before the share is remounted.
+                // Prefer the IP address over the host name.
+                QString server = !option->ipAddress().isEmpty() ? option->ipAddress() : option->hostName();
+
+                if (!d->remountCandidates.contains(server)) {
+                    servers << server;
+                }
+
+                d->remountCandidates[server] << share;
+            } else {
                 d->remounts << share;
             }
         }
+
+        // The probes run in parallel. The shares of reachable servers are
+        // mounted in slotServerProbed().
+        Smb4KServerProber::self()->probe(servers);
     }
 
     mountShares(d->remounts);
@@ -228,34 +406,39 @@ void Smb4KMounter::mountShare(const SharePtr &share)
         return;
     }
 
-    // Wake-On-LAN: Wake the host up before mounting any shares
+    // Also return if the share is already waiting to be mounted.
+    if (d->pendingMountPoints.contains(dir.path())) {
+        return;
+    }
+
+    // Wake-On-LAN: Wake the host up before mounting any shares. The share
+    // is mounted in slotHostWokenUp() as soon as the host answers.
     if (Smb4KSettings::enableWakeOnLAN()) {
         CustomSettingsPtr customSettings = Smb4KCustomSettingsManager::self()->findCustomSettings(share->url().resolved(QUrl(QStringLiteral(".."))));
 
         if (customSettings && customSettings->wakeOnLanSendBeforeMount()) {
-            Q_EMIT aboutToStart(WakeUp);
-
-            QHostAddress address;
-
-            // Use the host's IP address directly from the share object.
-            if (share->hasHostIpAddress()) {
-                address.setAddress(share->hostIpAddress());
-            } else {
-                address.setAddress(QStringLiteral("255.255.255.255"));
+            if (d->wakingMounts.isEmpty()) {
+                Q_EMIT aboutToStart(WakeUp);
             }
 
-            // Magic Wake-On-LAN sequence
-            QByteArray sequence = wakeOnLanMagicSequence(customSettings->macAddress());
+            Smb4KPendingMount pendingMount;
+            pendingMount.share = share;
+            pendingMount.mountPoint = dir.path();
 
-            d->udpSocket.writeDatagram(sequence, address, 9);
+            d->wakingMounts[share->url().host().toCaseFolded()] << pendingMount;
+            d->pendingMountPoints.insert(pendingMount.mountPoint);
 
-            // Wait the defined time
-            wait(1000 * Smb4KSettings::wakeOnLANWaitingTime());
-
-            Q_EMIT finished(WakeUp);
+            // Use the host's IP address directly from the share object.
+            Smb4KWakeOnLan::self()->wakeUp(share->url().host(), customSettings->macAddress(), share->hasHostIpAddress() ? share->hostIpAddress() : QString());
+            return;
         }
     }
 
+    queueMount(share, dir.path());
+}
+
+void Smb4KMounter::queueMount(const SharePtr &share, const QString &mountPoint)
+{
     Smb4KCredentialsManager::self()->readLoginCredentials(share);
 
     QVariantMap mountArguments;
@@ -265,65 +448,221 @@ void Smb4KMounter::mountShare(const SharePtr &share)
         if (fileDescriptor >= 0) {
             close(fileDescriptor);
         }
+
+        d->pendingMountPoints.remove(mountPoint);
         return;
     }
 
-    KAuth::Action mountAction(QStringLiteral("org.kde.smb4k.mounthelper.mount"));
+    //
+    // Queue the mount. Each server has its own queue, so that the shares of
+    // one server are mounted one after the other, while the shares of
+    // different servers are mounted concurrently.
+    //
+    Smb4KPendingMount pendingMount;
+    pendingMount.share = share;
+    pendingMount.mountPoint = mountPoint;
+    pendingMount.arguments = mountArguments;
+    pendingMount.fileDescriptor = fileDescriptor;
+
+    QString server = share->url().host().toCaseFolded();
+
+    if (!d->mountQueues.contains(server)) {
+        d->mountQueueOrder << server;
+    }
+
+    d->mountQueues[server] << pendingMount;
+    d->pendingMountPoints.insert(pendingMount.mountPoint);
+
+    startMounts();
+}
+
+void Smb4KMounter::startMounts()
+{
+    int maximumMounts = Smb4KMountSettings::maximumConcurrentMounts();
+
+    //
+    // Take the pending mounts of every idle server until the maximum number
+    // of servers that are mounted from concurrently is reached. Mounts that
+    // pass a Kerberos ticket are done with the single mount action, all others
+    // of a server are grouped, so that they are passed to the helper at once.
+    //
+    QList<Smb4KPendingMount> batchMounts;
+    QStringList batchServers;
+    QList<Smb4KPendingMount> singleMounts;
+    QStringList singleServers;
+    int index = 0;
+
+    while (d->busyServers.size() < maximumMounts && index < d->mountQueueOrder.size()) {
+        QString server = d->mountQueueOrder.at(index);
+
+        if (d->busyServers.contains(server)) {
+            index++;
+            continue;
+        }
+
+        QList<Smb4KPendingMount> &queue = d->mountQueues[server];
+
+        if (queue.first().fileDescriptor >= 0) {
+            singleMounts << queue.takeFirst();
+            singleServers << server;
+        } else {
+            while (!queue.isEmpty() && queue.first().fileDescriptor < 0) {
+                batchMounts << queue.takeFirst();
+            }
+
+            batchServers << server;
+        }
+
+        d->busyServers.insert(server);
+
+        if (queue.isEmpty()) {
+            d->mountQueues.remove(server);
+            d->mountQueueOrder.removeAt(index);
+        } else {
+            // Move the server to the end of the line
+            d->mountQueueOrder.move(index, d->mountQueueOrder.size() - 1);
+        }
+    }
+
+    if (batchMounts.isEmpty() && singleMounts.isEmpty()) {
+        return;
+    }
+
+    if (d->runningMounts == 0) {
+        Q_EMIT aboutToStart(MountShare);
+    }
+
+    d->runningMounts += batchMounts.size() + singleMounts.size();
+
+    for (int i = 0; i < singleMounts.size(); ++i) {
+        startMountAction({singleMounts.at(i)}, {singleServers.at(i)});
+    }
+
+    //
+    // The helper mounts the shares of one server one after the other and
+    // those of different servers concurrently.
+    //
+    if (!batchMounts.isEmpty()) {
+        startMountAction(batchMounts, batchServers);
+    }
+}
+
+void Smb4KMounter::startMountAction(const QList<Smb4KPendingMount> &mounts, const QStringList &servers)
+{
+    KAuth::Action mountAction;
+
+    if (mounts.size() == 1) {
+        mountAction.setName(QStringLiteral("org.kde.smb4k.mounthelper.mount"));
+        mountAction.setArguments(mounts.first().arguments);
+    } else {
+        QVariantList mountArguments;
+
+        for (const Smb4KPendingMount &pendingMount : mounts) {
+            mountArguments << pendingMount.arguments;
+        }
+
+        QVariantMap arguments;
+        arguments.insert(QStringLiteral("mh_mounts"), mountArguments);
+
+        mountAction.setName(QStringLiteral("org.kde.smb4k.mounthelper.mountbatch"));
+        mountAction.setArguments(arguments);
+    }
+
     mountAction.setHelperId(QStringLiteral("org.kde.smb4k.mounthelper"));
-    mountAction.setArguments(mountArguments);
 
     KAuth::ExecuteJob *job = mountAction.execute();
     addSubjob(job);
 
-    Q_EMIT aboutToStart(MountShare);
+    connect(job, &KJob::result, this, [this, job, mounts, servers]() {
+        if (!job->error()) {
+            if (mounts.size() == 1) {
+                processMountError(mounts.first().share, job->data().value(QStringLiteral("mh_error_message")).toString());
+            } else {
+                QVariantList results = job->data().value(QStringLiteral("mh_results")).toList();
 
-    if (job->exec()) {
-        QString errorMsg = job->data().value(QStringLiteral("mh_error_message")).toString();
+                for (int i = 0; i < mounts.size() && i < results.size(); ++i) {
+                    processMountError(mounts.at(i).share, results.at(i).toMap().value(QStringLiteral("mh_error_message")).toString());
+                }
+            }
+        } else if (job->error() != KJob::KilledJobError) {
+            Smb4KNotification::actionFailed(job->error(), job->errorString());
+        }
 
-        if (!errorMsg.isEmpty()) {
-#if defined(Q_OS_LINUX)
-            if (errorMsg.contains(QStringLiteral("mount error 13")) || errorMsg.contains(QStringLiteral("mount error(13)")) /* authentication error */) {
-                d->retries << share;
-                Q_EMIT requestCredentials(share);
-            } else if (errorMsg.contains(QStringLiteral("Unable to find suitable address."))) {
-                // Swallow this
-            } else {
-                Smb4KNotification::mountingFailed(share, errorMsg);
+        for (const Smb4KPendingMount &pendingMount : mounts) {
+            if (pendingMount.fileDescriptor >= 0) {
+                close(pendingMount.fileDescriptor);
             }
-#elif defined(Q_OS_FREEBSD) || defined(Q_OS_NETBSD)
-            if (errorMsg.contains(QStringLiteral("Authentication error")) || errorMsg.contains(QStringLiteral("Permission denied"))) {
-                d->retries << share;
-                Q_EMIT requestCredentials(share);
-            } else {
-                Smb4KNotification::mountingFailed(share, errorMsg);
+
+            d->pendingMountPoints.remove(pendingMount.mountPoint);
+        }
+
+        for (const QString &server : servers) {
+            d->busyServers.remove(server);
+        }
+
+        removeSubjob(job);
+
+        d->runningMounts -= mounts.size();
+
+        if (d->runningMounts == 0 && d->mountQueues.isEmpty()) {
+            Q_EMIT finished(MountShare);
+
+            if (d->mountBatchRunning && d->wakingMounts.isEmpty()) {
+                finishMountBatch();
             }
-#else
-            qWarning() << "Smb4KMounter::slotMountJobFinished(): Error handling not implemented!";
-            Smb4KNotification::mountingFailed(share, errorMsg);
-#endif
+        } else {
+            startMounts();
         }
-    } else {
-        Smb4KNotification::actionFailed(job->error(), job->errorString());
-    }
+    });
 
-    if (fileDescriptor >= 0) {
-        close(fileDescriptor);
-    }
+    job->start();
+}
 
-    removeSubjob(job);
+void Smb4KMounter::processMountError(const SharePtr &share, const QString &errorMsg)
+{
+    if (errorMsg.isEmpty()) {
+        return;
+    }
 
-    Q_EMIT finished(MountShare);
+#if defined(Q_OS_LINUX)
+    if (errorMsg.contains(QStringLiteral("mount error 13")) || errorMsg.contains(QStringLiteral("mount error(13)")) /* authentication error */) {
+        d->retries << share;
+        Q_EMIT requestCredentials(share);
+    } else if (errorMsg.contains(QStringLiteral("Unable to find suitable address."))) {
+        // Swallow this
+    } else {
+        Smb4KNotification::mountingFailed(share, errorMsg);
+    }
+#elif defined(Q_OS_FREEBSD) || defined(Q_OS_NETBSD)
+    if (errorMsg.contains(QStringLiteral("Authentication error")) || errorMsg.contains(QStringLiteral("Permission denied"))) {
+        d->retries << share;
+        Q_EMIT requestCredentials(share);
+    } else {
+        Smb4KNotification::mountingFailed(share, errorMsg);
+    }
+#else
+    qWarning() << "Smb4KMounter::processMountError(): Error handling not implemented!";
+    Smb4KNotification::mountingFailed(share, errorMsg);
+#endif
 }
 
 void Smb4KMounter::mountShares(const QList<SharePtr> &shares)
 {
-    d->longActionRunning = true;
+    d->mountBatchRunning = true;
 
     for (const SharePtr &share : shares) {
         mountShare(share);
     }
 
-    d->longActionRunning = false;
+    // Nothing had to be mounted
+    if (d->runningMounts == 0 && d->mountQueues.isEmpty() && d->wakingMounts.isEmpty()) {
+        finishMountBatch();
+    }
+}
+
+void Smb4KMounter::finishMountBatch()
+{
+    d->mountBatchRunning = false;
 
     if (Smb4KHardwareInterface::self()->initialImportDone()) {
         if (d->newlyMounted.size() > 1) {
@@ -442,7 +781,9 @@ void Smb4KMounter::start()
 
 void Smb4KMounter::saveSharesForRemount()
 {
-    for (const SharePtr &share : mountedSharesList()) {
+    const QList<SharePtr> mountedShares = mountedSharesList();
+
+    for (const SharePtr &share : mountedShares) {
         if (!share->isForeign()) {
             Smb4KCustomSettingsManager::self()->addRemount(share, false);
         } else {
@@ -455,6 +796,18 @@ void Smb4KMounter::saveSharesForRemount()
         Smb4KCustomSettingsManager::self()->addRemount(share, false);
         share.clear();
     }
+
+    // Also save the shares whose servers are still being probed
+    for (const QList<SharePtr> &shares : std::as_const(d->remountCandidates)) {
+        for (const SharePtr &share : shares) {
+            Smb4KCustomSettingsManager::self()->addRemount(share, false);
+        }
+    }
+
+    d->remountCandidates.clear();
+
+    // Write all changes at once
+    Smb4KCustomSettingsManager::self()->flush();
 }
 
 void Smb4KMounter::timerEvent(QTimerEvent *event)
@@ -482,10 +835,94 @@ void Smb4KMounter::timerEvent(QTimerEvent *event)
     }
 
     // Check the size, accessibility, etc. of the shares
-    if (d->checkTimeout >= 2500) {
-        for (const SharePtr &share : mountedSharesList()) {
-            checkMountedShare(share);
-            Q_EMIT updated(share);
+    if (d->checkTimeout >= 500 && d->checkGuard->active) {
+        const QList<SharePtr> mountedShares = mountedSharesList();
+        QSet<QString> mountPoints;
+
+        for (const SharePtr &share : mountedShares) {
+            QString path = share->path();
+            mountPoints.insert(path);
+
+            Smb4KMountCheck &check = d->checks[path];
+
+            if (check.running) {
+                // The server does not respond. Mark the share as inaccessible
+                // until the check returns.
+                if (check.timeout.hasExpired() && !share->isInaccessible()) {
+                    share->setInaccessible(true);
+                    share->setFreeDiskSpace(0);
+                    share->setTotalDiskSpace(0);
+                    Q_EMIT updated(share);
+                }
+
+                continue;
+            }
+
+            if (!check.nextCheck.hasExpired()) {
+                continue;
+            }
+
+            check.running = true;
+            check.timeout.setRemainingTime(CHECK_TIMEOUT);
+
+            QSharedPointer<Smb4KMountCheckGuard> guard = d->checkGuard;
+
+            d->checkPool->start([this, guard, path]() {
+                Smb4KMountCheckResult result = probeMountPoint(path);
+
+                QMutexLocker locker(&guard->mutex);
+
+                if (!guard->active) {
+                    return;
+                }
+
+                QMetaObject::invokeMethod(
+                    this,
+                    [this, path, result]() {
+                        // Drop the results that arrive while quitting
+                        if (!d->checkGuard->active) {
+                            return;
+                        }
+
+                        auto it = d->checks.find(path);
+
+                        if (it == d->checks.end()) {
+                            return;
+                        }
+
+                        SharePtr share = findShareByPath(path);
+
+                        if (!share) {
+                            d->checks.erase(it);
+                            return;
+                        }
+
+                        it->running = false;
+
+                        // Check more often while the share changes and back off
+                        // while it does not.
+                        if (applyMountCheckResult(share, result)) {
+                            it->interval = MIN_CHECK_INTERVAL;
+                            Q_EMIT updated(share);
+                        } else {
+                            it->interval = qMin(2 * it->interval, MAX_CHECK_INTERVAL);
+                        }
+
+                        it->nextCheck.setRemainingTime(it->interval);
+                    },
+                    Qt::QueuedConnection);
+            });
+        }
+
+        // Forget the shares that are not mounted anymore
+        auto it = d->checks.begin();
+
+        while (it != d->checks.end()) {
+            if (!it->running && !mountPoints.contains(it.key())) {
+                it = d->checks.erase(it);
+            } else {
+                ++it;
+            }
         }
 
         d->checkTimeout = 0;
@@ -1137,34 +1574,7 @@ bool Smb4KMounter::fillUnmountActionArgs(const SharePtr &, bool, bool, QVariantM
 
 void Smb4KMounter::checkMountedShare(const SharePtr &share) const
 {
-    d->storageInfo.setPath(share->path());
-
-    if (d->storageInfo.isValid() && d->storageInfo.isReady()) {
-        // Accessibility
-        share->setInaccessible(false);
-
-        // Size information
-        share->setFreeDiskSpace(d->storageInfo.bytesAvailable()); // Bytes available to the user, might be less than bytesFree()
-        share->setTotalDiskSpace(d->storageInfo.bytesTotal());
-
-        // Get the owner and group, if possible.
-        QFileInfo fileInfo(share->path());
-        fileInfo.setCaching(false);
-
-        if (fileInfo.exists()) {
-            share->setUser(KUser(static_cast<K_UID>(fileInfo.ownerId())));
-            share->setGroup(KUserGroup(static_cast<K_GID>(fileInfo.groupId())));
-        } else {
-            share->setUser(KUser(KUser::UseRealUserID));
-            share->setGroup(KUserGroup(KUser::UseRealUserID));
-        }
-    } else {
-        share->setInaccessible(true);
-        share->setFreeDiskSpace(0);
-        share->setTotalDiskSpace(0);
-        share->setUser(KUser(KUser::UseRealUserID));
-        share->setGroup(KUserGroup(KUser::UseRealUserID));
-    }
+    (void)applyMountCheckResult(share, probeMountPoint(share->path()));
 }
 
 const QString Smb4KMounter::generateMountPoint(const QUrl &url) const
@@ -1181,23 +1591,23 @@ const QString Smb4KMounter::generateMountPoint(const QUrl &url) const
 
 SharePtr Smb4KMounter::createMountedShare(const QString &mountPoint) const
 {
-    KMountPoint::List mountPoints = KMountPoint::currentMountPoints(KMountPoint::BasicInfoNeeded | KMountPoint::NeedMountOptions);
-    KMountPoint::Ptr mp = mountPoints.findByPath(mountPoint);
-
     SharePtr share = SharePtr::create();
-    share->setUrl(QUrl(mp->mountedFrom()));
-    share->setPath(mp->mountPoint());
+    share->setPath(mountPoint);
     share->setMounted(true);
 
-    QStringList mountOptions = mp->mountOptions();
+    Smb4KMountTableEntry entry;
+
+    if (Smb4KMountTable::self()->find(mountPoint, &entry)) {
+        share->setUrl(QUrl(entry.mountedFrom));
 
-    for (const QString &option : std::as_const(mountOptions)) {
-        if (option.startsWith(QStringLiteral("domain=")) || option.startsWith(QStringLiteral("workgroup="))) {
-            share->setWorkgroupName(option.section(QStringLiteral("="), 1, 1).trimmed());
-        } else if (option.startsWith(QStringLiteral("addr="))) {
-            share->setHostIpAddress(option.section(QStringLiteral("="), 1, 1).trimmed());
-        } else if (option.startsWith(QStringLiteral("username=")) || option.startsWith(QStringLiteral("user="))) {
-            share->setUserName(option.section(QStringLiteral("="), 1, 1).trimmed());
+        for (const QString &option : std::as_const(entry.mountOptions)) {
+            if (option.startsWith(QStringLiteral("domain=")) || option.startsWith(QStringLiteral("workgroup="))) {
+                share->setWorkgroupName(option.section(QStringLiteral("="), 1, 1).trimmed());
+            } else if (option.startsWith(QStringLiteral("addr="))) {
+                share->setHostIpAddress(option.section(QStringLiteral("="), 1, 1).trimmed());
+            } else if (option.startsWith(QStringLiteral("username=")) || option.startsWith(QStringLiteral("user="))) {
+                share->setUserName(option.section(QStringLiteral("="), 1, 1).trimmed());
+            }
         }
     }
 
@@ -1232,6 +1642,14 @@ void Smb4KMounter::slotAboutToQuit()
 {
     abort();
 
+    // Do not start any pending checks anymore and do not let the running
+    // ones report their results. They are not waited for.
+    d->checkPool->clear();
+
+    d->checkGuard->mutex.lock();
+    d->checkGuard->active = false;
+    d->checkGuard->mutex.unlock();
+
     if (Smb4KMountSettings::remountShares()) {
         saveSharesForRemount();
     }
@@ -1250,7 +1668,9 @@ void Smb4KMounter::slotOnlineStateChanged(bool online)
         saveSharesForRemount();
 
         // FIXME: Do we need this at all?
-        for (const SharePtr &share : mountedSharesList()) {
+        const QList<SharePtr> mountedShares = mountedSharesList();
+
+        for (const SharePtr &share : mountedShares) {
             share->setInaccessible(true);
         }
 
@@ -1282,6 +1702,9 @@ void Smb4KMounter::slotActiveProfileChanged(const QString &newProfile)
         d->remounts.takeFirst().clear();
     }
 
+    // Clear all remount candidates.
+    d->remountCandidates.clear();
+
     // Clear all retries.
     while (!d->retries.isEmpty()) {
         d->retries.takeFirst().clear();
@@ -1388,7 +1811,7 @@ void Smb4KMounter::slotShareMounted(const QString &mountPoint)
 
             Q_EMIT mounted(share);
 
-            if (d->longActionRunning) {
+            if (d->mountBatchRunning) {
                 d->newlyMounted << share;
                 // Notification is handled in Smb4KMounter::mountShares()
             } else {
@@ -1430,3 +1853,42 @@ void Smb4KMounter::slotShareUnmounted(const QString &mountPoint)
 
     Q_EMIT mountedSharesListChanged();
 }
+
+void Smb4KMounter::slotServerProbed(const QString &host, bool reachable)
+{
+    if (!d->remountCandidates.contains(host)) {
+        return;
+    }
+
+    QList<SharePtr> shares = d->remountCandidates.take(host);
+
+    if (reachable && Smb4KHardwareInterface::self()->isOnline()) {
+        d->remounts << shares;
+        mountShares(shares);
+    }
+}
+
+void Smb4KMounter::slotHostWokenUp(const QString &host, bool ready)
+{
+    Q_UNUSED(ready);
+
+    if (!d->wakingMounts.contains(host.toCaseFolded())) {
+        return;
+    }
+
+    QList<Smb4KPendingMount> mounts = d->wakingMounts.take(host.toCaseFolded());
+
+    if (d->wakingMounts.isEmpty()) {
+        Q_EMIT finished(WakeUp);
+    }
+
+    // Try to mount the shares even if the host did not answer in time,
+    // as the mounting did before
+    for (const Smb4KPendingMount &pendingMount : std::as_const(mounts)) {
+        queueMount(pendingMount.share, pendingMount.mountPoint);
+    }
+
+    if (d->mountBatchRunning && d->runningMounts == 0 && d->mountQueues.isEmpty() && d->wakingMounts.isEmpty()) {
+        finishMountBatch();
+    }
+}
@@ -28,6 +28,7 @@ class Smb4KAuthInfo;
 class Smb4KMountJob;
 class Smb4KUnmountJob;
 class Smb4KMounterPrivate;
+class Smb4KPendingMount;
 
 /**
  * This is one of the core classes of Smb4K. It manages the mounting
@@ -66,14 +67,16 @@ public:
     void abort();
 
     /**
-     * This function attempts to mount a share.
+     * This function attempts to mount a share. The mount is queued and
+     * performed asynchronously.
      *
      * @param share       The Smb4KShare object that is representing the share.
      */
     void mountShare(const SharePtr &share);
 
     /**
-     * Mounts a list of shares at once.
+     * Mounts a list of shares at once. The shares are mounted concurrently
+     * and a single notification is shown when all of them were processed.
      *
      * @param shares      The list of shares
      */
@@ -244,6 +247,25 @@ protected Q_SLOTS:
      */
     void slotShareUnmounted(const QString &mountPoint);
 
+    /**
+     * This slot is called when the online state of a server that has shares
+     * to be remounted was probed. The shares are only remounted if the server
+     * is reachable.
+     *
+     * @param host          The host name or IP address of the server
+     * @param reachable     TRUE if the server is reachable
+     */
+    void slotServerProbed(const QString &host, bool reachable);
+
+    /**
+     * This slot is called when a server that has shares waiting to be
+     * mounted was woken up. The shares are then queued for mounting.
+     *
+     * @param host          The name of the server
+     * @param ready         TRUE if the server answered in time
+     */
+    void slotHostWokenUp(const QString &host, bool ready);
+
 private:
     /**
      * Trigger the remounting of shares. If the parameter @p fillList is
@@ -255,6 +277,32 @@ private:
      */
     void triggerRemounts(bool fillList);
 
+    /**
+     * Queue the mount of @p share at @p mountPoint and start it, if possible
+     */
+    void queueMount(const SharePtr &share, const QString &mountPoint);
+
+    /**
+     * Start the queued mounts, if possible
+     */
+    void startMounts();
+
+    /**
+     * Run the mount helper for the pending @p mounts of the @p servers.
+     * More than one mount is passed to the helper in one batch.
+     */
+    void startMountAction(const QList<Smb4KPendingMount> &mounts, const QStringList &servers);
+
+    /**
+     * Process the error message the mount helper returned for @p share
+     */
+    void processMountError(const SharePtr &share, const QString &errorMsg);
+
+    /**
+     * Finish the mounting of a list of shares
+     */
+    void finishMountBatch();
+
     /**
      * Save all shares that need to be remounted.
      */
@@ -271,7 +319,9 @@ private:
     bool fillUnmountActionArgs(const SharePtr &share, bool force, bool silent, QVariantMap &unmountArgs);
 
     /**
-     * Check the size, accessibility, ids, etc. of the share(s)
+     * Check the size, accessibility, ids, etc. of the share. This function
+     * blocks until the file system responded. The periodic checks are done
+     * asynchronously in timerEvent().
      */
     void checkMountedShare(const SharePtr &share) const;
 
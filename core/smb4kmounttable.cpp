@@ -0,0 +1,231 @@
+/*
+    This class caches the mount table of the system.
+
+    SPDX-FileCopyrightText: 2026 Alexander Reinholdt <alexander.reinholdt@kdemail.net>
+    SPDX-License-Identifier: GPL-2.0-or-later
+*/
+
+// application specific includes
+#include "smb4kmounttable.h"
+
+// Qt includes
+#if (QT_VERSION >= QT_VERSION_CHECK(6, 8, 0))
+#include <QApplicationStatic>
+#else
+#include <qapplicationstatic.h>
+#endif
+#include <QFile>
+#include <QHash>
+#include <QSocketNotifier>
+
+// KDE includes
+#if !defined(Q_OS_LINUX)
+#include <KMountPoint>
+#endif
+
+class Smb4KMountTablePrivate
+{
+public:
+    QHash<QString, Smb4KMountTableEntry> entries;
+    QStringList mountPoints;
+    bool upToDate;
+    QFile mountInfo;
+    QSocketNotifier *notifier;
+};
+
+class Smb4KMountTableStatic
+{
+public:
+    Smb4KMountTable instance;
+};
+
+Q_APPLICATION_STATIC(Smb4KMountTableStatic, p);
+
+#if defined(Q_OS_LINUX)
+//
+// Decode the octal escape sequences (e.g. \040 for a space) used in
+// /proc/self/mountinfo
+//
+static QString decodeMountInfoField(const QByteArray &field)
+{
+    QByteArray decoded;
+    decoded.reserve(field.size());
+
+    for (int i = 0; i < field.size(); i++) {
+        if (field.at(i) == '\\' && i + 3 < field.size()) {
+            bool ok = false;
+            int character = field.mid(i + 1, 3).toInt(&ok, 8);
+
+            if (ok) {
+                decoded += static_cast<char>(character);
+                i += 3;
+                continue;
+            }
+        }
+
+        decoded += field.at(i);
+    }
+
+    return QFile::decodeName(decoded);
+}
+#endif
+
+Smb4KMountTable::Smb4KMountTable(QObject *parent)
+    : QObject(parent)
+    , d(new Smb4KMountTablePrivate)
+{
+    d->upToDate = false;
+    d->notifier = nullptr;
+
+#if defined(Q_OS_LINUX)
+    //
+    // The kernel signals changes of the mount table as an exceptional
+    // condition on the open file. The notifier is disabled until the
+    // table was read again, so that it does not fire repeatedly.
+    //
+    d->mountInfo.setFileName(QStringLiteral("/proc/self/mountinfo"));
+
+    if (d->mountInfo.open(QIODevice::ReadOnly | QIODevice::Unbuffered)) {
+        d->notifier = new QSocketNotifier(d->mountInfo.handle(), QSocketNotifier::Exception, this);
+
+        connect(d->notifier, &QSocketNotifier::activated, this, [this]() {
+            d->notifier->setEnabled(false);
+            invalidate();
+        });
+    }
+#endif
+}
+
+Smb4KMountTable::~Smb4KMountTable()
+{
+}
+
+Smb4KMountTable *Smb4KMountTable::self()
+{
+    return &p->instance;
+}
+
+bool Smb4KMountTable::find(const QString &mountPoint, Smb4KMountTableEntry *entry)
+{
+    bool wasUpToDate = d->upToDate;
+
+    update();
+
+    //
+    // The mount table might have changed before the notification arrived.
+    // Read it again if the mount point is unknown.
+    //
+    if (!d->entries.contains(mountPoint) && wasUpToDate) {
+        invalidate();
+        update();
+    }
+
+    if (d->entries.contains(mountPoint)) {
+        *entry = d->entries.value(mountPoint);
+        return true;
+    }
+
+    return false;
+}
+
+QStringList Smb4KMountTable::networkShareMountPoints()
+{
+    update();
+
+    QStringList mountPoints;
+
+    for (const QString &mountPoint : std::as_const(d->mountPoints)) {
+        const QString &type = d->entries[mountPoint].fileSystemType;
+
+        if (type == QStringLiteral("cifs") || type == QStringLiteral("smb3") || type == QStringLiteral("smbfs")) {
+            mountPoints << mountPoint;
+        }
+    }
+
+    return mountPoints;
+}
+
+void Smb4KMountTable::invalidate()
+{
+    d->upToDate = false;
+}
+
+void Smb4KMountTable::update()
+{
+    if (d->upToDate) {
+        return;
+    }
+
+    d->entries.clear();
+    d->mountPoints.clear();
+
+#if defined(Q_OS_LINUX)
+    //
+    // Format of a line (see proc(5)):
+    // 36 35 98:0 /mnt1 /mnt2 rw,noatime master:1 - ext3 /dev/root rw,errors=continue
+    //
+    QByteArray data;
+
+    if (d->mountInfo.isOpen() && d->mountInfo.seek(0)) {
+        data = d->mountInfo.readAll();
+    } else {
+        QFile mountInfo(QStringLiteral("/proc/self/mountinfo"));
+
+        if (mountInfo.open(QIODevice::ReadOnly)) {
+            data = mountInfo.readAll();
+        }
+    }
+
+    const QList<QByteArray> lines = data.split('\n');
+
+    for (const QByteArray &line : lines) {
+        const QList<QByteArray> fields = line.split(' ');
+        int separator = fields.indexOf("-");
+
+        if (separator < 6 || fields.size() < separator + 3) {
+            continue;
+        }
+
+        Smb4KMountTableEntry entry;
+        entry.mountPoint = decodeMountInfoField(fields.at(4));
+        entry.fileSystemType = QString::fromLatin1(fields.at(separator + 1));
+        entry.mountedFrom = decodeMountInfoField(fields.at(separator + 2));
+
+        QString options = decodeMountInfoField(fields.at(5));
+
+        if (fields.size() > separator + 3) {
+            options += QStringLiteral(",") + decodeMountInfoField(fields.at(separator + 3));
+        }
+
+        entry.mountOptions = options.split(QStringLiteral(","), Qt::SkipEmptyParts);
+
+        if (!d->entries.contains(entry.mountPoint)) {
+            d->mountPoints << entry.mountPoint;
+        }
+
+        d->entries.insert(entry.mountPoint, entry);
+    }
+
+    if (d->notifier) {
+        d->notifier->setEnabled(true);
+    }
+#else
+    KMountPoint::List mountPoints = KMountPoint::currentMountPoints(KMountPoint::BasicInfoNeeded | KMountPoint::NeedMountOptions);
+
+    for (const KMountPoint::Ptr &mountPoint : std::as_const(mountPoints)) {
+        Smb4KMountTableEntry entry;
+        entry.mountPoint = mountPoint->mountPoint();
+        entry.fileSystemType = mountPoint->mountType();
+        entry.mountedFrom = mountPoint->mountedFrom();
+        entry.mountOptions = mountPoint->mountOptions();
+
+        if (!d->entries.contains(entry.mountPoint)) {
+            d->mountPoints << entry.mountPoint;
+        }
+
+        d->entries.insert(entry.mountPoint, entry);
+    }
+#endif
+
+    d->upToDate = true;
+}
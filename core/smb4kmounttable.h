@@ -0,0 +1,101 @@
+/*
+    This class caches the mount table of the system.
+
+    SPDX-FileCopyrightText: 2026 Alexander Reinholdt <alexander.reinholdt@kdemail.net>
+    SPDX-License-Identifier: GPL-2.0-or-later
+*/
+
+#ifndef SMB4KMOUNTTABLE_H
+#define SMB4KMOUNTTABLE_H
+
+// application specific includes
+#include "smb4kcore_export.h"
+
+// Qt includes
+#include <QObject>
+#include <QScopedPointer>
+#include <QStringList>
+
+// forward declarations
+class Smb4KMountTablePrivate;
+
+/**
+ * An entry of the mount table
+ */
+class Smb4KMountTableEntry
+{
+public:
+    QString mountedFrom;
+    QString mountPoint;
+    QString fileSystemType;
+    QStringList mountOptions;
+};
+
+/**
+ * This class keeps a copy of the mount table of the system. The table is
+ * read once and only read again after it changed, so that several
+ * lookups in a row do not parse the mount table several times.
+ *
+ * @author Alexander Reinholdt <alexander.reinholdt@kdemail.net>
+ * @since 4.1.0
+ */
+
+class SMB4KCORE_EXPORT Smb4KMountTable : public QObject
+{
+    Q_OBJECT
+
+public:
+    /**
+     * Constructor
+     */
+    explicit Smb4KMountTable(QObject *parent = nullptr);
+
+    /**
+     * Destructor
+     */
+    virtual ~Smb4KMountTable();
+
+    /**
+     * Returns a static pointer to this class.
+     *
+     * @returns a static pointer to this class.
+     */
+    static Smb4KMountTable *self();
+
+    /**
+     * Find the entry of the file system that is mounted at @p mountPoint.
+     *
+     * @param mountPoint      The mount point
+     *
+     * @param entry           The entry that is filled
+     *
+     * @returns TRUE if the mount point was found.
+     */
+    bool find(const QString &mountPoint, Smb4KMountTableEntry *entry);
+
+    /**
+     * Returns the mount points of all CIFS, SMB3 and SMBFS file systems.
+     *
+     * @returns the mount points of the network shares.
+     */
+    QStringList networkShareMountPoints();
+
+    /**
+     * Mark the cached mount table as outdated. It is read again the next
+     * time it is accessed.
+     */
+    void invalidate();
+
+private:
+    /**
+     * Read the mount table if it is outdated
+     */
+    void update();
+
+    /**
+     * Pointer to the Smb4KMountTablePrivate class
+     */
+    const QScopedPointer<Smb4KMountTablePrivate> d;
+};
+
+#endif
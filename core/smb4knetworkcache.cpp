@@ -0,0 +1,322 @@
+/*
+    This class stores the network neighborhood on disk.
+
+    SPDX-FileCopyrightText: 2026 Alexander Reinholdt <alexander.reinholdt@kdemail.net>
+    SPDX-License-Identifier: GPL-2.0-or-later
+*/
+
+// application specific includes
+#include "smb4knetworkcache.h"
+#include "smb4kglobal.h"
+#include "smb4khost.h"
+#include "smb4ksettings.h"
+#include "smb4kshare.h"
+#include "smb4kworkgroup.h"
+
+// Qt includes
+#include <QApplication>
+#if (QT_VERSION >= QT_VERSION_CHECK(6, 8, 0))
+#include <QApplicationStatic>
+#else
+#include <qapplicationstatic.h>
+#endif
+#include <QDataStream>
+#include <QDir>
+#include <QFile>
+#include <QSaveFile>
+#include <QTimer>
+
+//
+// File format
+//
+#define CACHE_MAGIC 0x534D344B
+#define CACHE_VERSION 1
+
+//
+// Delay before the cache is written (in ms)
+//
+#define SAVE_DELAY 5000
+
+//
+// Entries that were not seen for this number of days are dropped
+//
+#define CACHE_MAX_AGE 30
+
+using namespace Smb4KGlobal;
+
+class Smb4KNetworkCachePrivate
+{
+public:
+    QString fileName() const
+    {
+        return dataLocation() + QDir::separator() + QStringLiteral("network_neighborhood.cache");
+    }
+    QTimer saveTimer;
+};
+
+class Smb4KNetworkCacheStatic
+{
+public:
+    Smb4KNetworkCache instance;
+};
+
+Q_APPLICATION_STATIC(Smb4KNetworkCacheStatic, p);
+
+Smb4KNetworkCache::Smb4KNetworkCache(QObject *parent)
+    : QObject(parent)
+    , d(new Smb4KNetworkCachePrivate)
+{
+    d->saveTimer.setSingleShot(true);
+    d->saveTimer.setInterval(SAVE_DELAY);
+
+    connect(&d->saveTimer, &QTimer::timeout, this, &Smb4KNetworkCache::save);
+
+    //
+    // Write pending changes before the application quits
+    //
+    connect(QCoreApplication::instance(), &QCoreApplication::aboutToQuit, this, [this]() {
+        if (d->saveTimer.isActive()) {
+            save();
+        }
+    });
+}
+
+Smb4KNetworkCache::~Smb4KNetworkCache()
+{
+}
+
+Smb4KNetworkCache *Smb4KNetworkCache::self()
+{
+    return &p->instance;
+}
+
+bool Smb4KNetworkCache::load()
+{
+    if (!Smb4KSettings::cacheNetworkNeighborhood()) {
+        return false;
+    }
+
+    QFile file(d->fileName());
+
+    if (!file.open(QIODevice::ReadOnly)) {
+        return false;
+    }
+
+    QDataStream stream(&file);
+    stream.setVersion(QDataStream::Qt_6_0);
+
+    quint32 magic = 0, version = 0;
+    stream >> magic >> version;
+
+    if (magic != CACHE_MAGIC || version != CACHE_VERSION) {
+        return false;
+    }
+
+    QDateTime now = QDateTime::currentDateTime();
+
+    auto outdated = [&](const QDateTime &lastSeen) {
+        return !lastSeen.isValid() || lastSeen.daysTo(now) > CACHE_MAX_AGE;
+    };
+
+    //
+    // Read the workgroups, hosts and shares. Nothing is added to the
+    // global lists before the whole file was read successfully.
+    //
+    QList<WorkgroupPtr> workgroups;
+    QList<HostPtr> hosts;
+    QList<SharePtr> shares;
+    quint32 count = 0;
+
+    stream >> count;
+
+    for (quint32 i = 0; i < count && stream.status() == QDataStream::Ok; ++i) {
+        QString workgroupName, masterBrowserName, masterBrowserIpAddress;
+        bool dnsDiscovered = false;
+        QDateTime lastSeen;
+
+        stream >> workgroupName >> masterBrowserName >> masterBrowserIpAddress >> dnsDiscovered >> lastSeen;
+
+        if (outdated(lastSeen)) {
+            continue;
+        }
+
+        WorkgroupPtr workgroup = WorkgroupPtr::create();
+        workgroup->setWorkgroupName(workgroupName);
+        workgroup->setMasterBrowserName(masterBrowserName);
+        workgroup->setMasterBrowserIpAddress(masterBrowserIpAddress);
+        workgroup->setDnsDiscovered(dnsDiscovered);
+        workgroup->setLastSeen(lastSeen);
+        workgroup->setCached(true);
+
+        workgroups << workgroup;
+    }
+
+    stream >> count;
+
+    for (quint32 i = 0; i < count && stream.status() == QDataStream::Ok; ++i) {
+        QString workgroupName, hostName, ipAddress, comment;
+        bool isMasterBrowser = false, dnsDiscovered = false;
+        QDateTime lastSeen;
+
+        stream >> workgroupName >> hostName >> ipAddress >> comment >> isMasterBrowser >> dnsDiscovered >> lastSeen;
+
+        if (outdated(lastSeen)) {
+            continue;
+        }
+
+        HostPtr host = HostPtr::create();
+        host->setWorkgroupName(workgroupName);
+        host->setHostName(hostName);
+        host->setIpAddress(ipAddress);
+        host->setComment(comment);
+        host->setIsMasterBrowser(isMasterBrowser);
+        host->setDnsDiscovered(dnsDiscovered);
+        host->setLastSeen(lastSeen);
+        host->setCached(true);
+
+        hosts << host;
+    }
+
+    stream >> count;
+
+    for (quint32 i = 0; i < count && stream.status() == QDataStream::Ok; ++i) {
+        QString workgroupName, hostName, shareName, hostIpAddress, comment;
+        qint32 shareType = FileShare;
+        bool dnsDiscovered = false;
+        QDateTime lastSeen;
+
+        stream >> workgroupName >> hostName >> shareName >> hostIpAddress >> comment >> shareType >> dnsDiscovered >> lastSeen;
+
+        if (outdated(lastSeen)) {
+            continue;
+        }
+
+        SharePtr share = SharePtr::create();
+        share->setWorkgroupName(workgroupName);
+        share->setHostName(hostName);
+        share->setShareName(shareName);
+        share->setHostIpAddress(hostIpAddress);
+        share->setComment(comment);
+        share->setShareType(static_cast<ShareType>(shareType));
+        share->setDnsDiscovered(dnsDiscovered);
+        share->setLastSeen(lastSeen);
+        share->setCached(true);
+
+        //
+        // Honor the current settings
+        //
+        if ((share->isHidden() && !Smb4KSettings::detectHiddenShares()) || (share->isPrinter() && !Smb4KSettings::detectPrinterShares())) {
+            continue;
+        }
+
+        shares << share;
+    }
+
+    file.close();
+
+    if (stream.status() != QDataStream::Ok) {
+        return false;
+    }
+
+    //
+    // Add the items to the global lists. Hosts and shares are only added
+    // if their parent item is present.
+    //
+    bool added = false;
+
+    for (const WorkgroupPtr &workgroup : std::as_const(workgroups)) {
+        if (!findWorkgroup(workgroup->workgroupName())) {
+            added |= addWorkgroup(workgroup);
+        }
+    }
+
+    for (const HostPtr &host : std::as_const(hosts)) {
+        if (findWorkgroup(host->workgroupName()) && !findHost(host->hostName(), host->workgroupName())) {
+            added |= addHost(host);
+        }
+    }
+
+    for (const SharePtr &share : std::as_const(shares)) {
+        if (findHost(share->hostName(), share->workgroupName()) && !findShare(share->url(), share->workgroupName())) {
+            added |= addShare(share);
+        }
+    }
+
+    return added;
+}
+
+void Smb4KNetworkCache::scheduleSave()
+{
+    d->saveTimer.start();
+}
+
+void Smb4KNetworkCache::save()
+{
+    d->saveTimer.stop();
+
+    if (!Smb4KSettings::cacheNetworkNeighborhood()) {
+        QFile::remove(d->fileName());
+        return;
+    }
+
+    QDir dir;
+
+    if (!dir.exists(dataLocation())) {
+        dir.mkpath(dataLocation());
+    }
+
+    //
+    // Write to a temporary file first, so that an interrupted write
+    // does not destroy the cache
+    //
+    QSaveFile file(d->fileName());
+
+    if (!file.open(QIODevice::WriteOnly)) {
+        return;
+    }
+
+    QDataStream stream(&file);
+    stream.setVersion(QDataStream::Qt_6_0);
+    stream << static_cast<quint32>(CACHE_MAGIC) << static_cast<quint32>(CACHE_VERSION);
+
+    //
+    // Items that were discovered by a scan but have no time stamp yet
+    // are considered to be seen now. User names and passwords are not
+    // written to the cache.
+    //
+    QDateTime now = QDateTime::currentDateTime();
+
+    auto lastSeen = [&](const NetworkItemPtr &item) {
+        return item->lastSeen().isValid() ? item->lastSeen() : now;
+    };
+
+    const QList<WorkgroupPtr> workgroups = workgroupsList();
+    stream << static_cast<quint32>(workgroups.size());
+
+    for (const WorkgroupPtr &workgroup : workgroups) {
+        stream << workgroup->workgroupName() << workgroup->masterBrowserName() << workgroup->masterBrowserIpAddress() << workgroup->dnsDiscovered()
+               << lastSeen(workgroup);
+    }
+
+    const QList<HostPtr> hosts = hostsList();
+    stream << static_cast<quint32>(hosts.size());
+
+    for (const HostPtr &host : hosts) {
+        stream << host->workgroupName() << host->hostName() << host->ipAddress() << host->comment() << host->isMasterBrowser() << host->dnsDiscovered()
+               << lastSeen(host);
+    }
+
+    const QList<SharePtr> shares = sharesList();
+    stream << static_cast<quint32>(shares.size());
+
+    for (const SharePtr &share : shares) {
+        stream << share->workgroupName() << share->hostName() << share->shareName() << share->hostIpAddress() << share->comment()
+               << static_cast<qint32>(share->shareType()) << share->dnsDiscovered() << lastSeen(share);
+    }
+
+    if (stream.status() == QDataStream::Ok) {
+        file.commit();
+    } else {
+        file.cancelWriting();
+    }
+}
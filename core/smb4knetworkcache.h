@@ -0,0 +1,82 @@
+/*
+    This class stores the network neighborhood on disk.
+
+    SPDX-FileCopyrightText: 2026 Alexander Reinholdt <alexander.reinholdt@kdemail.net>
+    SPDX-License-Identifier: GPL-2.0-or-later
+*/
+
+#ifndef SMB4KNETWORKCACHE_H
+#define SMB4KNETWORKCACHE_H
+
+// application specific includes
+#include "smb4kcore_export.h"
+
+// Qt includes
+#include <QObject>
+#include <QScopedPointer>
+
+// forward declarations
+class Smb4KNetworkCachePrivate;
+
+/**
+ * This class stores the workgroups, hosts and shares of the network
+ * neighborhood on disk, so that they can be shown right after the start
+ * of the application. Loaded items are marked as cached until a scan
+ * confirms them.
+ *
+ * @author Alexander Reinholdt <alexander.reinholdt@kdemail.net>
+ * @since 4.1.0
+ */
+
+class SMB4KCORE_EXPORT Smb4KNetworkCache : public QObject
+{
+    Q_OBJECT
+
+public:
+    /**
+     * Constructor
+     */
+    explicit Smb4KNetworkCache(QObject *parent = nullptr);
+
+    /**
+     * Destructor
+     */
+    virtual ~Smb4KNetworkCache();
+
+    /**
+     * Returns a static pointer to this class.
+     *
+     * @returns a static pointer to this class.
+     */
+    static Smb4KNetworkCache *self();
+
+    /**
+     * Read the cache file and add the workgroups, hosts and shares to the
+     * global lists. Entries that are already present in the global lists
+     * are skipped.
+     *
+     * @returns TRUE if items were added to the global lists.
+     */
+    bool load();
+
+    /**
+     * Write the global lists of workgroups, hosts and shares to the cache
+     * file after a short delay. Several requests are collected and written
+     * at once.
+     */
+    void scheduleSave();
+
+    /**
+     * Write the global lists of workgroups, hosts and shares to the cache
+     * file immediately.
+     */
+    void save();
+
+private:
+    /**
+     * Pointer to the Smb4KNetworkCachePrivate class
+     */
+    const QScopedPointer<Smb4KNetworkCachePrivate> d;
+};
+
+#endif
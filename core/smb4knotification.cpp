@@ -423,7 +423,7 @@ void Smb4KNotification::fileNotFound(const QString &fileName)
     }
 }
 
-void Smb4KNotification::openingFileFailed(const QFile &file)
+void Smb4KNotification::openingFileFailed(const QFileDevice &file)
 {
     if (qobject_cast<QApplication *>(QCoreApplication::instance())) {
         QString text;
@@ -143,9 +143,9 @@ SMB4KCORE_EXPORT void fileNotFound(const QString &fileName);
 /**
  * This error message is shown if a file could not be opened.
  *
- * @param file      The QFile object
+ * @param file      The file object
  */
-SMB4KCORE_EXPORT void openingFileFailed(const QFile &file);
+SMB4KCORE_EXPORT void openingFileFailed(const QFileDevice &file);
 
 /**
  * This error message is shown if a file could not be read.
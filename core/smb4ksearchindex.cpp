@@ -0,0 +1,349 @@
+/*
+    This class provides the search index of the network neighborhood.
+
+    SPDX-FileCopyrightText: 2026 Alexander Reinholdt <alexander.reinholdt@kdemail.net>
+    SPDX-License-Identifier: GPL-2.0-or-later
+*/
+
+// application specific includes
+#include "smb4ksearchindex.h"
+#include "smb4khost.h"
+#include "smb4ksettings.h"
+#include "smb4kshare.h"
+
+// Qt includes
+#include <QApplication>
+#if (QT_VERSION >= QT_VERSION_CHECK(6, 8, 0))
+#include <QApplicationStatic>
+#else
+#include <qapplicationstatic.h>
+#endif
+#include <QDataStream>
+#include <QDir>
+#include <QFile>
+#include <QHash>
+#include <QSaveFile>
+#include <QSet>
+#include <QTimer>
+
+//
+// File format
+//
+#define INDEX_MAGIC 0x534D4958
+#define INDEX_VERSION 1
+
+//
+// Delay before the index is written (in ms)
+//
+#define SAVE_DELAY 5000
+
+//
+// Length of the n-grams
+//
+#define NGRAM_LENGTH 3
+
+using namespace Smb4KGlobal;
+
+class Smb4KSearchDocument
+{
+public:
+    QString url;
+    QString hostKey;
+    QString text;
+};
+
+class Smb4KSearchIndexPrivate
+{
+public:
+    QString fileName() const
+    {
+        return dataLocation() + QDir::separator() + QStringLiteral("search_index.cache");
+    }
+    void insert(const Smb4KSearchDocument &document);
+    void remove(const QString &url);
+    QHash<QString, Smb4KSearchDocument> documents;
+    QHash<QString, QSet<QString>> hostDocuments;
+    QHash<QString, QSet<QString>> postings;
+    QTimer saveTimer;
+};
+
+class Smb4KSearchIndexStatic
+{
+public:
+    Smb4KSearchIndex instance;
+};
+
+Q_APPLICATION_STATIC(Smb4KSearchIndexStatic, p);
+
+static QSet<QString> ngrams(const QString &text)
+{
+    QSet<QString> result;
+
+    for (int i = 0; i + NGRAM_LENGTH <= text.size(); ++i) {
+        result.insert(text.mid(i, NGRAM_LENGTH));
+    }
+
+    return result;
+}
+
+void Smb4KSearchIndexPrivate::insert(const Smb4KSearchDocument &document)
+{
+    remove(document.url);
+
+    documents.insert(document.url, document);
+    hostDocuments[document.hostKey].insert(document.url);
+
+    const QSet<QString> grams = ngrams(document.text);
+
+    for (const QString &gram : grams) {
+        postings[gram].insert(document.url);
+    }
+}
+
+void Smb4KSearchIndexPrivate::remove(const QString &url)
+{
+    auto it = documents.find(url);
+
+    if (it == documents.end()) {
+        return;
+    }
+
+    const QSet<QString> grams = ngrams(it->text);
+
+    for (const QString &gram : grams) {
+        auto postingsIt = postings.find(gram);
+
+        if (postingsIt != postings.end()) {
+            postingsIt->remove(url);
+
+            if (postingsIt->isEmpty()) {
+                postings.erase(postingsIt);
+            }
+        }
+    }
+
+    auto hostIt = hostDocuments.find(it->hostKey);
+
+    if (hostIt != hostDocuments.end()) {
+        hostIt->remove(url);
+
+        if (hostIt->isEmpty()) {
+            hostDocuments.erase(hostIt);
+        }
+    }
+
+    documents.erase(it);
+}
+
+Smb4KSearchIndex::Smb4KSearchIndex(QObject *parent)
+    : QObject(parent)
+    , d(new Smb4KSearchIndexPrivate)
+{
+    d->saveTimer.setSingleShot(true);
+    d->saveTimer.setInterval(SAVE_DELAY);
+
+    connect(&d->saveTimer, &QTimer::timeout, this, &Smb4KSearchIndex::save);
+
+    //
+    // Write pending changes before the application quits
+    //
+    connect(QCoreApplication::instance(), &QCoreApplication::aboutToQuit, this, [this]() {
+        if (d->saveTimer.isActive()) {
+            save();
+        }
+    });
+
+    load();
+}
+
+Smb4KSearchIndex::~Smb4KSearchIndex()
+{
+}
+
+Smb4KSearchIndex *Smb4KSearchIndex::self()
+{
+    return &p->instance;
+}
+
+void Smb4KSearchIndex::setShares(const HostPtr &host, const QList<SharePtr> &shares)
+{
+    QString hostKey = host->url().toString(QUrl::RemoveUserInfo | QUrl::RemovePort).toCaseFolded();
+
+    //
+    // Remove the shares that are not present anymore
+    //
+    const QSet<QString> indexedUrls = d->hostDocuments.value(hostKey);
+    QSet<QString> currentUrls;
+
+    for (const SharePtr &share : shares) {
+        currentUrls.insert(share->url().toString(QUrl::RemoveUserInfo | QUrl::RemovePort));
+    }
+
+    for (const QString &url : indexedUrls) {
+        if (!currentUrls.contains(url)) {
+            d->remove(url);
+        }
+    }
+
+    //
+    // Add new and changed shares. The share name, the comment and the host
+    // name are indexed. They are separated by line breaks, so that no n-gram
+    // spans two of them.
+    //
+    for (const SharePtr &share : shares) {
+        Smb4KSearchDocument document;
+        document.url = share->url().toString(QUrl::RemoveUserInfo | QUrl::RemovePort);
+        document.hostKey = hostKey;
+        document.text = QStringList({share->shareName(), share->comment(), share->hostName()}).join(QStringLiteral("\n")).toCaseFolded();
+
+        auto it = d->documents.constFind(document.url);
+
+        if (it == d->documents.constEnd() || it->text != document.text) {
+            d->insert(document);
+        }
+    }
+
+    d->saveTimer.start();
+}
+
+QList<QUrl> Smb4KSearchIndex::search(const QString &term) const
+{
+    QList<QUrl> results;
+    QString searchTerm = term.toCaseFolded();
+
+    if (searchTerm.isEmpty()) {
+        return results;
+    }
+
+    //
+    // Short search terms cannot be looked up in the index. Check all
+    // documents instead.
+    //
+    if (searchTerm.size() < NGRAM_LENGTH) {
+        for (const Smb4KSearchDocument &document : std::as_const(d->documents)) {
+            if (document.text.contains(searchTerm)) {
+                results << QUrl(document.url);
+            }
+        }
+
+        return results;
+    }
+
+    //
+    // Only the documents that contain all n-grams of the search term can
+    // match. Start with the smallest posting list and verify the candidates.
+    //
+    const QSet<QString> grams = ngrams(searchTerm);
+    const QSet<QString> *candidates = nullptr;
+
+    for (const QString &gram : grams) {
+        auto it = d->postings.constFind(gram);
+
+        if (it == d->postings.constEnd()) {
+            return results;
+        }
+
+        if (!candidates || it->size() < candidates->size()) {
+            candidates = &(*it);
+        }
+    }
+
+    for (const QString &url : *candidates) {
+        if (d->documents.value(url).text.contains(searchTerm)) {
+            results << QUrl(url);
+        }
+    }
+
+    return results;
+}
+
+void Smb4KSearchIndex::clear()
+{
+    d->documents.clear();
+    d->hostDocuments.clear();
+    d->postings.clear();
+
+    d->saveTimer.start();
+}
+
+void Smb4KSearchIndex::load()
+{
+    if (!Smb4KSettings::cacheNetworkNeighborhood()) {
+        return;
+    }
+
+    QFile file(d->fileName());
+
+    if (!file.open(QIODevice::ReadOnly)) {
+        return;
+    }
+
+    QDataStream stream(&file);
+    stream.setVersion(QDataStream::Qt_6_0);
+
+    quint32 magic = 0, version = 0, count = 0;
+    stream >> magic >> version;
+
+    if (magic != INDEX_MAGIC || version != INDEX_VERSION) {
+        return;
+    }
+
+    //
+    // Only the documents are stored. The n-grams are computed again
+    // while loading.
+    //
+    QList<Smb4KSearchDocument> documents;
+
+    stream >> count;
+
+    for (quint32 i = 0; i < count && stream.status() == QDataStream::Ok; ++i) {
+        Smb4KSearchDocument document;
+        stream >> document.url >> document.hostKey >> document.text;
+        documents << document;
+    }
+
+    if (stream.status() != QDataStream::Ok) {
+        return;
+    }
+
+    for (const Smb4KSearchDocument &document : std::as_const(documents)) {
+        d->insert(document);
+    }
+}
+
+void Smb4KSearchIndex::save()
+{
+    d->saveTimer.stop();
+
+    if (!Smb4KSettings::cacheNetworkNeighborhood()) {
+        QFile::remove(d->fileName());
+        return;
+    }
+
+    QDir dir;
+
+    if (!dir.exists(dataLocation())) {
+        dir.mkpath(dataLocation());
+    }
+
+    QSaveFile file(d->fileName());
+
+    if (!file.open(QIODevice::WriteOnly)) {
+        return;
+    }
+
+    QDataStream stream(&file);
+    stream.setVersion(QDataStream::Qt_6_0);
+    stream << static_cast<quint32>(INDEX_MAGIC) << static_cast<quint32>(INDEX_VERSION);
+    stream << static_cast<quint32>(d->documents.size());
+
+    for (const Smb4KSearchDocument &document : std::as_const(d->documents)) {
+        stream << document.url << document.hostKey << document.text;
+    }
+
+    if (stream.status() == QDataStream::Ok) {
+        file.commit();
+    } else {
+        file.cancelWriting();
+    }
+}
@@ -0,0 +1,97 @@
+/*
+    This class provides the search index of the network neighborhood.
+
+    SPDX-FileCopyrightText: 2026 Alexander Reinholdt <alexander.reinholdt@kdemail.net>
+    SPDX-License-Identifier: GPL-2.0-or-later
+*/
+
+#ifndef SMB4KSEARCHINDEX_H
+#define SMB4KSEARCHINDEX_H
+
+// application specific includes
+#include "smb4kcore_export.h"
+#include "smb4kglobal.h"
+
+// Qt includes
+#include <QList>
+#include <QObject>
+#include <QScopedPointer>
+#include <QUrl>
+
+// forward declarations
+class Smb4KSearchIndexPrivate;
+
+/**
+ * This class maintains a trigram index over the names and comments of the
+ * shares and the names of their hosts. It is updated every time the shares
+ * of a host were looked up and is stored on disk, so that searches can be
+ * answered without scanning the network neighborhood first.
+ *
+ * @author Alexander Reinholdt <alexander.reinholdt@kdemail.net>
+ * @since 4.1.0
+ */
+
+class SMB4KCORE_EXPORT Smb4KSearchIndex : public QObject
+{
+    Q_OBJECT
+
+public:
+    /**
+     * Constructor
+     */
+    explicit Smb4KSearchIndex(QObject *parent = nullptr);
+
+    /**
+     * Destructor
+     */
+    virtual ~Smb4KSearchIndex();
+
+    /**
+     * Returns a static pointer to this class.
+     *
+     * @returns a static pointer to this class.
+     */
+    static Smb4KSearchIndex *self();
+
+    /**
+     * Replace the indexed shares of @p host with @p shares. Pass an empty
+     * list to remove the host from the index.
+     *
+     * @param host          The host
+     * @param shares        The shares of the host
+     */
+    void setShares(const HostPtr &host, const QList<SharePtr> &shares);
+
+    /**
+     * Find the shares whose name, comment or host name contain @p term.
+     * The comparison is case insensitive.
+     *
+     * @param term          The search term
+     *
+     * @returns the URLs of the matching shares.
+     */
+    QList<QUrl> search(const QString &term) const;
+
+    /**
+     * Remove all entries from the index
+     */
+    void clear();
+
+private:
+    /**
+     * Read the index from disk
+     */
+    void load();
+
+    /**
+     * Write the index to disk
+     */
+    void save();
+
+    /**
+     * Pointer to the Smb4KSearchIndexPrivate class
+     */
+    const QScopedPointer<Smb4KSearchIndexPrivate> d;
+};
+
+#endif
@@ -0,0 +1,157 @@
+/*
+    This class checks asynchronously whether servers are reachable.
+
+    SPDX-FileCopyrightText: 2026 Alexander Reinholdt <alexander.reinholdt@kdemail.net>
+    SPDX-License-Identifier: GPL-2.0-or-later
+*/
+
+// application specific includes
+#include "smb4kserverprober.h"
+#include "smb4khardwareinterface.h"
+
+// Qt includes
+#include <QApplication>
+#if (QT_VERSION >= QT_VERSION_CHECK(6, 8, 0))
+#include <QApplicationStatic>
+#else
+#include <qapplicationstatic.h>
+#endif
+#include <QDeadlineTimer>
+#include <QHash>
+#include <QTcpSocket>
+#include <QTimer>
+
+#define PROBE_PORT 445
+#define PROBE_TIMEOUT 3000
+#define CACHE_TIMEOUT 30000
+
+class Smb4KProbeResult
+{
+public:
+    bool reachable;
+    QDeadlineTimer expiry;
+};
+
+class Smb4KServerProberPrivate
+{
+public:
+    QHash<QString, Smb4KProbeResult> cache;
+    QHash<QString, QTcpSocket *> sockets;
+};
+
+class Smb4KServerProberStatic
+{
+public:
+    Smb4KServerProber instance;
+};
+
+Q_APPLICATION_STATIC(Smb4KServerProberStatic, p);
+
+Smb4KServerProber::Smb4KServerProber(QObject *parent)
+    : QObject(parent)
+    , d(new Smb4KServerProberPrivate)
+{
+    connect(Smb4KHardwareInterface::self(), &Smb4KHardwareInterface::onlineStateChanged, this, &Smb4KServerProber::clear);
+}
+
+Smb4KServerProber::~Smb4KServerProber()
+{
+}
+
+Smb4KServerProber *Smb4KServerProber::self()
+{
+    return &p->instance;
+}
+
+void Smb4KServerProber::probe(const QString &host)
+{
+    if (host.isEmpty()) {
+        return;
+    }
+
+    QString key = host.toCaseFolded();
+
+    //
+    // Use the cached result, if it is still valid
+    //
+    auto it = d->cache.constFind(key);
+
+    if (it != d->cache.constEnd() && !it->expiry.hasExpired()) {
+        bool reachable = it->reachable;
+        QMetaObject::invokeMethod(
+            this,
+            [this, host, reachable]() {
+                Q_EMIT probed(host, reachable);
+            },
+            Qt::QueuedConnection);
+        return;
+    }
+
+    //
+    // Do not probe a server twice at the same time
+    //
+    if (d->sockets.contains(key)) {
+        return;
+    }
+
+    QTcpSocket *socket = new QTcpSocket(this);
+    d->sockets.insert(key, socket);
+
+    connect(socket, &QTcpSocket::connected, this, [this, host, socket]() {
+        finishProbe(host, socket, true);
+    });
+
+    connect(socket, &QTcpSocket::errorOccurred, this, [this, host, socket]() {
+        finishProbe(host, socket, false);
+    });
+
+    QTimer::singleShot(PROBE_TIMEOUT, socket, [this, host, socket]() {
+        finishProbe(host, socket, false);
+    });
+
+    socket->connectToHost(host, PROBE_PORT);
+}
+
+void Smb4KServerProber::probe(const QStringList &hosts)
+{
+    for (const QString &host : hosts) {
+        probe(host);
+    }
+}
+
+void Smb4KServerProber::clear()
+{
+    d->cache.clear();
+}
+
+void Smb4KServerProber::invalidate(const QString &host)
+{
+    d->cache.remove(host.toCaseFolded());
+}
+
+void Smb4KServerProber::finishProbe(const QString &host, QTcpSocket *socket, bool reachable)
+{
+    QString key = host.toCaseFolded();
+
+    //
+    // Ignore the timeout of a probe that already finished, so that it
+    // does not finish a newer probe of the same host
+    //
+    if (d->sockets.value(key) != socket) {
+        return;
+    }
+
+    d->sockets.remove(key);
+
+    socket->disconnect(this);
+    socket->abort();
+    socket->deleteLater();
+
+    Smb4KProbeResult result;
+    result.reachable = reachable;
+    result.expiry.setRemainingTime(CACHE_TIMEOUT);
+
+    d->cache.insert(key, result);
+
+    Q_EMIT probed(host, reachable);
+}
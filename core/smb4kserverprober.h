@@ -0,0 +1,106 @@
+/*
+    This class checks asynchronously whether servers are reachable.
+
+    SPDX-FileCopyrightText: 2026 Alexander Reinholdt <alexander.reinholdt@kdemail.net>
+    SPDX-License-Identifier: GPL-2.0-or-later
+*/
+
+#ifndef SMB4KSERVERPROBER_H
+#define SMB4KSERVERPROBER_H
+
+// application specific includes
+#include "smb4kcore_export.h"
+
+// Qt includes
+#include <QObject>
+#include <QScopedPointer>
+#include <QString>
+#include <QStringList>
+
+// forward declarations
+class Smb4KServerProberPrivate;
+class QTcpSocket;
+
+/**
+ * This class checks whether servers are reachable by connecting to their
+ * SMB port 445. All servers are probed in parallel and the results are
+ * cached for a short time.
+ *
+ * @author Alexander Reinholdt <alexander.reinholdt@kdemail.net>
+ * @since 4.1.0
+ */
+
+class SMB4KCORE_EXPORT Smb4KServerProber : public QObject
+{
+    Q_OBJECT
+
+public:
+    /**
+     * Constructor
+     */
+    explicit Smb4KServerProber(QObject *parent = nullptr);
+
+    /**
+     * Destructor
+     */
+    virtual ~Smb4KServerProber();
+
+    /**
+     * Returns a static pointer to this class.
+     *
+     * @returns a static pointer to this class.
+     */
+    static Smb4KServerProber *self();
+
+    /**
+     * Probe the server @p host. The result is reported with the probed()
+     * signal. If a cached result is available, the signal is emitted the
+     * next time the event loop is entered.
+     *
+     * @param host          The host name or IP address of the server
+     */
+    void probe(const QString &host);
+
+    /**
+     * Probe all servers in @p hosts in parallel.
+     *
+     * @param hosts         The host names or IP addresses of the servers
+     */
+    void probe(const QStringList &hosts);
+
+    /**
+     * Clear the cached results.
+     */
+    void clear();
+
+    /**
+     * Remove the cached result of @p host, so that the next probe
+     * connects to the server again.
+     *
+     * @param host          The host name or IP address of the server
+     */
+    void invalidate(const QString &host);
+
+Q_SIGNALS:
+    /**
+     * This signal is emitted when a server was probed.
+     *
+     * @param host          The host name or IP address of the server
+     * @param reachable     TRUE if the server accepted the connection
+     */
+    void probed(const QString &host, bool reachable);
+
+private:
+    /**
+     * Finish the probe of @p host that uses @p socket and report the
+     * result. Signals of an earlier probe of the same host are ignored.
+     */
+    void finishProbe(const QString &host, QTcpSocket *socket, bool reachable);
+
+    /**
+     * Pointer to the Smb4KServerProberPrivate class
+     */
+    const QScopedPointer<Smb4KServerProberPrivate> d;
+};
+
+#endif
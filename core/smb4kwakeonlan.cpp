@@ -0,0 +1,160 @@
+/*
+    This class wakes up servers with Wake-On-LAN packets.
+
+    SPDX-FileCopyrightText: 2026 Alexander Reinholdt <alexander.reinholdt@kdemail.net>
+    SPDX-License-Identifier: GPL-2.0-or-later
+*/
+
+// application specific includes
+#include "smb4kwakeonlan.h"
+#include "smb4kglobal.h"
+#include "smb4kserverprober.h"
+#include "smb4ksettings.h"
+
+// Qt includes
+#include <QApplication>
+#if (QT_VERSION >= QT_VERSION_CHECK(6, 8, 0))
+#include <QApplicationStatic>
+#else
+#include <qapplicationstatic.h>
+#endif
+#include <QDeadlineTimer>
+#include <QHash>
+#include <QHostAddress>
+#include <QTimer>
+#include <QUdpSocket>
+
+#define WAKE_ON_LAN_PORT 9
+#define MIN_PROBE_DELAY 500
+#define MAX_PROBE_DELAY 4000
+
+using namespace Smb4KGlobal;
+
+class Smb4KWakeUpTarget
+{
+public:
+    QString host;
+    QString address;
+    QDeadlineTimer deadline;
+    int delay;
+};
+
+class Smb4KWakeOnLanPrivate
+{
+public:
+    QHash<QString, Smb4KWakeUpTarget> targets;
+    QHash<QString, QString> addresses;
+    QUdpSocket udpSocket;
+};
+
+class Smb4KWakeOnLanStatic
+{
+public:
+    Smb4KWakeOnLan instance;
+};
+
+Q_APPLICATION_STATIC(Smb4KWakeOnLanStatic, p);
+
+Smb4KWakeOnLan::Smb4KWakeOnLan(QObject *parent)
+    : QObject(parent)
+    , d(new Smb4KWakeOnLanPrivate)
+{
+    connect(Smb4KServerProber::self(), &Smb4KServerProber::probed, this, &Smb4KWakeOnLan::slotProbed);
+}
+
+Smb4KWakeOnLan::~Smb4KWakeOnLan()
+{
+}
+
+Smb4KWakeOnLan *Smb4KWakeOnLan::self()
+{
+    return &p->instance;
+}
+
+void Smb4KWakeOnLan::wakeUp(const QString &host, const QString &macAddress, const QString &ipAddress)
+{
+    QString key = host.toCaseFolded();
+
+    if (key.isEmpty() || d->targets.contains(key)) {
+        return;
+    }
+
+    //
+    // Send the magic packet
+    //
+    QHostAddress address(ipAddress.isEmpty() ? QStringLiteral("255.255.255.255") : ipAddress);
+    d->udpSocket.writeDatagram(wakeOnLanMagicSequence(macAddress), address, WAKE_ON_LAN_PORT);
+
+    //
+    // Wait until the server accepts connections, but not longer than
+    // the waiting time
+    //
+    Smb4KWakeUpTarget target;
+    target.host = host;
+    target.address = ipAddress.isEmpty() ? host : ipAddress;
+    target.deadline.setRemainingTime(1000 * Smb4KSettings::wakeOnLANWaitingTime());
+    target.delay = MIN_PROBE_DELAY;
+
+    d->targets.insert(key, target);
+    d->addresses.insert(target.address.toCaseFolded(), key);
+
+    probe(key);
+}
+
+bool Smb4KWakeOnLan::isWakingUp(const QString &host) const
+{
+    return d->targets.contains(host.toCaseFolded());
+}
+
+void Smb4KWakeOnLan::slotProbed(const QString &address, bool reachable)
+{
+    QString key = d->addresses.value(address.toCaseFolded());
+    auto it = d->targets.find(key);
+
+    if (it == d->targets.end()) {
+        return;
+    }
+
+    if (reachable) {
+        finish(key, true);
+        return;
+    }
+
+    if (it->deadline.hasExpired()) {
+        finish(key, false);
+        return;
+    }
+
+    //
+    // Probe again with increasing delays
+    //
+    int delay = qMin<qint64>(it->delay, it->deadline.remainingTime());
+    it->delay = qMin(2 * it->delay, MAX_PROBE_DELAY);
+
+    QTimer::singleShot(delay, this, [this, key]() {
+        probe(key);
+    });
+}
+
+void Smb4KWakeOnLan::probe(const QString &host)
+{
+    auto it = d->targets.constFind(host);
+
+    if (it == d->targets.constEnd()) {
+        return;
+    }
+
+    //
+    // Always connect to the server, a cached result is outdated here
+    //
+    Smb4KServerProber::self()->invalidate(it->address);
+    Smb4KServerProber::self()->probe(it->address);
+}
+
+void Smb4KWakeOnLan::finish(const QString &host, bool ready)
+{
+    Smb4KWakeUpTarget target = d->targets.take(host);
+    d->addresses.remove(target.address.toCaseFolded());
+
+    Q_EMIT wokenUp(target.host, ready);
+}
@@ -0,0 +1,107 @@
+/*
+    This class wakes up servers with Wake-On-LAN packets.
+
+    SPDX-FileCopyrightText: 2026 Alexander Reinholdt <alexander.reinholdt@kdemail.net>
+    SPDX-License-Identifier: GPL-2.0-or-later
+*/
+
+#ifndef SMB4KWAKEONLAN_H
+#define SMB4KWAKEONLAN_H
+
+// application specific includes
+#include "smb4kcore_export.h"
+
+// Qt includes
+#include <QObject>
+#include <QScopedPointer>
+#include <QString>
+
+// forward declarations
+class Smb4KWakeOnLanPrivate;
+
+/**
+ * This class sends the magic Wake-On-LAN packets to servers and waits
+ * asynchronously until they accept connections on their SMB port. All
+ * servers are woken up in parallel.
+ *
+ * @author Alexander Reinholdt <alexander.reinholdt@kdemail.net>
+ * @since 4.1.0
+ */
+
+class SMB4KCORE_EXPORT Smb4KWakeOnLan : public QObject
+{
+    Q_OBJECT
+
+public:
+    /**
+     * Constructor
+     */
+    explicit Smb4KWakeOnLan(QObject *parent = nullptr);
+
+    /**
+     * Destructor
+     */
+    virtual ~Smb4KWakeOnLan();
+
+    /**
+     * Returns a static pointer to this class.
+     *
+     * @returns a static pointer to this class.
+     */
+    static Smb4KWakeOnLan *self();
+
+    /**
+     * Send the magic packet to the server @p host and wait until it is
+     * ready. The wokenUp() signal is emitted when the server answers or
+     * the waiting time defined in the settings passed. If the server is
+     * already being woken up, no further packet is sent.
+     *
+     * @param host          The name of the server
+     * @param macAddress    The MAC address of the server
+     * @param ipAddress     The IP address of the server. If it is empty,
+     *                      the packet is broadcast.
+     */
+    void wakeUp(const QString &host, const QString &macAddress, const QString &ipAddress = QString());
+
+    /**
+     * Returns TRUE if the server @p host is being woken up.
+     *
+     * @param host          The name of the server
+     *
+     * @returns TRUE if the server is being woken up.
+     */
+    bool isWakingUp(const QString &host) const;
+
+Q_SIGNALS:
+    /**
+     * This signal is emitted when a server was woken up.
+     *
+     * @param host          The name of the server
+     * @param ready         TRUE if the server answered and FALSE if
+     *                      the waiting time passed
+     */
+    void wokenUp(const QString &host, bool ready);
+
+private:
+    /**
+     * Called when a server was probed
+     */
+    void slotProbed(const QString &address, bool reachable);
+
+    /**
+     * Probe the server @p host again
+     */
+    void probe(const QString &host);
+
+    /**
+     * Finish waking up the server @p host
+     */
+    void finish(const QString &host, bool ready);
+
+    /**
+     * Pointer to the Smb4KWakeOnLanPrivate class
+     */
+    const QScopedPointer<Smb4KWakeOnLanPrivate> d;
+};
+
+#endif
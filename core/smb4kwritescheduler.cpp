@@ -0,0 +1,63 @@
+/*
+    This class coalesces the write requests for a data file.
+
+    SPDX-FileCopyrightText: 2026 Alexander Reinholdt <alexander.reinholdt@kdemail.net>
+    SPDX-License-Identifier: GPL-2.0-or-later
+*/
+
+// application specific includes
+#include "smb4kwritescheduler.h"
+
+// Qt includes
+#include <QCoreApplication>
+
+//
+// Delay after the last request before the data is written (in ms)
+//
+#define WRITE_DELAY 500
+
+//
+// Maximum delay after the first request before the data is written (in ms)
+//
+#define MAX_WRITE_DELAY 5000
+
+Smb4KWriteScheduler::Smb4KWriteScheduler(QObject *parent)
+    : QObject(parent)
+{
+    m_timer.setSingleShot(true);
+
+    connect(&m_timer, &QTimer::timeout, this, &Smb4KWriteScheduler::flush);
+
+    //
+    // Write pending changes before the application quits
+    //
+    connect(QCoreApplication::instance(), &QCoreApplication::aboutToQuit, this, &Smb4KWriteScheduler::flush);
+}
+
+Smb4KWriteScheduler::~Smb4KWriteScheduler()
+{
+}
+
+void Smb4KWriteScheduler::schedule()
+{
+    if (!m_pendingSince.isValid()) {
+        m_pendingSince.start();
+    }
+
+    m_timer.start(qBound(0, static_cast<int>(MAX_WRITE_DELAY - m_pendingSince.elapsed()), WRITE_DELAY));
+}
+
+void Smb4KWriteScheduler::flush()
+{
+    if (m_pendingSince.isValid()) {
+        m_timer.stop();
+        m_pendingSince.invalidate();
+
+        Q_EMIT write();
+    }
+}
+
+bool Smb4KWriteScheduler::isPending() const
+{
+    return m_pendingSince.isValid();
+}
@@ -0,0 +1,71 @@
+/*
+    This class coalesces the write requests for a data file.
+
+    SPDX-FileCopyrightText: 2026 Alexander Reinholdt <alexander.reinholdt@kdemail.net>
+    SPDX-License-Identifier: GPL-2.0-or-later
+*/
+
+#ifndef SMB4KWRITESCHEDULER_H
+#define SMB4KWRITESCHEDULER_H
+
+// application specific includes
+#include "smb4kcore_export.h"
+
+// Qt includes
+#include <QElapsedTimer>
+#include <QObject>
+#include <QTimer>
+
+/**
+ * This class collects the write requests for a data file that arrive in
+ * a short period of time and emits one write() signal for all of them.
+ * Pending requests are carried out before the application quits.
+ *
+ * @author Alexander Reinholdt <alexander.reinholdt@kdemail.net>
+ * @since 4.1.0
+ */
+
+class SMB4KCORE_EXPORT Smb4KWriteScheduler : public QObject
+{
+    Q_OBJECT
+
+public:
+    /**
+     * Constructor
+     */
+    explicit Smb4KWriteScheduler(QObject *parent = nullptr);
+
+    /**
+     * Destructor
+     */
+    virtual ~Smb4KWriteScheduler();
+
+    /**
+     * Request that the data is written. The write() signal is emitted
+     * after a short delay, that is prolonged by every further request
+     * up to a maximum.
+     */
+    void schedule();
+
+    /**
+     * Emit the write() signal immediately if a request is pending.
+     */
+    void flush();
+
+    /**
+     * Returns TRUE if a request is pending.
+     */
+    bool isPending() const;
+
+Q_SIGNALS:
+    /**
+     * Emitted when the data should be written to the disk
+     */
+    void write();
+
+private:
+    QTimer m_timer;
+    QElapsedTimer m_pendingSince;
+};
+
+#endif
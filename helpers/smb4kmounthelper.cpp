@@ -1,7 +1,7 @@
 /*
     The helper that mounts and unmounts shares.
 
-    SPDX-FileCopyrightText: 2010-2025 Alexander Reinholdt <alexander.reinholdt@kdemail.net>
+    SPDX-FileCopyrightText: 2010-2026 Alexander Reinholdt <alexander.reinholdt@kdemail.net>
     SPDX-License-Identifier: GPL-2.0-or-later
 */
 
@@ -12,8 +12,11 @@
 // Qt includes
 #include <QDebug>
 #include <QDir>
+#include <QEventLoop>
+#include <QHash>
 #include <QNetworkInterface>
 #include <QProcessEnvironment>
+#include <QTimer>
 #include <QUrl>
 
 // KDE includes
@@ -30,6 +33,9 @@ using namespace Smb4KGlobal;
 
 KAUTH_HELPER_MAIN("org.kde.smb4k.mounthelper", Smb4KMountHelper);
 
+// The time in milliseconds after which a mount or unmount process is killed
+static const int PROCESS_TIMEOUT = 30000;
+
 static const QStringList MOUNT_ARG_WHITELIST{QStringList{
 #if defined(Q_OS_LINUX)
     QStringLiteral("domain"),      QStringLiteral("ip"),         QStringLiteral("username"),    QStringLiteral("guest"),
@@ -68,117 +74,126 @@ KAuth::ActionReply Smb4KMountHelper::mount(const QVariantMap &args)
         return errorReply(i18n("The computer is not online."));
     }
 
-    QString mountPoint;
-    QUrl shareUrl = args[QStringLiteral("mh_url")].toUrl();
+    KProcess proc(this);
+    QString errorMessage;
 
-    if (auto mp = createMountPoint(shareUrl)) {
-        mountPoint = *mp;
-    } else {
-        return errorReply(i18n("Could not create mount point for share %1.", shareUrl.toDisplayString()));
+    if (!prepareMount(args, &proc, &errorMessage)) {
+        return errorReply(errorMessage);
     }
 
-    const QString mount = findMountExecutable();
+    proc.start();
 
-    if (mount.isEmpty()) {
-        return errorReply(i18n("The mount command could not be found."));
+    if (proc.waitForStarted(-1)) {
+        waitForProcesses({&proc});
+
+        if (proc.exitStatus() == KProcess::NormalExit) {
+            QString stdErr = QString::fromUtf8(proc.readAllStandardError());
+            reply.addData(QStringLiteral("mh_error_message"), stdErr.trimmed());
+        }
+    } else {
+        return errorReply(i18n("The mount process could not be started."));
     }
 
-    QStringList mountOptions = args[QStringLiteral("mh_options")].toStringList();
+    return reply;
+}
 
-    if (!checkMountArguments(&mountOptions)) {
-        return errorReply(i18n("Forbidden mount options were passed."));
-    }
+KAuth::ActionReply Smb4KMountHelper::mountbatch(const QVariantMap &args)
+{
+    ActionReply reply;
 
-    if (args.contains(QStringLiteral("mh_use_ids")) && args[QStringLiteral("mh_use_ids")].toBool()) {
-        QString uid = KUser(HelperSupport::callerUid()).userId().toString();
-        QString gid = KUser(HelperSupport::callerUid()).groupId().toString();
-#if defined(Q_OS_LINUX)
-        mountOptions << QStringLiteral("uid=") + uid;
-        mountOptions << QStringLiteral("gid=") + gid;
-#elif defined(Q_OS_FREEBSD) || defined(Q_OS_NETBSD)
-        mountOptions << QStringLiteral("-u");
-        mountOptions << uid;
-        mountOptions << QStringLiteral("-g");
-        mountOptions << gid;
-#endif
+    if (!isOnline()) {
+        return errorReply(i18n("The computer is not online."));
     }
 
-    QStringList command;
-#if defined(Q_OS_LINUX)
-    command << mount;
-    command << shareUrl.toString(QUrl::RemoveScheme | QUrl::RemoveUserInfo | QUrl::RemovePort);
-    command << mountPoint;
-    if (!mountOptions.join(QString()).trimmed().isEmpty()) {
-        command << QStringLiteral("-o");
-        command << mountOptions.join(QStringLiteral(","));
-    }
-#elif defined(Q_OS_FREEBSD) || defined(Q_OS_NETBSD)
-    command << mount;
-    if (!mountOptions.join(QString()).trimmed().isEmpty()) {
-        command << mountOptions;
-    }
-    command << shareUrl.toString(QUrl::RemoveScheme | QUrl::RemoveUserInfo | QUrl::RemovePort);
-    command << mountPoint;
-#endif
+    //
+    // The shares of one server are mounted one after the other, while the
+    // shares of different servers are mounted at the same time. The result
+    // of each mount is stored at the same position in the results list as
+    // its arguments in the mh_mounts list.
+    //
+    const QVariantList mounts = args[QStringLiteral("mh_mounts")].toList();
+    QVariantList results;
+    QStringList servers;
+    QHash<QString, QList<int>> serverMounts;
 
-    KProcess proc(this);
-    proc.setOutputChannelMode(KProcess::SeparateChannels);
-    proc.setProcessEnvironment(QProcessEnvironment::systemEnvironment());
-#if defined(Q_OS_LINUX)
-    proc.setEnv(QStringLiteral("PASSWD"), args[QStringLiteral("mh_url")].toUrl().password(), true);
-#elif defined(Q_OS_FREEBSD) || defined(Q_OS_NETBSD)
-    // We need this to avoid a translated password prompt.
-    proc.setEnv(QStringLiteral("LANG"), QStringLiteral("C"));
-#endif
-    // If the location of a Kerberos ticket is passed, it needs to
-    // be passed to the process environment here.
-    if (args.contains(QStringLiteral("mh_krb5ticket"))) {
-        auto ticketFd = args[QStringLiteral("mh_krb5ticket")].value<QDBusUnixFileDescriptor>();
+    for (int i = 0; i < mounts.size(); ++i) {
+        QString server = mounts.at(i).toMap().value(QStringLiteral("mh_url")).toUrl().host().toCaseFolded();
 
-        if (!checkFileDescriptor(ticketFd)) {
-            return errorReply(i18n("There is something wrong with the provided Kerberos ticket."));
+        if (!serverMounts.contains(server)) {
+            servers << server;
         }
 
-        QString krb5ccFile = QString(QStringLiteral("/proc/self/fd/%1")).arg(ticketFd.fileDescriptor());
-        proc.setEnv(QStringLiteral("KRB5CCNAME"), krb5ccFile);
+        serverMounts[server] << i;
+        results << QVariantMap();
     }
 
-    proc.setProgram(command);
-    proc.start();
+    //
+    // In every round, start the next mount process of each server
+    //
+    while (!serverMounts.isEmpty()) {
+        QList<KProcess *> processes;
+        QList<int> processIndexes;
 
-    if (proc.waitForStarted(-1)) {
-        int timeout = 0;
-
-        while (proc.state() != KProcess::NotRunning) {
-            // We want to be able to terminate the process from outside.
-            // Thus, we implement a loop that checks periodically, if we
-            // need to kill the process. It is non-blocking.
-            if (HelperSupport::isStopped() || timeout == 30000) {
-                proc.kill();
-                break;
+        for (const QString &server : std::as_const(servers)) {
+            if (!serverMounts.contains(server)) {
+                continue;
             }
-#if defined(Q_OS_FREEBSD) || defined(Q_OS_NETBSD)
-            // Check if there is a password prompt. If there is one, pass
-            // the password to it.
-            QByteArray out = proc.readAllStandardError();
-
-            if (out.startsWith("Password")) {
-                proc.write(args[QStringLiteral("mh_url")].toUrl().password().toUtf8().data());
-                proc.write("\r");
+
+            QList<int> &indexes = serverMounts[server];
+            int i = indexes.takeFirst();
+
+            if (indexes.isEmpty()) {
+                serverMounts.remove(server);
             }
-#endif
-            timeout += 10;
-            wait(10);
+
+            QVariantMap result;
+            QString errorMessage;
+
+            KProcess *proc = new KProcess(this);
+
+            if (prepareMount(mounts.at(i).toMap(), proc, &errorMessage)) {
+                proc->start();
+
+                if (proc->waitForStarted(-1)) {
+                    processes << proc;
+                    processIndexes << i;
+                    continue;
+                }
+
+                result.insert(QStringLiteral("mh_error_message"), i18n("The mount process could not be started."));
+            } else {
+                result.insert(QStringLiteral("mh_error_message"), errorMessage);
+            }
+
+            results[i] = result;
+            delete proc;
         }
 
-        if (proc.exitStatus() == KProcess::NormalExit) {
-            QString stdErr = QString::fromUtf8(proc.readAllStandardError());
-            reply.addData(QStringLiteral("mh_error_message"), stdErr.trimmed());
+        waitForProcesses(processes);
+
+        for (int j = 0; j < processes.size(); ++j) {
+            KProcess *proc = processes.at(j);
+
+            if (proc->exitStatus() == KProcess::NormalExit) {
+                QVariantMap result;
+                QString stdErr = QString::fromUtf8(proc->readAllStandardError());
+                result.insert(QStringLiteral("mh_error_message"), stdErr.trimmed());
+                results[processIndexes.at(j)] = result;
+            }
+        }
+
+        qDeleteAll(processes);
+
+        //
+        // Do not start further mounts if the action was stopped
+        //
+        if (HelperSupport::isStopped()) {
+            break;
         }
-    } else {
-        return errorReply(i18n("The mount process could not be started."));
     }
 
+    reply.addData(QStringLiteral("mh_results"), results);
+
     return reply;
 }
 
@@ -223,20 +238,7 @@ KAuth::ActionReply Smb4KMountHelper::unmount(const QVariantMap &args)
         proc.start();
 
         if (proc.waitForStarted(-1)) {
-            // We want to be able to terminate the process from outside.
-            // Thus, we implement a loop that checks periodically, if we
-            // need to kill the process. It is non-blocking.
-            int timeout = 0;
-
-            while (proc.state() != KProcess::NotRunning) {
-                if (HelperSupport::isStopped() || timeout == 30000) {
-                    proc.kill();
-                    break;
-                }
-
-                timeout += 10;
-                wait(10);
-            }
+            waitForProcesses({&proc});
 
             if (proc.exitStatus() == KProcess::NormalExit) {
                 QString stdErr = QString::fromUtf8(proc.readAllStandardError());
@@ -254,6 +256,148 @@ KAuth::ActionReply Smb4KMountHelper::unmount(const QVariantMap &args)
     return reply;
 }
 
+bool Smb4KMountHelper::prepareMount(const QVariantMap &args, KProcess *proc, QString *errorMessage)
+{
+    QString mountPoint;
+    QUrl shareUrl = args[QStringLiteral("mh_url")].toUrl();
+
+    if (auto mp = createMountPoint(shareUrl)) {
+        mountPoint = *mp;
+    } else {
+        *errorMessage = i18n("Could not create mount point for share %1.", shareUrl.toDisplayString());
+        return false;
+    }
+
+    const QString mount = findMountExecutable();
+
+    if (mount.isEmpty()) {
+        *errorMessage = i18n("The mount command could not be found.");
+        return false;
+    }
+
+    QStringList mountOptions = args[QStringLiteral("mh_options")].toStringList();
+
+    if (!checkMountArguments(&mountOptions)) {
+        *errorMessage = i18n("Forbidden mount options were passed.");
+        return false;
+    }
+
+    if (args.contains(QStringLiteral("mh_use_ids")) && args[QStringLiteral("mh_use_ids")].toBool()) {
+        QString uid = KUser(HelperSupport::callerUid()).userId().toString();
+        QString gid = KUser(HelperSupport::callerUid()).groupId().toString();
+#if defined(Q_OS_LINUX)
+        mountOptions << QStringLiteral("uid=") + uid;
+        mountOptions << QStringLiteral("gid=") + gid;
+#elif defined(Q_OS_FREEBSD) || defined(Q_OS_NETBSD)
+        mountOptions << QStringLiteral("-u");
+        mountOptions << uid;
+        mountOptions << QStringLiteral("-g");
+        mountOptions << gid;
+#endif
+    }
+
+    QStringList command;
+#if defined(Q_OS_LINUX)
+    command << mount;
+    command << shareUrl.toString(QUrl::RemoveScheme | QUrl::RemoveUserInfo | QUrl::RemovePort);
+    command << mountPoint;
+    if (!mountOptions.join(QString()).trimmed().isEmpty()) {
+        command << QStringLiteral("-o");
+        command << mountOptions.join(QStringLiteral(","));
+    }
+#elif defined(Q_OS_FREEBSD) || defined(Q_OS_NETBSD)
+    command << mount;
+    if (!mountOptions.join(QString()).trimmed().isEmpty()) {
+        command << mountOptions;
+    }
+    command << shareUrl.toString(QUrl::RemoveScheme | QUrl::RemoveUserInfo | QUrl::RemovePort);
+    command << mountPoint;
+#endif
+
+    proc->setOutputChannelMode(KProcess::SeparateChannels);
+    proc->setProcessEnvironment(QProcessEnvironment::systemEnvironment());
+#if defined(Q_OS_LINUX)
+    proc->setEnv(QStringLiteral("PASSWD"), shareUrl.password(), true);
+#elif defined(Q_OS_FREEBSD) || defined(Q_OS_NETBSD)
+    // We need this to avoid a translated password prompt.
+    proc->setEnv(QStringLiteral("LANG"), QStringLiteral("C"));
+
+    // Check if there is a password prompt. If there is one, pass
+    // the password to it.
+    QByteArray password = shareUrl.password().toUtf8();
+
+    connect(proc, &KProcess::readyReadStandardError, proc, [proc, password]() {
+        QByteArray out = proc->readAllStandardError();
+
+        if (out.startsWith("Password")) {
+            proc->write(password);
+            proc->write("\r");
+        }
+    });
+#endif
+    // If the location of a Kerberos ticket is passed, it needs to
+    // be passed to the process environment here.
+    if (args.contains(QStringLiteral("mh_krb5ticket"))) {
+        auto ticketFd = args[QStringLiteral("mh_krb5ticket")].value<QDBusUnixFileDescriptor>();
+
+        if (!checkFileDescriptor(ticketFd)) {
+            *errorMessage = i18n("There is something wrong with the provided Kerberos ticket.");
+            return false;
+        }
+
+        QString krb5ccFile = QString(QStringLiteral("/proc/self/fd/%1")).arg(ticketFd.fileDescriptor());
+        proc->setEnv(QStringLiteral("KRB5CCNAME"), krb5ccFile);
+    }
+
+    proc->setProgram(command);
+
+    return true;
+}
+
+void Smb4KMountHelper::waitForProcesses(const QList<KProcess *> &processes) const
+{
+    QEventLoop loop;
+    int running = 0;
+
+    for (KProcess *proc : processes) {
+        if (proc->state() == KProcess::NotRunning) {
+            continue;
+        }
+
+        running++;
+
+        connect(proc, &KProcess::finished, &loop, [&running, &loop]() {
+            if (--running == 0) {
+                loop.quit();
+            }
+        });
+
+        // Each process has its own timeout
+        QTimer::singleShot(PROCESS_TIMEOUT, proc, [proc]() {
+            proc->kill();
+        });
+    }
+
+    if (running == 0) {
+        return;
+    }
+
+    // We want to be able to terminate the processes from outside.
+    QTimer stopTimer;
+    stopTimer.setInterval(100);
+
+    connect(&stopTimer, &QTimer::timeout, &loop, [&processes]() {
+        if (HelperSupport::isStopped()) {
+            for (KProcess *proc : processes) {
+                proc->kill();
+            }
+        }
+    });
+
+    stopTimer.start();
+    loop.exec();
+}
+
 bool Smb4KMountHelper::isOnline() const
 {
     // FIXME: Do not allow virtual networks
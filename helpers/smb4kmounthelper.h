@@ -1,7 +1,7 @@
 /*
     The helper that mounts and unmounts shares.
 
-    SPDX-FileCopyrightText: 2010-2025 Alexander Reinholdt <alexander.reinholdt@kdemail.net>
+    SPDX-FileCopyrightText: 2010-2026 Alexander Reinholdt <alexander.reinholdt@kdemail.net>
     SPDX-License-Identifier: GPL-2.0-or-later
 */
 
@@ -17,6 +17,8 @@
 
 using namespace KAuth;
 
+class KProcess;
+
 class Smb4KMountHelper : public QObject
 {
     Q_OBJECT
@@ -27,12 +29,22 @@ public Q_SLOTS:
      */
     KAuth::ActionReply mount(const QVariantMap &args);
 
+    /**
+     * Mounts several CIFS/SMBFS shares. The shares of different servers are
+     * mounted concurrently, those of the same server one after the other. The
+     * argument maps of the shares are passed in the mh_mounts list. The results
+     * are returned in the mh_results list in the same order.
+     */
+    KAuth::ActionReply mountbatch(const QVariantMap &args);
+
     /**
      * Unmounts a CIFS/SMBFS share.
      */
     KAuth::ActionReply unmount(const QVariantMap &args);
 
 private:
+    bool prepareMount(const QVariantMap &args, KProcess *proc, QString *errorMessage);
+    void waitForProcesses(const QList<KProcess *> &processes) const;
     bool isOnline() const;
     bool checkMountArguments(QStringList *argList) const;
     bool checkUnmountArguments(QStringList *argList) const;
@@ -1,5 +1,5 @@
 /*
-    SPDX-FileCopyrightText: 2017-2024 Alexander Reinholdt <alexander.reinholdt@kdemail.net>
+    SPDX-FileCopyrightText: 2017-2026 Alexander Reinholdt <alexander.reinholdt@kdemail.net>
 
     SPDX-License-Identifier: GPL-2.0-or-later
 */
@@ -18,6 +18,11 @@ PlasmaComponents.Page {
   
   property var parentObject: null
 
+  onParentObjectChanged: {
+    networkBrowserItemDelegateModel.filter()
+    networkBrowserListView.currentIndex = 0
+  }
+
   ColumnLayout {
     anchors.fill: parent
 
@@ -86,6 +91,7 @@ PlasmaComponents.Page {
               switch (parentObject.type) {
                 case NetworkObject.Workgroup:
                   networkBrowserListView.currentIndex = -1
+                  parentObject = null
                   iface.lookup()
                   break
                 case NetworkObject.Host:
@@ -149,11 +155,32 @@ PlasmaComponents.Page {
   }
   
   //
-  // Delegate Model (used for sorting)
+  // Delegate Model (used for filtering and sorting)
   //
   DelegateModel {
     id: networkBrowserItemDelegateModel
 
+    function accepts(object) {
+      var accept = false
+
+      if (parentObject === null) {
+        accept = (object.type == NetworkObject.Workgroup)
+      }
+      else {
+        switch (parentObject.type) {
+          case NetworkObject.Workgroup:
+            accept = (object.workgroupName == parentObject.workgroupName)
+            break
+          case NetworkObject.Host:
+            accept = (object.hostName == parentObject.hostName)
+            break
+          default:
+            break
+        }
+      }
+      return accept
+    }
+
     function lessThan(left, right) {
       var less = false
 
@@ -193,6 +220,12 @@ PlasmaComponents.Page {
     function sort() {
       while (unsortedItems.count > 0) {
         var item = unsortedItems.get(0)
+
+        if (!accepts(item.model.object)) {
+          item.groups = "filtered"
+          continue
+        }
+
         var index = insertPosition(item)
 
         item.groups = "items"
@@ -200,6 +233,11 @@ PlasmaComponents.Page {
       }
     }
 
+    function filter() {
+      items.setGroups(0, items.count, "unsorted")
+      filteredItems.setGroups(0, filteredItems.count, "unsorted")
+    }
+
     items.includeByDefault: false
 
     groups: [
@@ -212,12 +250,31 @@ PlasmaComponents.Page {
         onChanged: {
           networkBrowserItemDelegateModel.sort()
         }
+      },
+      DelegateModelGroup {
+        id: filteredItems
+        name: "filtered"
+
+        includeByDefault: false
       }
     ]
 
     filterOnGroup: "items"
 
-    model: ListModel {}
+    model: {
+      if (parentObject === null) {
+        return iface.workgroups
+      }
+
+      switch (parentObject.type) {
+        case NetworkObject.Workgroup:
+          return iface.hosts
+        case NetworkObject.Host:
+          return iface.shares
+        default:
+          return null
+      }
+    }
 
     delegate: NetworkBrowserItemDelegate {
       id: networkBrowserItemDelegate
@@ -244,26 +301,6 @@ PlasmaComponents.Page {
     }
   }
 
-  //
-  // Connections
-  //
-  Connections {
-    target: iface
-    function onWorkgroupsChanged() { getWorkgroups() }
-    function onHostsChanged() { getHosts() }
-    function onSharesChanged() { getShares() }
-    function onMountedSharesListChanged() { shareMountedOrUnmounted() }
-  }
-  
-  //
-  // Initialization
-  //
-  Component.onCompleted: {
-    if (networkBrowserListView.count == 0) {
-      getWorkgroups()
-    }
-  }  
-  
   //
   // Functions
   //
@@ -285,65 +322,4 @@ PlasmaComponents.Page {
       }
     }
   }
-  
-  function getWorkgroups() {
-    while (networkBrowserItemDelegateModel.model.count != 0) {
-      networkBrowserItemDelegateModel.model.remove(0)
-    }
-    
-    if (iface.workgroups.length != 0) {
-      for (var i = 0; i < iface.workgroups.length; i++) {
-        networkBrowserItemDelegateModel.model.append({"object": iface.workgroups[i]})
-      }
-    }
-    
-    networkBrowserListView.currentIndex = 0
-  }
-  
-  function getHosts() {
-    var workgroupName = parentObject.workgroupName
-    
-    while (networkBrowserItemDelegateModel.model.count != 0) {
-      networkBrowserItemDelegateModel.model.remove(0)
-    }
-    
-    if (iface.hosts.length != 0) {
-      for (var i = 0; i < iface.hosts.length; i++) {
-        if (workgroupName.length != 0 && workgroupName == iface.hosts[i].workgroupName) {
-          networkBrowserItemDelegateModel.model.append({"object": iface.hosts[i]})
-        }
-      }
-    }
-    
-    networkBrowserListView.currentIndex = 0
-  }
-  
-  function getShares() {
-    var hostName = parentObject.hostName
-    
-    while (networkBrowserItemDelegateModel.model.count != 0) {
-      networkBrowserItemDelegateModel.model.remove(0)
-    }
-    
-    if (iface.shares.length != 0) {
-      for (var i = 0; i < iface.shares.length; i++) {
-        if (hostName.length != 0 && hostName == iface.shares[i].hostName) {
-          networkBrowserItemDelegateModel.model.append({"object": iface.shares[i]})
-        }
-      }
-    }
-    
-    networkBrowserListView.currentIndex = 0
-  }
-  
-  function shareMountedOrUnmounted() {
-    for (var i = 0; i < networkBrowserItemDelegateModel.model.count; i++) {
-      var object = networkBrowserItemDelegateModel.model.get(i).object
-      
-      if (object !== null && object.type == NetworkObject.Share) {
-        object.isMounted = iface.isShareMounted(object.url)
-        networkBrowserItemDelegateModel.model.set(i, {"object": object})
-      }
-    }
-  }
 }
@@ -1,5 +1,5 @@
 /*
-    SPDX-FileCopyrightText: 2017-2024 Alexander Reinholdt <alexander.reinholdt@kdemail.net>
+    SPDX-FileCopyrightText: 2017-2026 Alexander Reinholdt <alexander.reinholdt@kdemail.net>
 
     SPDX-License-Identifier: GPL-2.0-or-later
 */
@@ -111,7 +111,7 @@ PlasmaComponents.Page {
 
     filterOnGroup: "items"
     
-    model: ListModel {}
+    model: iface.mountedShares
     
     delegate: SharesViewItemDelegate {
       id: sharesViewItemDelegate
@@ -163,41 +163,4 @@ PlasmaComponents.Page {
       highlightRangeMode: ListView.StrictlyEnforceRange
     }
   }
-  
-  //
-  // Connections
-  //
-  Connections {
-    target: iface
-    function onMountedSharesListChanged() { shareMountedOrUnmounted() }
-  }
-  
-  //
-  // Initialization
-  //
-  Component.onCompleted: {
-    if (sharesViewListView.count == 0) {
-      shareMountedOrUnmounted()
-    }
-  }
-  
-  //
-  // Functions
-  //
-  function shareMountedOrUnmounted() {
-    console.log("Share mounted or unmounted ...")
-    while (sharesViewItemDelegateModel.model.count != 0) {
-      sharesViewItemDelegateModel.model.remove(0)
-    }
-    
-    for (var i = 0; i < iface.mountedShares.length; i++) {
-      var mountedShare = iface.mountedShares[i]
-      
-      if (mountedShare !== null) {
-        sharesViewItemDelegateModel.model.append({"object": mountedShare})
-      }
-    }
-    
-    sharesViewListView.currentIndex = 0
-  }
 }
@@ -29,6 +29,7 @@
 #include "smb4kbookmarkobject.h"
 #include "smb4kmountdialog.h"
 #include "smb4knetworkobject.h"
+#include "smb4knetworkobjectmodel.h"
 #include "smb4kprofileobject.h"
 
 //
@@ -45,10 +46,10 @@
 class Smb4KDeclarativePrivate
 {
 public:
-    QList<Smb4KNetworkObject *> workgroupObjects;
-    QList<Smb4KNetworkObject *> hostObjects;
-    QList<Smb4KNetworkObject *> shareObjects;
-    QList<Smb4KNetworkObject *> mountedObjects;
+    Smb4KNetworkObjectModel *workgroupModel;
+    Smb4KNetworkObjectModel *hostModel;
+    Smb4KNetworkObjectModel *shareModel;
+    Smb4KNetworkObjectModel *mountedModel;
     QList<Smb4KBookmarkObject *> bookmarkObjects;
     QList<Smb4KBookmarkObject *> bookmarkCategoryObjects;
     QList<Smb4KProfileObject *> profileObjects;
@@ -63,6 +64,10 @@ Smb4KDeclarative::Smb4KDeclarative(QObject *parent)
 {
     d->passwordDialog = new Smb4KPasswordDialog();
     d->timerId = 0;
+    d->workgroupModel = new Smb4KNetworkObjectModel(Smb4KNetworkObjectModel::UrlKey, this);
+    d->hostModel = new Smb4KNetworkObjectModel(Smb4KNetworkObjectModel::UrlKey, this);
+    d->shareModel = new Smb4KNetworkObjectModel(Smb4KNetworkObjectModel::UrlKey, this);
+    d->mountedModel = new Smb4KNetworkObjectModel(Smb4KNetworkObjectModel::MountpointKey, this);
 
     Smb4KNotification::setComponentName(QStringLiteral("smb4k"));
 
@@ -87,6 +92,8 @@ Smb4KDeclarative::Smb4KDeclarative(QObject *parent)
     //
     // Do the initial loading of items
     //
+    slotWorkgroupsListChanged();
+    slotMountedSharesListChanged();
     slotBookmarksListChanged();
     slotProfilesListChanged(Smb4KProfileManager::self()->profilesList());
     slotActiveProfileChanged(Smb4KProfileManager::self()->activeProfile());
@@ -95,18 +102,6 @@ Smb4KDeclarative::Smb4KDeclarative(QObject *parent)
 
 Smb4KDeclarative::~Smb4KDeclarative()
 {
-    qDeleteAll(d->workgroupObjects);
-    d->workgroupObjects.clear();
-
-    qDeleteAll(d->hostObjects);
-    d->hostObjects.clear();
-
-    qDeleteAll(d->shareObjects);
-    d->shareObjects.clear();
-
-    qDeleteAll(d->mountedObjects);
-    d->mountedObjects.clear();
-
     qDeleteAll(d->bookmarkObjects);
     d->bookmarkObjects.clear();
 
@@ -117,24 +112,24 @@ Smb4KDeclarative::~Smb4KDeclarative()
     d->profileObjects.clear();
 }
 
-QQmlListProperty<Smb4KNetworkObject> Smb4KDeclarative::workgroups()
+Smb4KNetworkObjectModel *Smb4KDeclarative::workgroups() const
 {
-    return QQmlListProperty<Smb4KNetworkObject>(this, &d->workgroupObjects);
+    return d->workgroupModel;
 }
 
-QQmlListProperty<Smb4KNetworkObject> Smb4KDeclarative::hosts()
+Smb4KNetworkObjectModel *Smb4KDeclarative::hosts() const
 {
-    return QQmlListProperty<Smb4KNetworkObject>(this, &d->hostObjects);
+    return d->hostModel;
 }
 
-QQmlListProperty<Smb4KNetworkObject> Smb4KDeclarative::shares()
+Smb4KNetworkObjectModel *Smb4KDeclarative::shares() const
 {
-    return QQmlListProperty<Smb4KNetworkObject>(this, &d->shareObjects);
+    return d->shareModel;
 }
 
-QQmlListProperty<Smb4KNetworkObject> Smb4KDeclarative::mountedShares()
+Smb4KNetworkObjectModel *Smb4KDeclarative::mountedShares() const
 {
-    return QQmlListProperty<Smb4KNetworkObject>(this, &d->mountedObjects);
+    return d->mountedModel;
 }
 
 QQmlListProperty<Smb4KBookmarkObject> Smb4KDeclarative::bookmarks()
@@ -201,36 +196,15 @@ Smb4KNetworkObject *Smb4KDeclarative::findNetworkItem(const QUrl &url, int type)
     if (url.isValid()) {
         switch (type) {
         case Smb4KNetworkObject::Workgroup: {
-            for (Smb4KNetworkObject *obj : std::as_const(d->workgroupObjects)) {
-                if (url == obj->url()) {
-                    object = obj;
-                    break;
-                } else {
-                    continue;
-                }
-            }
+            object = d->workgroupModel->find(url);
             break;
         }
         case Smb4KNetworkObject::Host: {
-            for (Smb4KNetworkObject *obj : std::as_const(d->hostObjects)) {
-                if (url == obj->url()) {
-                    object = obj;
-                    break;
-                } else {
-                    continue;
-                }
-            }
+            object = d->hostModel->find(url);
             break;
         }
         case Smb4KNetworkObject::Share: {
-            for (Smb4KNetworkObject *obj : std::as_const(d->shareObjects)) {
-                if (url == obj->url()) {
-                    object = obj;
-                    break;
-                } else {
-                    continue;
-                }
-            }
+            object = d->shareModel->find(url);
             break;
         }
         default: {
@@ -393,7 +367,9 @@ void Smb4KDeclarative::editBookmarks()
 void Smb4KDeclarative::synchronize(Smb4KNetworkObject *object)
 {
     if (object && object->type() == Smb4KNetworkObject::Share) {
-        for (const SharePtr &share : Smb4KGlobal::mountedSharesList()) {
+        const QList<SharePtr> mountedShares = Smb4KGlobal::mountedSharesList();
+
+        for (const SharePtr &share : mountedShares) {
             if (share->url() == object->url()) {
                 QPointer<Smb4KSynchronizationDialog> synchronizationDialog = new Smb4KSynchronizationDialog();
                 if (synchronizationDialog->setShare(share)) {
@@ -413,7 +389,9 @@ void Smb4KDeclarative::openCustomOptionsDialog(Smb4KNetworkObject *object)
 
         switch (object->type()) {
         case Smb4KNetworkObject::Host: {
-            for (const HostPtr &host : Smb4KGlobal::hostsList()) {
+            const QList<HostPtr> hosts = Smb4KGlobal::hostsList();
+
+            for (const HostPtr &host : hosts) {
                 if (host->url() == object->url()) {
                     networkItem = host;
                     break;
@@ -422,7 +400,9 @@ void Smb4KDeclarative::openCustomOptionsDialog(Smb4KNetworkObject *object)
             break;
         }
         case Smb4KNetworkObject::Share: {
-            for (const SharePtr &share : Smb4KGlobal::sharesList()) {
+            const QList<SharePtr> shares = Smb4KGlobal::sharesList();
+
+            for (const SharePtr &share : shares) {
                 if (share->url() == object->url()) {
                     networkItem = share;
                     break;
@@ -555,47 +535,64 @@ void Smb4KDeclarative::timerEvent(QTimerEvent *event)
 
 void Smb4KDeclarative::slotWorkgroupsListChanged()
 {
-    qDeleteAll(d->workgroupObjects);
-    d->workgroupObjects.clear();
+    const auto workgroupsList = Smb4KGlobal::workgroupsList();
+    QList<NetworkItemPtr> workgroups;
 
-    for (const WorkgroupPtr &workgroup : Smb4KGlobal::workgroupsList()) {
-        d->workgroupObjects << new Smb4KNetworkObject(workgroup.data());
+    for (const WorkgroupPtr &workgroup : workgroupsList) {
+        workgroups << workgroup;
     }
 
+    d->workgroupModel->setNetworkItems(workgroups);
+
     Q_EMIT workgroupsListChanged();
 }
 
 void Smb4KDeclarative::slotHostsListChanged()
 {
-    qDeleteAll(d->hostObjects);
-    d->hostObjects.clear();
+    const auto hostsList = Smb4KGlobal::hostsList();
+    QList<NetworkItemPtr> hosts;
 
-    for (const HostPtr &host : Smb4KGlobal::hostsList()) {
-        d->hostObjects << new Smb4KNetworkObject(host.data());
+    for (const HostPtr &host : hostsList) {
+        hosts << host;
     }
 
+    d->hostModel->setNetworkItems(hosts);
+
     Q_EMIT hostsListChanged();
 }
 
 void Smb4KDeclarative::slotSharesListChanged()
 {
-    qDeleteAll(d->shareObjects);
-    d->shareObjects.clear();
+    const auto sharesList = Smb4KGlobal::sharesList();
+    QList<NetworkItemPtr> shares;
 
-    for (const SharePtr &share : Smb4KGlobal::sharesList()) {
-        d->shareObjects << new Smb4KNetworkObject(share.data());
+    for (const SharePtr &share : sharesList) {
+        shares << share;
     }
 
+    d->shareModel->setNetworkItems(shares);
+
     Q_EMIT sharesListChanged();
 }
 
 void Smb4KDeclarative::slotMountedSharesListChanged()
 {
-    qDeleteAll(d->mountedObjects);
-    d->mountedObjects.clear();
+    const auto mountedSharesList = Smb4KGlobal::mountedSharesList();
+    QList<NetworkItemPtr> mountedShares;
+
+    for (const SharePtr &mountedShare : mountedSharesList) {
+        mountedShares << mountedShare;
+    }
+
+    d->mountedModel->setNetworkItems(mountedShares);
+
+    //
+    // Update the mount state of the shares in the network neighborhood
+    //
+    const QList<Smb4KNetworkObject *> shareObjects = d->shareModel->objects();
 
-    for (const SharePtr &mountedShare : Smb4KGlobal::mountedSharesList()) {
-        d->mountedObjects << new Smb4KNetworkObject(mountedShare.data());
+    for (Smb4KNetworkObject *object : shareObjects) {
+        object->setMounted(isShareMounted(object->url()));
     }
 
     Q_EMIT mountedSharesListChanged();
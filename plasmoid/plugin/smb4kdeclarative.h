@@ -10,6 +10,7 @@
 
 // application specific includes
 #include "core/smb4kglobal.h"
+#include "smb4knetworkobjectmodel.h"
 
 // Qt includes
 #include <QObject>
@@ -35,10 +36,10 @@ class Q_DECL_EXPORT Smb4KDeclarative : public QObject
 {
     Q_OBJECT
 
-    Q_PROPERTY(QQmlListProperty<Smb4KNetworkObject> workgroups READ workgroups NOTIFY workgroupsListChanged)
-    Q_PROPERTY(QQmlListProperty<Smb4KNetworkObject> hosts READ hosts NOTIFY hostsListChanged)
-    Q_PROPERTY(QQmlListProperty<Smb4KNetworkObject> shares READ shares NOTIFY sharesListChanged)
-    Q_PROPERTY(QQmlListProperty<Smb4KNetworkObject> mountedShares READ mountedShares NOTIFY mountedSharesListChanged)
+    Q_PROPERTY(Smb4KNetworkObjectModel *workgroups READ workgroups CONSTANT)
+    Q_PROPERTY(Smb4KNetworkObjectModel *hosts READ hosts CONSTANT)
+    Q_PROPERTY(Smb4KNetworkObjectModel *shares READ shares CONSTANT)
+    Q_PROPERTY(Smb4KNetworkObjectModel *mountedShares READ mountedShares CONSTANT)
     Q_PROPERTY(QQmlListProperty<Smb4KBookmarkObject> bookmarks READ bookmarks NOTIFY bookmarksListChanged)
     Q_PROPERTY(QQmlListProperty<Smb4KBookmarkObject> bookmarkCategories READ bookmarkCategories NOTIFY bookmarksListChanged)
     Q_PROPERTY(QQmlListProperty<Smb4KProfileObject> profiles READ profiles NOTIFY profilesListChanged)
@@ -59,40 +60,36 @@ public:
     virtual ~Smb4KDeclarative();
 
     /**
-     * This function returns the list of workgroups. Basically, this is the
-     * Smb4KGlobal::workgroupsList() list converted into a list of Smb4KNetworkItem
-     * objects.
+     * This function returns the model of the workgroups. It holds one
+     * Smb4KNetworkObject for each entry of the Smb4KGlobal::workgroupsList() list.
      *
-     * @returns the list of discovered workgroups.
+     * @returns the model of the workgroups.
      */
-    QQmlListProperty<Smb4KNetworkObject> workgroups();
+    Smb4KNetworkObjectModel *workgroups() const;
 
     /**
-     * This function returns the list of hosts. Basically, this is the
-     * Smb4KGlobal::hostsList() list converted into a list of Smb4KNetworkItem
-     * objects.
+     * This function returns the model of the hosts. It holds one
+     * Smb4KNetworkObject for each entry of the Smb4KGlobal::hostsList() list.
      *
-     * @returns the list of discovered hosts.
+     * @returns the model of the hosts.
      */
-    QQmlListProperty<Smb4KNetworkObject> hosts();
+    Smb4KNetworkObjectModel *hosts() const;
 
     /**
-     * This function returns the list of shares. Basically, this is the
-     * Smb4KGlobal::sharesList() list converted into a list of Smb4KNetworkItem
-     * objects.
+     * This function returns the model of the shares. It holds one
+     * Smb4KNetworkObject for each entry of the Smb4KGlobal::sharesList() list.
      *
-     * @returns the list of discovered shares.
+     * @returns the model of the shares.
      */
-    QQmlListProperty<Smb4KNetworkObject> shares();
+    Smb4KNetworkObjectModel *shares() const;
 
     /**
-     * This function returns the list of mounted shares. Basically, this is the
-     * Smb4KGlobal::mountedSharesList() list converted into a list of Smb4KNetworkItem
-     * objects.
+     * This function returns the model of the mounted shares. It holds one
+     * Smb4KNetworkObject for each entry of the Smb4KGlobal::mountedSharesList() list.
      *
-     * @returns the list of the mounted shares.
+     * @returns the model of the mounted shares.
      */
-    QQmlListProperty<Smb4KNetworkObject> mountedShares();
+    Smb4KNetworkObjectModel *mountedShares() const;
 
     /**
      * This function returns the list of bookmarks. Basically, this is the
@@ -356,28 +353,28 @@ Q_SIGNALS:
 protected Q_SLOTS:
     /**
      * This slot is invoked, when the list of workgroups was changed by
-     * the scanner. It rebuilds the workgroups() list and emits the
-     * worgroupsListChanged() signal.
+     * the scanner. It updates the workgroups() model and emits the
+     * workgroupsListChanged() signal.
      */
     void slotWorkgroupsListChanged();
 
     /**
      * This slot is invoked, when the list of hosts was changed by the
-     * scanner. It rebuilds the hosts() list and emits the hostsListChanged()
+     * scanner. It updates the hosts() model and emits the hostsListChanged()
      * signal.
      */
     void slotHostsListChanged();
 
     /**
      * This slot is invoked, when the list of shares was changed by the
-     * scanner. It rebuilds the shares() list and emits the sharesListChanged()
+     * scanner. It updates the shares() model and emits the sharesListChanged()
      * signal.
      */
     void slotSharesListChanged();
 
     /**
      * This slot is invoked, when the list of mounted shares was changed
-     * by the mounter. It rebuilds the mountedShares() list and emits the
+     * by the mounter. It updates the mountedShares() model and emits the
      * mountedSharesListChanged() signal.
      */
     void slotMountedSharesListChanged();
@@ -2,7 +2,7 @@
     This class derives from QObject and encapsulates the network items.
     It is for use with QtQuick.
 
-    SPDX-FileCopyrightText: 2012-2022 Alexander Reinholdt <alexander.reinholdt@kdemail.net>
+    SPDX-FileCopyrightText: 2012-2026 Alexander Reinholdt <alexander.reinholdt@kdemail.net>
     SPDX-License-Identifier: GPL-2.0-or-later
 */
 
@@ -267,8 +267,18 @@ void Smb4KNetworkObject::setMounted(bool mounted)
     }
 }
 
-void Smb4KNetworkObject::update(Smb4KBasicNetworkItem *networkItem)
+bool Smb4KNetworkObject::update(Smb4KBasicNetworkItem *networkItem)
 {
+    QString workgroup = d->workgroup;
+    QUrl url = d->url;
+    QString comment = d->comment;
+    bool mounted = d->mounted;
+    bool inaccessible = d->inaccessible;
+    bool printer = d->printer;
+    bool isMaster = d->isMaster;
+    QUrl mountpoint = d->mountpoint;
+    int type = d->type;
+
     d->icon = networkItem->icon();
 
     if (d->type == Workgroup && networkItem->type() == Smb4KGlobal::Workgroup) {
@@ -299,6 +309,7 @@ void Smb4KNetworkObject::update(Smb4KBasicNetworkItem *networkItem)
                 d->mounted = false;
                 d->inaccessible = false;
                 d->printer = false;
+                d->isMaster = host->isMasterBrowser();
             }
         }
     } else if (d->type == Share && networkItem->type() == Smb4KGlobal::Share) {
@@ -316,15 +327,25 @@ void Smb4KNetworkObject::update(Smb4KBasicNetworkItem *networkItem)
                 d->mounted = share->isMounted();
                 d->inaccessible = share->isInaccessible();
                 d->printer = share->isPrinter();
-                d->mountpoint.setUrl(share->path(), QUrl::TolerantMode);
-                d->mountpoint.setScheme(QStringLiteral("file"));
+                d->mountpoint = QUrl::fromLocalFile(share->path());
             }
         }
     } else {
         d->type = Network;
     }
 
-    Q_EMIT changed();
+    //
+    // Only notify about real changes, so that the delegates are not
+    // updated needlessly.
+    //
+    bool changed = (workgroup != d->workgroup || url != d->url || comment != d->comment || mounted != d->mounted || inaccessible != d->inaccessible
+                    || printer != d->printer || isMaster != d->isMaster || mountpoint != d->mountpoint || type != d->type);
+
+    if (changed) {
+        Q_EMIT this->changed();
+    }
+
+    return changed;
 }
 
 bool Smb4KNetworkObject::isPrinter() const
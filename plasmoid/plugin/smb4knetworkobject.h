@@ -2,7 +2,7 @@
     This class derives from QObject and encapsulates the network items.
     It is for use with QtQuick.
 
-    SPDX-FileCopyrightText: 2012-2024 Alexander Reinholdt <alexander.reinholdt@kdemail.net>
+    SPDX-FileCopyrightText: 2012-2026 Alexander Reinholdt <alexander.reinholdt@kdemail.net>
     SPDX-License-Identifier: GPL-2.0-or-later
 */
 
@@ -220,8 +220,10 @@ public:
      * Updates the network item.
      *
      * @param networkItem   The network item that needs to be updated
+     *
+     * @returns TRUE if the network object changed.
      */
-    void update(Smb4KBasicNetworkItem *networkItem);
+    bool update(Smb4KBasicNetworkItem *networkItem);
 
     /**
      * This function returns TRUE if the network item is a printer share.
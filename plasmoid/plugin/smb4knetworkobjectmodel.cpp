@@ -0,0 +1,211 @@
+/*
+    This class provides a list model of network objects for use with
+    QtQuick.
+
+    SPDX-FileCopyrightText: 2026 Alexander Reinholdt <alexander.reinholdt@kdemail.net>
+    SPDX-License-Identifier: GPL-2.0-or-later
+*/
+
+// application specific includes
+#include "smb4knetworkobjectmodel.h"
+#include "core/smb4kshare.h"
+#include "smb4knetworkobject.h"
+
+// Qt includes
+#include <QSet>
+
+class Smb4KNetworkObjectModelPrivate
+{
+public:
+    Smb4KNetworkObjectModel::Key key;
+    QList<Smb4KNetworkObject *> objects;
+    QStringList keys;
+};
+
+Smb4KNetworkObjectModel::Smb4KNetworkObjectModel(Key key, QObject *parent)
+    : QAbstractListModel(parent)
+    , d(new Smb4KNetworkObjectModelPrivate)
+{
+    d->key = key;
+}
+
+Smb4KNetworkObjectModel::~Smb4KNetworkObjectModel()
+{
+}
+
+int Smb4KNetworkObjectModel::rowCount(const QModelIndex &parent) const
+{
+    if (parent.isValid()) {
+        return 0;
+    }
+
+    return d->objects.size();
+}
+
+QVariant Smb4KNetworkObjectModel::data(const QModelIndex &index, int role) const
+{
+    if (!index.isValid() || index.row() >= d->objects.size()) {
+        return QVariant();
+    }
+
+    Smb4KNetworkObject *object = d->objects.at(index.row());
+
+    switch (role) {
+    case Qt::DisplayRole:
+    case NameRole: {
+        return object->name();
+    }
+    case ObjectRole: {
+        return QVariant::fromValue(object);
+    }
+    case WorkgroupNameRole: {
+        return object->workgroupName();
+    }
+    case HostNameRole: {
+        return object->hostName();
+    }
+    default: {
+        break;
+    }
+    }
+
+    return QVariant();
+}
+
+QHash<int, QByteArray> Smb4KNetworkObjectModel::roleNames() const
+{
+    QHash<int, QByteArray> roles;
+    roles[ObjectRole] = "object";
+    roles[NameRole] = "name";
+    roles[WorkgroupNameRole] = "workgroupName";
+    roles[HostNameRole] = "hostName";
+
+    return roles;
+}
+
+int Smb4KNetworkObjectModel::count() const
+{
+    return d->objects.size();
+}
+
+Smb4KNetworkObject *Smb4KNetworkObjectModel::object(int row) const
+{
+    if (row >= 0 && row < d->objects.size()) {
+        return d->objects.at(row);
+    }
+
+    return nullptr;
+}
+
+Smb4KNetworkObject *Smb4KNetworkObjectModel::find(const QUrl &url) const
+{
+    for (Smb4KNetworkObject *object : std::as_const(d->objects)) {
+        if (url == object->url()) {
+            return object;
+        }
+    }
+
+    return nullptr;
+}
+
+QList<Smb4KNetworkObject *> Smb4KNetworkObjectModel::objects() const
+{
+    return d->objects;
+}
+
+void Smb4KNetworkObjectModel::setNetworkItems(const QList<NetworkItemPtr> &list)
+{
+    int oldCount = d->objects.size();
+
+    QSet<QString> keys;
+
+    for (const NetworkItemPtr &networkItem : list) {
+        keys.insert(keyOf(networkItem));
+    }
+
+    //
+    // Remove the objects of the vanished network items. Adjacent rows
+    // are removed together.
+    //
+    int row = d->objects.size() - 1;
+
+    while (row >= 0) {
+        if (keys.contains(d->keys.at(row))) {
+            row--;
+            continue;
+        }
+
+        int last = row;
+
+        while (row > 0 && !keys.contains(d->keys.at(row - 1))) {
+            row--;
+        }
+
+        beginRemoveRows(QModelIndex(), row, last);
+
+        for (int i = last; i >= row; i--) {
+            d->keys.removeAt(i);
+            // The delegates might still access the object while they are destroyed
+            d->objects.takeAt(i)->deleteLater();
+        }
+
+        endRemoveRows();
+
+        row--;
+    }
+
+    //
+    // Update the objects of the known network items and collect the
+    // new ones
+    //
+    QHash<QString, int> rows;
+
+    for (int i = 0; i < d->keys.size(); i++) {
+        rows.insert(d->keys.at(i), i);
+    }
+
+    QList<NetworkItemPtr> newItems;
+    QSet<QString> newKeys;
+
+    for (const NetworkItemPtr &networkItem : list) {
+        QString key = keyOf(networkItem);
+        int index = rows.value(key, -1);
+
+        if (index != -1) {
+            if (d->objects.at(index)->update(networkItem.data())) {
+                QModelIndex changedIndex = createIndex(index, 0);
+                Q_EMIT dataChanged(changedIndex, changedIndex);
+            }
+        } else if (!newKeys.contains(key)) {
+            newKeys.insert(key);
+            newItems << networkItem;
+        }
+    }
+
+    //
+    // Append the objects for the new network items
+    //
+    if (!newItems.isEmpty()) {
+        beginInsertRows(QModelIndex(), d->objects.size(), d->objects.size() + newItems.size() - 1);
+
+        for (const NetworkItemPtr &networkItem : std::as_const(newItems)) {
+            d->objects << new Smb4KNetworkObject(networkItem.data(), this);
+            d->keys << keyOf(networkItem);
+        }
+
+        endInsertRows();
+    }
+
+    if (oldCount != d->objects.size()) {
+        Q_EMIT countChanged();
+    }
+}
+
+QString Smb4KNetworkObjectModel::keyOf(const NetworkItemPtr &networkItem) const
+{
+    if (d->key == MountpointKey && networkItem->type() == Smb4KGlobal::Share) {
+        return networkItem.staticCast<Smb4KShare>()->path();
+    }
+
+    return networkItem->url().toString(QUrl::RemoveUserInfo | QUrl::RemovePort | QUrl::StripTrailingSlash).toLower();
+}
@@ -0,0 +1,137 @@
+/*
+    This class provides a list model of network objects for use with
+    QtQuick.
+
+    SPDX-FileCopyrightText: 2026 Alexander Reinholdt <alexander.reinholdt@kdemail.net>
+    SPDX-License-Identifier: GPL-2.0-or-later
+*/
+
+#ifndef SMB4KNETWORKOBJECTMODEL_H
+#define SMB4KNETWORKOBJECTMODEL_H
+
+// application specific includes
+#include "core/smb4kglobal.h"
+
+// Qt includes
+#include <QAbstractListModel>
+#include <QScopedPointer>
+#include <QUrl>
+
+// forward declarations
+class Smb4KNetworkObject;
+class Smb4KNetworkObjectModelPrivate;
+
+/**
+ * This list model holds one Smb4KNetworkObject for each network item. The
+ * objects keep their identity as long as the network item exists, so that
+ * an update of the network items only results in the insertion, removal
+ * or change of the affected rows.
+ *
+ * @author Alexander Reinholdt <alexander.reinholdt@kdemail.net>
+ * @since 4.1.0
+ */
+
+class Q_DECL_EXPORT Smb4KNetworkObjectModel : public QAbstractListModel
+{
+    Q_OBJECT
+
+    Q_PROPERTY(int count READ count NOTIFY countChanged)
+
+public:
+    /**
+     * The key that identifies a network item
+     */
+    enum Key {
+        UrlKey,
+        MountpointKey
+    };
+
+    /**
+     * The data roles of this model
+     */
+    enum Role {
+        ObjectRole = Qt::UserRole,
+        NameRole,
+        WorkgroupNameRole,
+        HostNameRole,
+    };
+
+    /**
+     * The constructor
+     *
+     * @param key         The key that identifies the network items
+     *
+     * @param parent      The parent of this model
+     */
+    explicit Smb4KNetworkObjectModel(Key key = UrlKey, QObject *parent = nullptr);
+
+    /**
+     * The destructor
+     */
+    ~Smb4KNetworkObjectModel();
+
+    /**
+     * Returns the number of rows
+     */
+    int rowCount(const QModelIndex &parent = QModelIndex()) const override;
+
+    /**
+     * Returns the data stored under @p role for the item at @p index
+     */
+    QVariant data(const QModelIndex &index, int role = Qt::DisplayRole) const override;
+
+    /**
+     * Returns the role names used by QtQuick
+     */
+    QHash<int, QByteArray> roleNames() const override;
+
+    /**
+     * Returns the number of network objects
+     */
+    int count() const;
+
+    /**
+     * Returns the network object in row @p row or NULLPTR if there is none.
+     */
+    Q_INVOKABLE Smb4KNetworkObject *object(int row) const;
+
+    /**
+     * Returns the network object with the URL @p url or NULLPTR if there
+     * is none.
+     */
+    Smb4KNetworkObject *find(const QUrl &url) const;
+
+    /**
+     * Returns all network objects
+     */
+    QList<Smb4KNetworkObject *> objects() const;
+
+    /**
+     * Replaces the contents of this model with the network items in
+     * @p list. The objects of known network items are updated, the
+     * objects of vanished network items are removed and new objects
+     * are appended for new network items.
+     *
+     * @param list        The list of network items
+     */
+    void setNetworkItems(const QList<NetworkItemPtr> &list);
+
+Q_SIGNALS:
+    /**
+     * Emitted when the number of network objects changed
+     */
+    void countChanged();
+
+private:
+    /**
+     * Returns the key of the network item
+     */
+    QString keyOf(const NetworkItemPtr &networkItem) const;
+
+    /**
+     * Pointer to the private class
+     */
+    const QScopedPointer<Smb4KNetworkObjectModelPrivate> d;
+};
+
+#endif
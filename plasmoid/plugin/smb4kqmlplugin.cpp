@@ -1,7 +1,7 @@
 /*
     smb4kqmlplugin - The QML plugin for use with Plasma/QtQuick
 
-    SPDX-FileCopyrightText: 2012-2023 Alexander Reinholdt <alexander.reinholdt@kdemail.net>
+    SPDX-FileCopyrightText: 2012-2026 Alexander Reinholdt <alexander.reinholdt@kdemail.net>
     SPDX-License-Identifier: GPL-2.0-or-later
 */
 
@@ -10,6 +10,7 @@
 #include "smb4kbookmarkobject.h"
 #include "smb4kdeclarative.h"
 #include "smb4knetworkobject.h"
+#include "smb4knetworkobjectmodel.h"
 #include "smb4kprofileobject.h"
 
 // Qt includes
@@ -18,6 +19,7 @@
 void Smb4KQMLPlugin::registerTypes(const char *uri)
 {
     qmlRegisterType<Smb4KNetworkObject>(uri, 2, 0, "NetworkObject");
+    qmlRegisterUncreatableType<Smb4KNetworkObjectModel>(uri, 2, 0, "NetworkObjectModel", QStringLiteral("The network object models are provided by the interface"));
     qmlRegisterType<Smb4KBookmarkObject>(uri, 2, 0, "BookmarkObject");
     qmlRegisterType<Smb4KProfileObject>(uri, 2, 0, "ProfileObject");
     qmlRegisterType<Smb4KDeclarative>(uri, 2, 0, "Interface");
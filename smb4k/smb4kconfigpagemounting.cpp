@@ -134,6 +134,20 @@ void Smb4KConfigPageMounting::setupWidget()
     QCheckBox *checkServerOnlineState = new QCheckBox(Smb4KMountSettings::self()->checkServerOnlineStateItem()->label(), behaviorBox);
     checkServerOnlineState->setObjectName(QStringLiteral("kcfg_CheckServerOnlineState"));
 
+    QWidget *concurrentMountsWidget = new QWidget(behaviorBox);
+    QGridLayout *concurrentMountsWidgetLayout = new QGridLayout(concurrentMountsWidget);
+    concurrentMountsWidgetLayout->setContentsMargins(0, 0, 0, 0);
+
+    QLabel *maximumConcurrentMountsLabel = new QLabel(Smb4KMountSettings::self()->maximumConcurrentMountsItem()->label(), concurrentMountsWidget);
+    maximumConcurrentMountsLabel->setObjectName(QStringLiteral("MaximumConcurrentMountsLabel"));
+
+    QSpinBox *maximumConcurrentMounts = new QSpinBox(concurrentMountsWidget);
+    maximumConcurrentMounts->setObjectName(QStringLiteral("kcfg_MaximumConcurrentMounts"));
+    maximumConcurrentMountsLabel->setBuddy(maximumConcurrentMounts);
+
+    concurrentMountsWidgetLayout->addWidget(maximumConcurrentMountsLabel, 0, 0);
+    concurrentMountsWidgetLayout->addWidget(maximumConcurrentMounts, 0, 1);
+
     QCheckBox *unmountAllShares = new QCheckBox(Smb4KMountSettings::self()->unmountSharesOnExitItem()->label(), behaviorBox);
     unmountAllShares->setObjectName(QStringLiteral("kcfg_UnmountSharesOnExit"));
 
@@ -146,6 +160,7 @@ void Smb4KConfigPageMounting::setupWidget()
     behaviorBoxLayout->addWidget(remountShares);
     behaviorBoxLayout->addWidget(m_remountSettingsWidget);
     behaviorBoxLayout->addWidget(checkServerOnlineState);
+    behaviorBoxLayout->addWidget(concurrentMountsWidget);
     behaviorBoxLayout->addWidget(unmountAllShares);
     behaviorBoxLayout->addWidget(unmountInaccessibleShares);
     behaviorBoxLayout->addWidget(detectAllShares);
@@ -440,6 +455,20 @@ void Smb4KConfigPageMounting::setupWidget()
     QCheckBox *checkServerOnlineState = new QCheckBox(Smb4KMountSettings::self()->checkServerOnlineStateItem()->label(), behaviorBox);
     checkServerOnlineState->setObjectName(QStringLiteral("kcfg_CheckServerOnlineState"));
 
+    QWidget *concurrentMountsWidget = new QWidget(behaviorBox);
+    QGridLayout *concurrentMountsWidgetLayout = new QGridLayout(concurrentMountsWidget);
+    concurrentMountsWidgetLayout->setContentsMargins(0, 0, 0, 0);
+
+    QLabel *maximumConcurrentMountsLabel = new QLabel(Smb4KMountSettings::self()->maximumConcurrentMountsItem()->label(), concurrentMountsWidget);
+    maximumConcurrentMountsLabel->setObjectName(QStringLiteral("MaximumConcurrentMountsLabel"));
+
+    QSpinBox *maximumConcurrentMounts = new QSpinBox(concurrentMountsWidget);
+    maximumConcurrentMounts->setObjectName(QStringLiteral("kcfg_MaximumConcurrentMounts"));
+    maximumConcurrentMountsLabel->setBuddy(maximumConcurrentMounts);
+
+    concurrentMountsWidgetLayout->addWidget(maximumConcurrentMountsLabel, 0, 0);
+    concurrentMountsWidgetLayout->addWidget(maximumConcurrentMounts, 0, 1);
+
     QCheckBox *unmountAllShares = new QCheckBox(Smb4KMountSettings::self()->unmountSharesOnExitItem()->label(), behaviorBox);
     unmountAllShares->setObjectName(QStringLiteral("kcfg_UnmountSharesOnExit"));
 
@@ -449,6 +478,7 @@ void Smb4KConfigPageMounting::setupWidget()
     behaviorBoxLayout->addWidget(remountShares);
     behaviorBoxLayout->addWidget(m_remountSettingsWidget);
     behaviorBoxLayout->addWidget(checkServerOnlineState);
+    behaviorBoxLayout->addWidget(concurrentMountsWidget);
     behaviorBoxLayout->addWidget(unmountAllShares);
     behaviorBoxLayout->addWidget(detectAllShares);
 
@@ -1,7 +1,7 @@
 /*
     The configuration page for the network settings of Smb4K
 
-    SPDX-FileCopyrightText: 2003-2023 Alexander Reinholdt <alexander.reinholdt@kdemail.net>
+    SPDX-FileCopyrightText: 2003-2026 Alexander Reinholdt <alexander.reinholdt@kdemail.net>
     SPDX-License-Identifier: GPL-2.0-or-later
 */
 
@@ -120,6 +120,16 @@ Smb4KConfigPageNetwork::Smb4KConfigPageNetwork(QWidget *parent)
 
     behaviorBoxLayout->addWidget(previewHiddenItems, 1, 0);
 
+    QCheckBox *cacheNetworkNeighborhood = new QCheckBox(Smb4KSettings::self()->cacheNetworkNeighborhoodItem()->label(), behaviorBox);
+    cacheNetworkNeighborhood->setObjectName(QStringLiteral("kcfg_CacheNetworkNeighborhood"));
+
+    behaviorBoxLayout->addWidget(cacheNetworkNeighborhood, 1, 1);
+
+    QCheckBox *refreshNetworkNeighborhood = new QCheckBox(Smb4KSettings::self()->refreshNetworkNeighborhoodItem()->label(), behaviorBox);
+    refreshNetworkNeighborhood->setObjectName(QStringLiteral("kcfg_RefreshNetworkNeighborhood"));
+
+    behaviorBoxLayout->addWidget(refreshNetworkNeighborhood, 2, 0);
+
     basicTabLayout->addWidget(behaviorBox);
     basicTabLayout->addStretch(100);
 
@@ -173,6 +183,29 @@ Smb4KConfigPageNetwork::Smb4KConfigPageNetwork(QWidget *parent)
 
     sambaBoxLayout->addWidget(useCCache, 5, 0, 1, 2);
 
+    QLabel *maximumConcurrentLookupsLabel = new QLabel(Smb4KSettings::self()->maximumConcurrentLookupsItem()->label(), sambaBox);
+
+    QSpinBox *maximumConcurrentLookups = new QSpinBox(sambaBox);
+    maximumConcurrentLookups->setObjectName(QStringLiteral("kcfg_MaximumConcurrentLookups"));
+    maximumConcurrentLookups->setSingleStep(1);
+
+    maximumConcurrentLookupsLabel->setBuddy(maximumConcurrentLookups);
+
+    sambaBoxLayout->addWidget(maximumConcurrentLookupsLabel, 6, 0);
+    sambaBoxLayout->addWidget(maximumConcurrentLookups, 6, 1);
+
+    QLabel *clientContextIdleTimeLabel = new QLabel(Smb4KSettings::self()->clientContextIdleTimeItem()->label(), sambaBox);
+
+    QSpinBox *clientContextIdleTime = new QSpinBox(sambaBox);
+    clientContextIdleTime->setObjectName(QStringLiteral("kcfg_ClientContextIdleTime"));
+    clientContextIdleTime->setSuffix(i18n(" s"));
+    clientContextIdleTime->setSingleStep(10);
+
+    clientContextIdleTimeLabel->setBuddy(clientContextIdleTime);
+
+    sambaBoxLayout->addWidget(clientContextIdleTimeLabel, 7, 0);
+    sambaBoxLayout->addWidget(clientContextIdleTime, 7, 1);
+
     advancedTabLayout->addWidget(sambaBox);
 
     QGroupBox *wakeOnLanBox = new QGroupBox(i18n("Wake-On-LAN"), advancedTab);
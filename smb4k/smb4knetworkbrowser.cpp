@@ -1,7 +1,7 @@
 /*
     smb4knetworkbrowser  -  The network browser widget of Smb4K.
 
-    SPDX-FileCopyrightText: 2007-2023 Alexander Reinholdt <alexander.reinholdt@kdemail.net>
+    SPDX-FileCopyrightText: 2007-2026 Alexander Reinholdt <alexander.reinholdt@kdemail.net>
     SPDX-License-Identifier: GPL-2.0-or-later
 */
 
@@ -10,13 +10,14 @@
 #include "core/smb4kglobal.h"
 #include "core/smb4ksettings.h"
 #include "core/smb4kshare.h"
-#include "smb4knetworkbrowseritem.h"
+#include "smb4knetworkbrowsermodel.h"
 #include "smb4ktooltip.h"
 
 // Qt includes
 #include <QApplication>
 #include <QHeaderView>
 #include <QMouseEvent>
+#include <QSortFilterProxyModel>
 #include <QTimer>
 
 #include <QLayout>
@@ -27,31 +28,39 @@
 using namespace Smb4KGlobal;
 
 Smb4KNetworkBrowser::Smb4KNetworkBrowser(QWidget *parent)
-    : QTreeWidget(parent)
+    : QTreeView(parent)
 {
     setRootIsDecorated(true);
     setAllColumnsShowFocus(false);
     setMouseTracking(true);
     setSelectionMode(ExtendedSelection);
+    setUniformRowHeights(true);
 
     setContextMenuPolicy(Qt::CustomContextMenu);
 
     m_toolTip = new Smb4KToolTip(this);
 
-    QStringList header_labels;
-    header_labels.append(i18n("Network"));
-    header_labels.append(i18n("Type"));
-    header_labels.append(i18n("IP Address"));
-    header_labels.append(i18n("Comment"));
-    setHeaderLabels(header_labels);
+    //
+    // The items are sorted by the proxy model, so that the model only
+    // needs to append new items
+    //
+    m_model = new Smb4KNetworkBrowserModel(this);
+
+    m_proxyModel = new QSortFilterProxyModel(this);
+    m_proxyModel->setSourceModel(m_model);
+    m_proxyModel->setSortCaseSensitivity(Qt::CaseInsensitive);
+    m_proxyModel->setDynamicSortFilter(true);
+    m_proxyModel->sort(Network, Qt::AscendingOrder);
+
+    setModel(m_proxyModel);
 
     header()->setSectionResizeMode(QHeaderView::ResizeToContents);
 
     //
     // Connections
     //
-    connect(this, &Smb4KNetworkBrowser::itemActivated, this, &Smb4KNetworkBrowser::slotItemActivated);
-    connect(this, &Smb4KNetworkBrowser::itemSelectionChanged, this, &Smb4KNetworkBrowser::slotItemSelectionChanged);
+    connect(this, &Smb4KNetworkBrowser::activated, this, &Smb4KNetworkBrowser::slotItemActivated);
+    connect(selectionModel(), &QItemSelectionModel::selectionChanged, this, &Smb4KNetworkBrowser::slotItemSelectionChanged);
 }
 
 Smb4KNetworkBrowser::~Smb4KNetworkBrowser()
@@ -63,12 +72,44 @@ Smb4KToolTip *Smb4KNetworkBrowser::toolTip()
     return m_toolTip;
 }
 
+Smb4KNetworkBrowserModel *Smb4KNetworkBrowser::networkModel()
+{
+    return m_model;
+}
+
+NetworkItemPtr Smb4KNetworkBrowser::networkItem(const QModelIndex &index) const
+{
+    return m_model->networkItem(m_proxyModel->mapToSource(index));
+}
+
+QModelIndex Smb4KNetworkBrowser::indexOf(const NetworkItemPtr &item) const
+{
+    return m_proxyModel->mapFromSource(m_model->indexOf(item));
+}
+
+QList<NetworkItemPtr> Smb4KNetworkBrowser::selectedNetworkItems() const
+{
+    QList<NetworkItemPtr> items;
+    const QModelIndexList selectedRows = selectionModel()->selectedRows();
+
+    for (const QModelIndex &index : selectedRows) {
+        NetworkItemPtr item = networkItem(index);
+
+        if (item) {
+            items << item;
+        }
+    }
+
+    return items;
+}
+
 bool Smb4KNetworkBrowser::event(QEvent *e)
 {
     switch (e->type()) {
     case QEvent::ToolTip: {
         QPoint pos = viewport()->mapFromGlobal(cursor().pos());
-        Smb4KNetworkBrowserItem *item = static_cast<Smb4KNetworkBrowserItem *>(itemAt(pos));
+        QModelIndex index = indexAt(pos);
+        NetworkItemPtr item = networkItem(index);
 
         if (item) {
             if (Smb4KSettings::showNetworkItemToolTip()) {
@@ -90,7 +131,7 @@ bool Smb4KNetworkBrowser::event(QEvent *e)
                 }
 
                 if (pos.x() > ind * indentation()) {
-                    m_toolTip->setupToolTip(Smb4KToolTip::NetworkItem, item->networkItem());
+                    m_toolTip->setupToolTip(Smb4KToolTip::NetworkItem, item);
                     m_toolTip->show(cursor().pos(), nativeParentWidget()->windowHandle());
                 }
             }
@@ -103,7 +144,7 @@ bool Smb4KNetworkBrowser::event(QEvent *e)
     }
     }
 
-    return QTreeWidget::event(e);
+    return QTreeView::event(e);
 }
 
 void Smb4KNetworkBrowser::mousePressEvent(QMouseEvent *e)
@@ -112,14 +153,14 @@ void Smb4KNetworkBrowser::mousePressEvent(QMouseEvent *e)
         m_toolTip->hide();
     }
 
-    QTreeWidgetItem *item = itemAt(e->pos());
+    QModelIndex index = indexAt(e->pos());
 
-    if (!item && currentItem()) {
-        currentItem()->setSelected(false);
-        setCurrentItem(nullptr);
+    if (!index.isValid() && currentIndex().isValid()) {
+        clearSelection();
+        setCurrentIndex(QModelIndex());
     }
 
-    QTreeWidget::mousePressEvent(e);
+    QTreeView::mousePressEvent(e);
 }
 
 void Smb4KNetworkBrowser::mouseMoveEvent(QMouseEvent *e)
@@ -128,26 +169,30 @@ void Smb4KNetworkBrowser::mouseMoveEvent(QMouseEvent *e)
         m_toolTip->hide();
     }
 
-    QTreeWidget::mouseMoveEvent(e);
+    QTreeView::mouseMoveEvent(e);
 }
 
 /////////////////////////////////////////////////////////////////////////////
 // SLOT IMPLEMENTATIONS
 /////////////////////////////////////////////////////////////////////////////
 
-void Smb4KNetworkBrowser::slotItemActivated(QTreeWidgetItem *item, int /*column*/)
+void Smb4KNetworkBrowser::slotItemActivated(const QModelIndex &index)
 {
     // Only do something if there are no keyboard modifiers pressed
     // and there is only one item selected.
-    if (QApplication::keyboardModifiers() == Qt::NoModifier && selectedItems().size() == 1) {
+    if (QApplication::keyboardModifiers() == Qt::NoModifier && selectionModel()->selectedRows().size() == 1) {
+        NetworkItemPtr item = networkItem(index);
+
         if (item) {
             switch (item->type()) {
             case Workgroup:
             case Host: {
-                if (!item->isExpanded()) {
-                    expandItem(item);
+                QModelIndex firstColumn = index.siblingAtColumn(Network);
+
+                if (!isExpanded(firstColumn)) {
+                    expand(firstColumn);
                 } else {
-                    collapseItem(item);
+                    collapse(firstColumn);
                 }
 
                 break;
@@ -162,22 +207,24 @@ void Smb4KNetworkBrowser::slotItemActivated(QTreeWidgetItem *item, int /*column*
 
 void Smb4KNetworkBrowser::slotItemSelectionChanged()
 {
-    if (selectedItems().size() > 1) {
+    const QModelIndexList selectedRows = selectionModel()->selectedRows();
+
+    if (selectedRows.size() > 1) {
         // If multiple items are selected, only allow shares
         // to stay selected.
-        for (int i = 0; i < selectedItems().size(); ++i) {
-            Smb4KNetworkBrowserItem *item = static_cast<Smb4KNetworkBrowserItem *>(selectedItems()[i]);
+        for (const QModelIndex &index : selectedRows) {
+            NetworkItemPtr item = networkItem(index);
 
             if (item) {
-                switch (item->networkItem()->type()) {
+                switch (item->type()) {
                 case Workgroup:
                 case Host: {
-                    item->setSelected(false);
+                    selectionModel()->select(index, QItemSelectionModel::Deselect | QItemSelectionModel::Rows);
                     break;
                 }
                 case Share: {
-                    if (item->shareItem()->isPrinter()) {
-                        item->setSelected(false);
+                    if (item.staticCast<Smb4KShare>()->isPrinter()) {
+                        selectionModel()->select(index, QItemSelectionModel::Deselect | QItemSelectionModel::Rows);
                     }
                     break;
                 }
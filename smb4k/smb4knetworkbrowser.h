@@ -1,19 +1,23 @@
 /*
     smb4knetworkbrowser  -  The network browser widget of Smb4K.
 
-    SPDX-FileCopyrightText: 2007-2023 Alexander Reinholdt <alexander.reinholdt@kdemail.net>
+    SPDX-FileCopyrightText: 2007-2026 Alexander Reinholdt <alexander.reinholdt@kdemail.net>
     SPDX-License-Identifier: GPL-2.0-or-later
 */
 
 #ifndef SMB4KNETWORKBROWSER_H
 #define SMB4KNETWORKBROWSER_H
 
+// application specific includes
+#include "core/smb4kglobal.h"
+
 // Qt includes
-#include <QTreeWidget>
+#include <QTreeView>
 
 // forward declarations
-class Smb4KNetworkBrowserItem;
+class Smb4KNetworkBrowserModel;
 class Smb4KToolTip;
+class QSortFilterProxyModel;
 
 /**
  * This is the network neighborhood browser widget.
@@ -21,7 +25,7 @@ class Smb4KToolTip;
  * @author Alexander Reinholdt <alexander.reinholdt@kdemail.net>
  */
 
-class Smb4KNetworkBrowser : public QTreeWidget
+class Smb4KNetworkBrowser : public QTreeView
 {
     Q_OBJECT
 
@@ -53,6 +57,31 @@ public:
      */
     Smb4KToolTip *toolTip();
 
+    /**
+     * The model holding the network items
+     */
+    Smb4KNetworkBrowserModel *networkModel();
+
+    /**
+     * Returns the network item at @p index
+     *
+     * @param index         The index of the view
+     */
+    NetworkItemPtr networkItem(const QModelIndex &index) const;
+
+    /**
+     * Returns the index of the view that shows @p item. The parent items
+     * are populated, if necessary.
+     *
+     * @param item          The network item
+     */
+    QModelIndex indexOf(const NetworkItemPtr &item) const;
+
+    /**
+     * Returns the selected network items
+     */
+    QList<NetworkItemPtr> selectedNetworkItems() const;
+
 protected:
     /**
      * Reimplemented from QWidget.
@@ -79,10 +108,9 @@ protected Q_SLOTS:
     /**
      * This slot is called when the user activated an item. It is used
      * to open the item if it is expandable.
-     * @param item          The item that has been activated.
-     * @param column        The column where the item was activated.
+     * @param index         The index of the activated item
      */
-    void slotItemActivated(QTreeWidgetItem *item, int column);
+    void slotItemActivated(const QModelIndex &index);
 
     /**
      * Take care that only shares are selected when the user marks multiple
@@ -92,6 +120,8 @@ protected Q_SLOTS:
 
 private:
     Smb4KToolTip *m_toolTip;
+    Smb4KNetworkBrowserModel *m_model;
+    QSortFilterProxyModel *m_proxyModel;
 };
 
 #endif
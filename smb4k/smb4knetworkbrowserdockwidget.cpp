@@ -1,7 +1,7 @@
 /*
     The network neighborhood browser dock widget
 
-    SPDX-FileCopyrightText: 2018-2024 Alexander Reinholdt <alexander.reinholdt@kdemail.net>
+    SPDX-FileCopyrightText: 2018-2026 Alexander Reinholdt <alexander.reinholdt@kdemail.net>
     SPDX-License-Identifier: GPL-2.0-or-later
 */
 
@@ -18,7 +18,7 @@
 #include "smb4khomesuserdialog.h"
 #include "smb4kmountdialog.h"
 #include "smb4knetworkbrowser.h"
-#include "smb4knetworkbrowseritem.h"
+#include "smb4knetworkbrowsermodel.h"
 #include "smb4knetworksearchtoolbar.h"
 #include "smb4kpassworddialog.h"
 #include "smb4kpreviewdialog.h"
@@ -30,7 +30,6 @@
 #include <QHeaderView>
 #include <QMenu>
 #include <QPointer>
-#include <QTreeWidgetItemIterator>
 #include <QVBoxLayout>
 
 // KDE includes
@@ -65,8 +64,10 @@ Smb4KNetworkBrowserDockWidget::Smb4KNetworkBrowserDockWidget(const QString &titl
     loadSettings();
 
     connect(m_networkBrowser, &Smb4KNetworkBrowser::customContextMenuRequested, this, &Smb4KNetworkBrowserDockWidget::slotContextMenuRequested);
-    connect(m_networkBrowser, &Smb4KNetworkBrowser::itemActivated, this, &Smb4KNetworkBrowserDockWidget::slotItemActivated);
-    connect(m_networkBrowser, &Smb4KNetworkBrowser::itemSelectionChanged, this, &Smb4KNetworkBrowserDockWidget::slotItemSelectionChanged);
+    connect(m_networkBrowser, &Smb4KNetworkBrowser::activated, this, &Smb4KNetworkBrowserDockWidget::slotItemActivated);
+    connect(m_networkBrowser, &Smb4KNetworkBrowser::expanded, this, &Smb4KNetworkBrowserDockWidget::slotItemExpanded);
+    connect(m_networkBrowser, &Smb4KNetworkBrowser::collapsed, this, &Smb4KNetworkBrowserDockWidget::slotItemCollapsed);
+    connect(m_networkBrowser->selectionModel(), &QItemSelectionModel::selectionChanged, this, &Smb4KNetworkBrowserDockWidget::slotItemSelectionChanged);
 
     connect(m_searchToolBar, &Smb4KNetworkSearchToolBar::closeSearchBar, this, &Smb4KNetworkBrowserDockWidget::slotHideSearchToolBar);
     connect(m_searchToolBar, &Smb4KNetworkSearchToolBar::search, this, &Smb4KNetworkBrowserDockWidget::slotPerformSearch);
@@ -76,9 +77,9 @@ Smb4KNetworkBrowserDockWidget::Smb4KNetworkBrowserDockWidget(const QString &titl
 
     connect(Smb4KClient::self(), &Smb4KClient::aboutToStart, this, &Smb4KNetworkBrowserDockWidget::slotClientAboutToStart);
     connect(Smb4KClient::self(), &Smb4KClient::finished, this, &Smb4KNetworkBrowserDockWidget::slotClientFinished);
-    connect(Smb4KClient::self(), &Smb4KClient::workgroups, this, &Smb4KNetworkBrowserDockWidget::slotWorkgroups);
-    connect(Smb4KClient::self(), &Smb4KClient::hosts, this, &Smb4KNetworkBrowserDockWidget::slotWorkgroupMembers);
-    connect(Smb4KClient::self(), &Smb4KClient::shares, this, &Smb4KNetworkBrowserDockWidget::slotShares);
+    connect(Smb4KClient::self(), &Smb4KClient::workgroupsChanged, this, &Smb4KNetworkBrowserDockWidget::slotWorkgroupsChanged);
+    connect(Smb4KClient::self(), &Smb4KClient::hostsChanged, this, &Smb4KNetworkBrowserDockWidget::slotWorkgroupMembersChanged);
+    connect(Smb4KClient::self(), &Smb4KClient::sharesChanged, this, &Smb4KNetworkBrowserDockWidget::slotSharesChanged);
     connect(Smb4KClient::self(), &Smb4KClient::searchResults, this, &Smb4KNetworkBrowserDockWidget::slotSearchResults);
 
     connect(Smb4KMounter::self(), &Smb4KMounter::mounted, this, &Smb4KNetworkBrowserDockWidget::slotShareMounted);
@@ -274,7 +275,9 @@ void Smb4KNetworkBrowserDockWidget::loadSettings()
     //
     // Does anything has to be changed with the marked shares?
     //
-    for (const SharePtr &share : mountedSharesList()) {
+    const QList<SharePtr> mountedShares = mountedSharesList();
+
+    for (const SharePtr &share : mountedShares) {
         // We do not need to use slotShareUnmounted() here, too,
         // because slotShareMounted() will take care of everything
         // we need here.
@@ -311,29 +314,29 @@ void Smb4KNetworkBrowserDockWidget::slotContextMenuRequested(const QPoint &pos)
     m_contextMenu->menu()->popup(m_networkBrowser->viewport()->mapToGlobal(pos));
 }
 
-void Smb4KNetworkBrowserDockWidget::slotItemActivated(QTreeWidgetItem *item, int column)
+void Smb4KNetworkBrowserDockWidget::slotItemActivated(const QModelIndex &index)
 {
-    Q_UNUSED(column);
+    if (QApplication::keyboardModifiers() == Qt::NoModifier && m_networkBrowser->selectionModel()->selectedRows().size() == 1) {
+        NetworkItemPtr item = m_networkBrowser->networkItem(index);
 
-    if (QApplication::keyboardModifiers() == Qt::NoModifier && m_networkBrowser->selectedItems().size() == 1) {
-        Smb4KNetworkBrowserItem *browserItem = static_cast<Smb4KNetworkBrowserItem *>(item);
+        if (item) {
+            bool expanded = m_networkBrowser->isExpanded(index.siblingAtColumn(Smb4KNetworkBrowser::Network));
 
-        if (browserItem) {
-            switch (browserItem->type()) {
+            switch (item->type()) {
             case Workgroup: {
-                if (browserItem->isExpanded()) {
-                    Smb4KClient::self()->lookupDomainMembers(browserItem->workgroupItem());
+                if (expanded) {
+                    Smb4KClient::self()->lookupDomainMembers(item.staticCast<Smb4KWorkgroup>());
                 }
                 break;
             }
             case Host: {
-                if (browserItem->isExpanded()) {
-                    Smb4KClient::self()->lookupShares(browserItem->hostItem());
+                if (expanded) {
+                    Smb4KClient::self()->lookupShares(item.staticCast<Smb4KHost>());
                 }
                 break;
             }
             case Share: {
-                if (!browserItem->shareItem()->isPrinter()) {
+                if (!item.staticCast<Smb4KShare>()->isPrinter()) {
                     slotMountActionTriggered(false); // boolean is ignored
                 } else {
                     slotPrint(false); // boolean is ignored
@@ -348,9 +351,27 @@ void Smb4KNetworkBrowserDockWidget::slotItemActivated(QTreeWidgetItem *item, int
     }
 }
 
+void Smb4KNetworkBrowserDockWidget::slotItemExpanded(const QModelIndex &index)
+{
+    NetworkItemPtr item = m_networkBrowser->networkItem(index);
+
+    if (item && (item->type() == Workgroup || item->type() == Host)) {
+        Smb4KClient::self()->setAutoRefresh(item, true);
+    }
+}
+
+void Smb4KNetworkBrowserDockWidget::slotItemCollapsed(const QModelIndex &index)
+{
+    NetworkItemPtr item = m_networkBrowser->networkItem(index);
+
+    if (item && (item->type() == Workgroup || item->type() == Host)) {
+        Smb4KClient::self()->setAutoRefresh(item, false);
+    }
+}
+
 void Smb4KNetworkBrowserDockWidget::slotItemSelectionChanged()
 {
-    QList<QTreeWidgetItem *> selectedItems = m_networkBrowser->selectedItems();
+    QList<NetworkItemPtr> selectedItems = m_networkBrowser->selectedNetworkItems();
 
     if (selectedItems.size() > 1) {
         //
@@ -366,15 +387,15 @@ void Smb4KNetworkBrowserDockWidget::slotItemSelectionChanged()
         int unmountedShares = selectedItems.size();
         int printerShares = 0;
 
-        for (QTreeWidgetItem *selectedItem : std::as_const(selectedItems)) {
-            Smb4KNetworkBrowserItem *item = static_cast<Smb4KNetworkBrowserItem *>(selectedItem);
+        for (const NetworkItemPtr &item : std::as_const(selectedItems)) {
+            if (item->type() == Share) {
+                SharePtr share = item.staticCast<Smb4KShare>();
 
-            if (item) {
-                if (item->shareItem()->isMounted() && !item->shareItem()->isForeign()) {
+                if (share->isMounted() && !share->isForeign()) {
                     unmountedShares--;
                 }
 
-                if (item->shareItem()->isPrinter()) {
+                if (share->isPrinter()) {
                     printerShares++;
                 }
             }
@@ -389,7 +410,7 @@ void Smb4KNetworkBrowserDockWidget::slotItemSelectionChanged()
         qobject_cast<KDualAction *>(m_actionCollection->action(QStringLiteral("mount_action")))->setActive(unmountedShares == selectedItems.size());
         m_actionCollection->action(QStringLiteral("mount_action"))->setEnabled(true);
     } else if (selectedItems.size() == 1) {
-        Smb4KNetworkBrowserItem *item = static_cast<Smb4KNetworkBrowserItem *>(selectedItems.first());
+        NetworkItemPtr item = selectedItems.first();
 
         if (item) {
             switch (item->type()) {
@@ -405,18 +426,19 @@ void Smb4KNetworkBrowserDockWidget::slotItemSelectionChanged()
                 break;
             }
             case Share: {
+                SharePtr share = item.staticCast<Smb4KShare>();
                 qobject_cast<KDualAction *>(m_actionCollection->action(QStringLiteral("rescan_abort_action")))->setInactiveText(i18n("Scan Compute&r"));
-                m_actionCollection->action(QStringLiteral("bookmark_action"))->setEnabled(!item->shareItem()->isPrinter());
+                m_actionCollection->action(QStringLiteral("bookmark_action"))->setEnabled(!share->isPrinter());
                 m_actionCollection->action(QStringLiteral("authentication_action"))->setEnabled(true);
-                m_actionCollection->action(QStringLiteral("custom_action"))->setEnabled(!item->shareItem()->isPrinter());
-                m_actionCollection->action(QStringLiteral("preview_action"))->setEnabled(!item->shareItem()->isPrinter());
-                m_actionCollection->action(QStringLiteral("print_action"))->setEnabled(item->shareItem()->isPrinter());
+                m_actionCollection->action(QStringLiteral("custom_action"))->setEnabled(!share->isPrinter());
+                m_actionCollection->action(QStringLiteral("preview_action"))->setEnabled(!share->isPrinter());
+                m_actionCollection->action(QStringLiteral("print_action"))->setEnabled(share->isPrinter());
 
-                if (!item->shareItem()->isPrinter()) {
-                    if (!item->shareItem()->isMounted() || item->shareItem()->isForeign()) {
+                if (!share->isPrinter()) {
+                    if (!share->isMounted() || share->isForeign()) {
                         qobject_cast<KDualAction *>(m_actionCollection->action(QStringLiteral("mount_action")))->setActive(true);
                         m_actionCollection->action(QStringLiteral("mount_action"))->setEnabled(true);
-                    } else if (item->shareItem()->isMounted() && !item->shareItem()->isForeign()) {
+                    } else if (share->isMounted() && !share->isForeign()) {
                         qobject_cast<KDualAction *>(m_actionCollection->action(QStringLiteral("mount_action")))->setActive(false);
                         m_actionCollection->action(QStringLiteral("mount_action"))->setEnabled(true);
                     } else {
@@ -483,232 +505,68 @@ void Smb4KNetworkBrowserDockWidget::slotClientFinished(const NetworkItemPtr &ite
 
     if (process == NetworkSearch) {
         m_searchToolBar->setActiveState(false);
+        m_searchRunning = false;
     }
 }
 
-void Smb4KNetworkBrowserDockWidget::slotWorkgroups()
+void Smb4KNetworkBrowserDockWidget::slotWorkgroupsChanged(const QList<WorkgroupPtr> &added,
+                                                          const QList<WorkgroupPtr> &removed,
+                                                          const QList<WorkgroupPtr> &changed)
 {
-    if (!workgroupsList().isEmpty()) {
-        //
-        // Remove obsolete workgroups and update existing ones
-        //
-        QTreeWidgetItemIterator itemIt(m_networkBrowser, QTreeWidgetItemIterator::All);
-
-        while (*itemIt) {
-            Smb4KNetworkBrowserItem *networkItem = static_cast<Smb4KNetworkBrowserItem *>(*itemIt);
-
-            if (networkItem->type() == Workgroup) {
-                WorkgroupPtr workgroup = findWorkgroup(networkItem->workgroupItem()->workgroupName());
-
-                if (workgroup) {
-                    networkItem->update();
-
-                    // Update the master browser
-                    for (int i = 0; i < networkItem->childCount(); ++i) {
-                        Smb4KNetworkBrowserItem *host = static_cast<Smb4KNetworkBrowserItem *>(networkItem->child(i));
-                        host->update();
-                    }
-                } else {
-                    delete networkItem;
-                }
-            }
-
-            ++itemIt;
-        }
-
-        //
-        // Add new workgroups to the tree widget
-        //
-        for (const WorkgroupPtr &workgroup : workgroupsList()) {
-            QList<QTreeWidgetItem *> items = m_networkBrowser->findItems(workgroup->workgroupName(), Qt::MatchFixedString, Smb4KNetworkBrowser::Network);
-
-            if (items.isEmpty()) {
-                (void)new Smb4KNetworkBrowserItem(m_networkBrowser, workgroup);
-            }
-        }
-
-        //
-        // Sort the items
-        //
-        m_networkBrowser->sortItems(Smb4KNetworkBrowser::Network, Qt::AscendingOrder);
-    } else {
-        //
-        // Clear the tree widget
-        //
-        m_networkBrowser->clear();
-    }
+    m_networkBrowser->networkModel()->updateWorkgroups(added, removed, changed);
 }
 
-void Smb4KNetworkBrowserDockWidget::slotWorkgroupMembers(const WorkgroupPtr &workgroup)
+void Smb4KNetworkBrowserDockWidget::slotWorkgroupMembersChanged(const WorkgroupPtr &workgroup,
+                                                                const QList<HostPtr> &added,
+                                                                const QList<HostPtr> &removed,
+                                                                const QList<HostPtr> &changed)
 {
-    if (workgroup) {
-        //
-        // Find the right workgroup
-        //
-        QList<QTreeWidgetItem *> workgroups =
-            m_networkBrowser->findItems(workgroup->workgroupName(), Qt::MatchFixedString | Qt::MatchRecursive, Smb4KNetworkBrowser::Network);
-        Smb4KNetworkBrowserItem *workgroupItem = nullptr;
-
-        for (QTreeWidgetItem *item : std::as_const(workgroups)) {
-            Smb4KNetworkBrowserItem *tempWorkgroup = static_cast<Smb4KNetworkBrowserItem *>(item);
-
-            if (tempWorkgroup->type() == Workgroup && tempWorkgroup->workgroupItem()->workgroupName() == workgroup->workgroupName()) {
-                workgroupItem = tempWorkgroup;
-                break;
-            }
-        }
-
-        //
-        // Process the hosts
-        //
-        if (workgroupItem) {
-            //
-            // Remove obsolete hosts and update existing ones
-            //
-            QTreeWidgetItemIterator hostIt(workgroupItem);
-
-            while (*hostIt) {
-                Smb4KNetworkBrowserItem *hostItem = static_cast<Smb4KNetworkBrowserItem *>(*hostIt);
-
-                if (hostItem->type() == Host) {
-                    HostPtr host = findHost(hostItem->hostItem()->hostName(), hostItem->hostItem()->workgroupName());
-
-                    if (host) {
-                        hostItem->update();
-                    } else {
-                        delete hostItem;
-                    }
-                }
-
-                ++hostIt;
-            }
-
-            //
-            // Add new hosts to the workgroup item and remove obsolete workgroups if
-            // necessary. Honor the auto-expand feature.
-            //
-            QList<HostPtr> members = workgroupMembers(workgroup);
-
-            if (!members.isEmpty()) {
-                for (const HostPtr &host : std::as_const(members)) {
-                    bool foundHost = false;
-
-                    for (int i = 0; i < workgroupItem->childCount(); ++i) {
-                        Smb4KNetworkBrowserItem *hostItem = static_cast<Smb4KNetworkBrowserItem *>(workgroupItem->child(i));
-
-                        if (hostItem->hostItem()->hostName() == host->hostName()) {
-                            foundHost = true;
-                            break;
-                        }
-                    }
+    if (!workgroup) {
+        return;
+    }
 
-                    if (!foundHost) {
-                        (void)new Smb4KNetworkBrowserItem(workgroupItem, host);
-                    }
-                }
+    //
+    // Only workgroups that were expanded are updated. The others get their
+    // members when they are expanded.
+    //
+    m_networkBrowser->networkModel()->updateHosts(workgroup, added, removed, changed);
 
-                //
-                // Auto-expand the workgroup item, if applicable
-                //
-                if (Smb4KSettings::autoExpandNetworkItems() && !workgroupItem->isExpanded() && !m_searchRunning) {
-                    m_networkBrowser->expandItem(workgroupItem);
-                }
-            } else {
-                //
-                // Remove empty workgroup.
-                //
-                delete workgroupItem;
-            }
+    //
+    // Honor the auto-expand feature
+    //
+    if (Smb4KSettings::autoExpandNetworkItems() && !m_searchRunning && !workgroupMembers(workgroup).isEmpty()) {
+        QModelIndex index = m_networkBrowser->indexOf(workgroup);
 
-            //
-            // Sort the items
-            //
-            m_networkBrowser->sortItems(Smb4KNetworkBrowser::Network, Qt::AscendingOrder);
+        if (index.isValid() && !m_networkBrowser->isExpanded(index)) {
+            m_networkBrowser->expand(index);
         }
     }
 }
 
-void Smb4KNetworkBrowserDockWidget::slotShares(const HostPtr &host)
+void Smb4KNetworkBrowserDockWidget::slotSharesChanged(const HostPtr &host,
+                                                      const QList<SharePtr> &added,
+                                                      const QList<SharePtr> &removed,
+                                                      const QList<SharePtr> &changed)
 {
-    if (host) {
-        //
-        // Find the right host
-        //
-        QList<QTreeWidgetItem *> hosts = m_networkBrowser->findItems(host->hostName(), Qt::MatchFixedString | Qt::MatchRecursive, Smb4KNetworkBrowser::Network);
-        Smb4KNetworkBrowserItem *hostItem = nullptr;
-
-        for (QTreeWidgetItem *item : std::as_const(hosts)) {
-            Smb4KNetworkBrowserItem *tempHost = static_cast<Smb4KNetworkBrowserItem *>(item);
-
-            if (tempHost->type() == Host && tempHost->hostItem()->workgroupName() == host->workgroupName()) {
-                hostItem = tempHost;
-                break;
-            }
-        }
-
-        //
-        // Process the shares
-        //
-        if (hostItem) {
-            //
-            // Remove obsolete shares and update existing ones
-            //
-            QTreeWidgetItemIterator shareIt(hostItem);
-
-            while (*shareIt) {
-                Smb4KNetworkBrowserItem *shareItem = static_cast<Smb4KNetworkBrowserItem *>(*shareIt);
-
-                if (shareItem->type() == Share) {
-                    SharePtr share = findShare(shareItem->shareItem()->url(), shareItem->shareItem()->workgroupName());
-
-                    if (share) {
-                        shareItem->update();
-                    } else {
-                        delete shareItem;
-                    }
-                }
-
-                ++shareIt;
-            }
-
-            //
-            // Add new shares to the host item. The host will not be removed from the
-            // view when it has no shares. Honor the auto-expand feature.
-            //
-            QList<SharePtr> shares = sharedResources(host);
-
-            if (!shares.isEmpty()) {
-                for (const SharePtr &share : std::as_const(shares)) {
-                    bool foundShare = false;
-
-                    for (int i = 0; i < hostItem->childCount(); ++i) {
-                        Smb4KNetworkBrowserItem *shareItem = static_cast<Smb4KNetworkBrowserItem *>(hostItem->child(i));
+    if (!host) {
+        return;
+    }
 
-                        if (shareItem->shareItem()->url().toString(QUrl::RemoveUserInfo | QUrl::RemovePort)
-                            == share->url().toString(QUrl::RemoveUserInfo | QUrl::RemovePort)) {
-                            foundShare = true;
-                            break;
-                        }
-                    }
+    //
+    // Only hosts that were expanded are updated. The others get their
+    // shares when they are expanded.
+    //
+    m_networkBrowser->networkModel()->updateShares(host, added, removed, changed);
 
-                    if (!foundShare) {
-                        (void)new Smb4KNetworkBrowserItem(hostItem, share);
-                    }
-                }
+    //
+    // Honor the auto-expand feature
+    //
+    if (Smb4KSettings::autoExpandNetworkItems() && !m_searchRunning && !sharedResources(host).isEmpty()) {
+        QModelIndex index = m_networkBrowser->indexOf(host);
 
-                //
-                // Auto-expand the host item, if applicable
-                //
-                if (Smb4KSettings::autoExpandNetworkItems() && !hostItem->isExpanded() && !m_searchRunning) {
-                    m_networkBrowser->expandItem(hostItem);
-                }
-            }
+        if (index.isValid() && !m_networkBrowser->isExpanded(index)) {
+            m_networkBrowser->expand(index);
         }
-
-        //
-        // Sort the items
-        //
-        m_networkBrowser->sortItems(Smb4KNetworkBrowser::Network, Qt::AscendingOrder);
     }
 }
 
@@ -724,7 +582,7 @@ void Smb4KNetworkBrowserDockWidget::slotRescanAbortActionTriggered(bool checked)
     //
     // Get the selected items
     //
-    QList<QTreeWidgetItem *> selectedItems = m_networkBrowser->selectedItems();
+    QList<NetworkItemPtr> selectedItems = m_networkBrowser->selectedNetworkItems();
 
     //
     // Perform actions according to the state of the action and the number of
@@ -732,21 +590,25 @@ void Smb4KNetworkBrowserDockWidget::slotRescanAbortActionTriggered(bool checked)
     //
     if (!rescanAbortAction->isActive()) {
         if (selectedItems.size() == 1) {
-            Smb4KNetworkBrowserItem *browserItem = static_cast<Smb4KNetworkBrowserItem *>(selectedItems.first());
+            NetworkItemPtr item = selectedItems.first();
 
-            if (browserItem) {
-                switch (browserItem->type()) {
+            if (item) {
+                switch (item->type()) {
                 case Workgroup: {
-                    Smb4KClient::self()->lookupDomainMembers(browserItem->workgroupItem());
+                    Smb4KClient::self()->lookupDomainMembers(item.staticCast<Smb4KWorkgroup>());
                     break;
                 }
                 case Host: {
-                    Smb4KClient::self()->lookupShares(browserItem->hostItem());
+                    Smb4KClient::self()->lookupShares(item.staticCast<Smb4KHost>());
                     break;
                 }
                 case Share: {
-                    Smb4KNetworkBrowserItem *parentItem = static_cast<Smb4KNetworkBrowserItem *>(browserItem->parent());
-                    Smb4KClient::self()->lookupShares(parentItem->hostItem());
+                    SharePtr share = item.staticCast<Smb4KShare>();
+                    HostPtr host = findHost(share->hostName(), share->workgroupName());
+
+                    if (host) {
+                        Smb4KClient::self()->lookupShares(host);
+                    }
                     break;
                 }
                 default: {
@@ -775,7 +637,7 @@ void Smb4KNetworkBrowserDockWidget::slotAddBookmark(bool checked)
 {
     Q_UNUSED(checked);
 
-    QList<QTreeWidgetItem *> selectedItems = m_networkBrowser->selectedItems();
+    QList<NetworkItemPtr> selectedItems = m_networkBrowser->selectedNetworkItems();
 
     if (selectedItems.isEmpty()) {
         return;
@@ -783,11 +645,9 @@ void Smb4KNetworkBrowserDockWidget::slotAddBookmark(bool checked)
 
     QList<SharePtr> shares;
 
-    for (QTreeWidgetItem *selectedItem : std::as_const(selectedItems)) {
-        Smb4KNetworkBrowserItem *item = static_cast<Smb4KNetworkBrowserItem *>(selectedItem);
-
-        if (item && item->type() == Share && !item->shareItem()->isPrinter()) {
-            shares << item->shareItem();
+    for (const NetworkItemPtr &item : std::as_const(selectedItems)) {
+        if (item->type() == Share && !item.staticCast<Smb4KShare>()->isPrinter()) {
+            shares << item.staticCast<Smb4KShare>();
         }
     }
 
@@ -816,19 +676,15 @@ void Smb4KNetworkBrowserDockWidget::slotAuthentication(bool checked)
 {
     Q_UNUSED(checked);
 
-    QList<QTreeWidgetItem *> selectedItems = m_networkBrowser->selectedItems();
-
-    for (QTreeWidgetItem *selectedItem : std::as_const(selectedItems)) {
-        Smb4KNetworkBrowserItem *item = static_cast<Smb4KNetworkBrowserItem *>(selectedItem);
+    QList<NetworkItemPtr> selectedItems = m_networkBrowser->selectedNetworkItems();
 
-        if (item) {
-            QPointer<Smb4KPasswordDialog> passwordDialog = new Smb4KPasswordDialog(this);
+    for (const NetworkItemPtr &item : std::as_const(selectedItems)) {
+        QPointer<Smb4KPasswordDialog> passwordDialog = new Smb4KPasswordDialog(this);
 
-            if (passwordDialog->setNetworkItem(item->networkItem())) {
-                passwordDialog->show();
-            } else {
-                delete passwordDialog;
-            }
+        if (passwordDialog->setNetworkItem(item)) {
+            passwordDialog->show();
+        } else {
+            delete passwordDialog;
         }
     }
 }
@@ -837,13 +693,11 @@ void Smb4KNetworkBrowserDockWidget::slotAddCustomSettings(bool checked)
 {
     Q_UNUSED(checked);
 
-    QList<QTreeWidgetItem *> selectedItems = m_networkBrowser->selectedItems();
-
-    for (QTreeWidgetItem *selectedItem : std::as_const(selectedItems)) {
-        Smb4KNetworkBrowserItem *item = static_cast<Smb4KNetworkBrowserItem *>(selectedItem);
+    QList<NetworkItemPtr> selectedItems = m_networkBrowser->selectedNetworkItems();
 
+    for (const NetworkItemPtr &item : std::as_const(selectedItems)) {
         QPointer<Smb4KCustomSettingsEditor> customSettingsEditor = new Smb4KCustomSettingsEditor(this);
-        if (customSettingsEditor->setNetworkItem(item->networkItem())) {
+        if (customSettingsEditor->setNetworkItem(item)) {
             customSettingsEditor->show();
         } else {
             delete customSettingsEditor;
@@ -855,15 +709,13 @@ void Smb4KNetworkBrowserDockWidget::slotPreview(bool checked)
 {
     Q_UNUSED(checked);
 
-    QList<QTreeWidgetItem *> selectedItems = m_networkBrowser->selectedItems();
+    QList<NetworkItemPtr> selectedItems = m_networkBrowser->selectedNetworkItems();
 
-    for (QTreeWidgetItem *selectedItem : std::as_const(selectedItems)) {
-        Smb4KNetworkBrowserItem *item = static_cast<Smb4KNetworkBrowserItem *>(selectedItem);
-
-        if (item && item->type() == Share && !item->shareItem()->isPrinter()) {
+    for (const NetworkItemPtr &item : std::as_const(selectedItems)) {
+        if (item->type() == Share && !item.staticCast<Smb4KShare>()->isPrinter()) {
             QPointer<Smb4KPreviewDialog> previewDialog = new Smb4KPreviewDialog(this);
 
-            if (previewDialog->setShare(item->shareItem())) {
+            if (previewDialog->setShare(item.staticCast<Smb4KShare>())) {
                 previewDialog->show();
             } else {
                 delete previewDialog;
@@ -876,15 +728,13 @@ void Smb4KNetworkBrowserDockWidget::slotPrint(bool checked)
 {
     Q_UNUSED(checked);
 
-    QList<QTreeWidgetItem *> selectedItems = m_networkBrowser->selectedItems();
-
-    for (QTreeWidgetItem *selectedItem : std::as_const(selectedItems)) {
-        Smb4KNetworkBrowserItem *item = static_cast<Smb4KNetworkBrowserItem *>(selectedItem);
+    QList<NetworkItemPtr> selectedItems = m_networkBrowser->selectedNetworkItems();
 
-        if (item && item->shareItem()->isPrinter()) {
+    for (const NetworkItemPtr &item : std::as_const(selectedItems)) {
+        if (item->type() == Share && item.staticCast<Smb4KShare>()->isPrinter()) {
             QPointer<Smb4KPrintDialog> printDialog = new Smb4KPrintDialog(this);
 
-            if (printDialog->setPrinterShare(item->shareItem())) {
+            if (printDialog->setPrinterShare(item.staticCast<Smb4KShare>())) {
                 printDialog->show();
             } else {
                 delete printDialog;
@@ -897,20 +747,20 @@ void Smb4KNetworkBrowserDockWidget::slotMountActionTriggered(bool checked)
 {
     Q_UNUSED(checked);
 
-    QList<QTreeWidgetItem *> selectedItems = m_networkBrowser->selectedItems();
+    QList<NetworkItemPtr> selectedItems = m_networkBrowser->selectedNetworkItems();
     QList<SharePtr> unmountedShares, mountedShares;
 
-    for (QTreeWidgetItem *selectedItem : std::as_const(selectedItems)) {
-        Smb4KNetworkBrowserItem *item = static_cast<Smb4KNetworkBrowserItem *>(selectedItem);
+    for (const NetworkItemPtr &item : std::as_const(selectedItems)) {
+        if (item->type() == Share && !item.staticCast<Smb4KShare>()->isPrinter()) {
+            SharePtr share = item.staticCast<Smb4KShare>();
 
-        if (item && item->type() == Share && !item->shareItem()->isPrinter()) {
-            if (item->shareItem()->isMounted()) {
-                mountedShares << item->shareItem();
+            if (share->isMounted()) {
+                mountedShares << share;
             } else {
-                if (item->shareItem()->isHomesShare()) {
+                if (share->isHomesShare()) {
                     QPointer<Smb4KHomesUserDialog> homesUserDialog = new Smb4KHomesUserDialog(this);
 
-                    if (homesUserDialog->setShare(item->shareItem())) {
+                    if (homesUserDialog->setShare(share)) {
                         int returnValue = homesUserDialog->exec();
                         delete homesUserDialog;
 
@@ -920,7 +770,7 @@ void Smb4KNetworkBrowserDockWidget::slotMountActionTriggered(bool checked)
                     }
                 }
 
-                unmountedShares << item->shareItem();
+                unmountedShares << share;
             }
         }
     }
@@ -955,44 +805,12 @@ void Smb4KNetworkBrowserDockWidget::slotMountActionChanged(bool active)
 
 void Smb4KNetworkBrowserDockWidget::slotShareMounted(const SharePtr &share)
 {
-    QTreeWidgetItemIterator it(m_networkBrowser);
-
-    while (*it) {
-        Smb4KNetworkBrowserItem *item = static_cast<Smb4KNetworkBrowserItem *>(*it);
-
-        if (item->type() == Share) {
-            if (QString::compare(item->shareItem()->url().toString(QUrl::RemoveUserInfo | QUrl::RemovePort),
-                                 share->url().toString(QUrl::RemoveUserInfo | QUrl::RemovePort),
-                                 Qt::CaseInsensitive)
-                == 0) {
-                item->update();
-                break;
-            }
-        }
-
-        ++it;
-    }
+    m_networkBrowser->networkModel()->updateShare(share);
 }
 
 void Smb4KNetworkBrowserDockWidget::slotShareUnmounted(const SharePtr &share)
 {
-    QTreeWidgetItemIterator it(m_networkBrowser);
-
-    while (*it) {
-        Smb4KNetworkBrowserItem *item = static_cast<Smb4KNetworkBrowserItem *>(*it);
-
-        if (item->type() == Share) {
-            if (QString::compare(item->shareItem()->url().toString(QUrl::RemoveUserInfo | QUrl::RemovePort),
-                                 share->url().toString(QUrl::RemoveUserInfo | QUrl::RemovePort),
-                                 Qt::CaseInsensitive)
-                == 0) {
-                item->update();
-                break;
-            }
-        }
-
-        ++it;
-    }
+    m_networkBrowser->networkModel()->updateShare(share);
 }
 
 void Smb4KNetworkBrowserDockWidget::slotMounterAboutToStart(int process)
@@ -1086,50 +904,51 @@ void Smb4KNetworkBrowserDockWidget::slotStopSearch()
 
 void Smb4KNetworkBrowserDockWidget::slotSearchResults(const QList<SharePtr> &shares)
 {
-    m_searchRunning = false;
-    QTreeWidgetItemIterator it(m_networkBrowser);
+    //
+    // The results are reported in several chunks while the search is
+    // running. Select the new ones.
+    //
+    QModelIndex firstIndex;
+
+    for (const SharePtr &share : shares) {
+        QModelIndex index = m_networkBrowser->indexOf(share);
 
-    while (*it) {
-        Smb4KNetworkBrowserItem *networkItem = static_cast<Smb4KNetworkBrowserItem *>(*it);
+        if (!index.isValid()) {
+            continue;
+        }
 
-        if (networkItem->type() == Share) {
-            for (const SharePtr &share : shares) {
-                if (networkItem->shareItem() == share) {
-                    networkItem->setSelected(true);
+        m_networkBrowser->selectionModel()->select(index, QItemSelectionModel::Select | QItemSelectionModel::Rows);
 
-                    if (!networkItem->parent()->isExpanded()) {
-                        m_networkBrowser->expandItem(networkItem->parent());
-                    }
+        if (!m_networkBrowser->isExpanded(index.parent())) {
+            m_networkBrowser->expand(index.parent());
+        }
 
-                    if (!networkItem->parent()->parent()->isExpanded()) {
-                        m_networkBrowser->expandItem(networkItem->parent()->parent());
-                    }
-                }
-            }
+        if (!m_networkBrowser->isExpanded(index.parent().parent())) {
+            m_networkBrowser->expand(index.parent().parent());
         }
 
-        it++;
+        if (!firstIndex.isValid()) {
+            firstIndex = index;
+        }
     }
 
-    QTreeWidgetItem *firstItem = m_networkBrowser->selectedItems().first();
-    m_networkBrowser->scrollToItem(firstItem, QTreeWidget::PositionAtCenter);
+    if (firstIndex.isValid() && m_networkBrowser->selectionModel()->selectedRows().size() == 1) {
+        m_networkBrowser->scrollTo(firstIndex, QAbstractItemView::PositionAtCenter);
+    }
 
     m_searchToolBar->setSearchResults(shares);
 }
 
 void Smb4KNetworkBrowserDockWidget::slotJumpToResult(const QString &url)
 {
-    QTreeWidgetItemIterator it(m_networkBrowser);
+    SharePtr share = findShare(QUrl(url));
 
-    while (*it) {
-        Smb4KNetworkBrowserItem *networkItem = static_cast<Smb4KNetworkBrowserItem *>(*it);
+    if (share) {
+        QModelIndex index = m_networkBrowser->indexOf(share);
 
-        if (networkItem->type() == Share && networkItem->shareItem()->url().toString() == url) {
-            m_networkBrowser->setCurrentItem(networkItem);
-            break;
+        if (index.isValid()) {
+            m_networkBrowser->setCurrentIndex(index);
         }
-
-        it++;
     }
 }
 
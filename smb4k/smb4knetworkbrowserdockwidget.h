@@ -1,7 +1,7 @@
 /*
     The network neighborhood browser dock widget
 
-    SPDX-FileCopyrightText: 2018-2023 Alexander Reinholdt <alexander.reinholdt@kdemail.net>
+    SPDX-FileCopyrightText: 2018-2026 Alexander Reinholdt <alexander.reinholdt@kdemail.net>
     SPDX-License-Identifier: GPL-2.0-or-later
 */
 
@@ -14,7 +14,6 @@
 // Qt includes
 #include <QDockWidget>
 #include <QPointer>
-#include <QTreeWidgetItem>
 
 // KDE includes
 #include <KActionCollection>
@@ -69,10 +68,23 @@ protected Q_SLOTS:
     /**
      * This slot is invoked when the user activated an item in the network
      * neighborhood browser.
-     * @param item                The item that was executed.
-     * @param column              The column where the item was executed.
+     * @param index               The index of the item that was executed.
      */
-    void slotItemActivated(QTreeWidgetItem *item, int column);
+    void slotItemActivated(const QModelIndex &index);
+
+    /**
+     * This slot is invoked when an item in the network neighborhood browser
+     * was expanded. The item is refreshed periodically from now on.
+     * @param index               The index of the expanded item
+     */
+    void slotItemExpanded(const QModelIndex &index);
+
+    /**
+     * This slot is invoked when an item in the network neighborhood browser
+     * was collapsed. The item is not refreshed periodically anymore.
+     * @param index               The index of the collapsed item
+     */
+    void slotItemCollapsed(const QModelIndex &index);
 
     /**
      * Is called when the selection changed. This slot takes care of the
@@ -99,23 +111,33 @@ protected Q_SLOTS:
     void slotClientFinished(const NetworkItemPtr &item, int process);
 
     /**
-     * This slot is called when workgroups/domains were discovered
+     * This slot is called when workgroups/domains were discovered. Only the
+     * items that were added, removed or changed are processed.
+     * @param added               The workgroups that were added
+     * @param removed             The workgroups that were removed
+     * @param changed             The workgroups that were updated
      */
-    void slotWorkgroups();
+    void slotWorkgroupsChanged(const QList<WorkgroupPtr> &added, const QList<WorkgroupPtr> &removed, const QList<WorkgroupPtr> &changed);
 
     /**
      * This slot is called when the list of servers of workgroup/domain
      * @p workgroup was discovered.
      * @param workgroup           The workgroup/domain that was queried
+     * @param added               The hosts that were added
+     * @param removed             The hosts that were removed
+     * @param changed             The hosts that were updated
      */
-    void slotWorkgroupMembers(const WorkgroupPtr &workgroup);
+    void slotWorkgroupMembersChanged(const WorkgroupPtr &workgroup, const QList<HostPtr> &added, const QList<HostPtr> &removed, const QList<HostPtr> &changed);
 
     /**
      * This slot is called when the list of shared resources of host @p host was
      * queried.
      * @param host                The host that was queried
+     * @param added               The shares that were added
+     * @param removed             The shares that were removed
+     * @param changed             The shares that were updated
      */
-    void slotShares(const HostPtr &host);
+    void slotSharesChanged(const HostPtr &host, const QList<SharePtr> &added, const QList<SharePtr> &removed, const QList<SharePtr> &changed);
 
     /**
      * Rescan the network or abort a network scan.
@@ -250,6 +272,7 @@ protected Q_SLOTS:
 
 private:
     void setupActions();
+
     Smb4KNetworkBrowser *m_networkBrowser;
     KActionCollection *m_actionCollection;
     KActionMenu *m_contextMenu;
@@ -0,0 +1,609 @@
+/*
+    The model of the network neighborhood browser
+
+    SPDX-FileCopyrightText: 2026 Alexander Reinholdt <alexander.reinholdt@kdemail.net>
+    SPDX-License-Identifier: GPL-2.0-or-later
+*/
+
+// application specific includes
+#include "smb4knetworkbrowsermodel.h"
+#include "core/smb4khost.h"
+#include "core/smb4kshare.h"
+#include "core/smb4kworkgroup.h"
+
+// Qt includes
+#include <QApplication>
+#include <QBrush>
+#include <QFont>
+#include <QPalette>
+
+// KDE includes
+#include <KLocalizedString>
+
+using namespace Smb4KGlobal;
+
+class Smb4KNetworkBrowserNode
+{
+public:
+    NetworkItemPtr item;
+    Smb4KNetworkBrowserNode *parent;
+    QList<Smb4KNetworkBrowserNode *> children;
+    QHash<QString, Smb4KNetworkBrowserNode *> childIndex;
+    int row;
+    bool populated;
+};
+
+//
+// The key of a network item among its siblings
+//
+static QString nodeKey(const NetworkItemPtr &item)
+{
+    switch (item->type()) {
+    case Workgroup: {
+        return item.staticCast<Smb4KWorkgroup>()->workgroupName().toCaseFolded();
+    }
+    case Host: {
+        return item.staticCast<Smb4KHost>()->hostName().toCaseFolded();
+    }
+    case Share: {
+        return item->url().toString(QUrl::RemoveUserInfo | QUrl::RemovePort).toCaseFolded();
+    }
+    default: {
+        break;
+    }
+    }
+
+    return QString();
+}
+
+Smb4KNetworkBrowserModel::Smb4KNetworkBrowserModel(QObject *parent)
+    : QAbstractItemModel(parent)
+{
+    m_root = new Smb4KNetworkBrowserNode;
+    m_root->parent = nullptr;
+    m_root->row = 0;
+    m_root->populated = true;
+
+    const QList<WorkgroupPtr> knownWorkgroups = workgroupsList();
+    QList<NetworkItemPtr> workgroups;
+
+    for (const WorkgroupPtr &workgroup : knownWorkgroups) {
+        workgroups << workgroup;
+    }
+
+    insertChildren(m_root, workgroups);
+}
+
+Smb4KNetworkBrowserModel::~Smb4KNetworkBrowserModel()
+{
+    for (Smb4KNetworkBrowserNode *child : std::as_const(m_root->children)) {
+        forgetNode(child);
+    }
+
+    delete m_root;
+}
+
+QModelIndex Smb4KNetworkBrowserModel::index(int row, int column, const QModelIndex &parent) const
+{
+    Smb4KNetworkBrowserNode *parentNode = node(parent);
+
+    if (row < 0 || row >= parentNode->children.size() || column < 0 || column >= ColumnCount) {
+        return QModelIndex();
+    }
+
+    return createIndex(row, column, parentNode->children.at(row));
+}
+
+QModelIndex Smb4KNetworkBrowserModel::parent(const QModelIndex &index) const
+{
+    if (!index.isValid()) {
+        return QModelIndex();
+    }
+
+    return indexOf(node(index)->parent);
+}
+
+int Smb4KNetworkBrowserModel::rowCount(const QModelIndex &parent) const
+{
+    if (parent.column() > 0) {
+        return 0;
+    }
+
+    return node(parent)->children.size();
+}
+
+int Smb4KNetworkBrowserModel::columnCount(const QModelIndex &parent) const
+{
+    Q_UNUSED(parent);
+    return ColumnCount;
+}
+
+bool Smb4KNetworkBrowserModel::hasChildren(const QModelIndex &parent) const
+{
+    if (parent.column() > 0) {
+        return false;
+    }
+
+    Smb4KNetworkBrowserNode *parentNode = node(parent);
+
+    if (parentNode != m_root && parentNode->item->type() == Share) {
+        return false;
+    }
+
+    //
+    // Workgroups and hosts that were not expanded yet might have children
+    //
+    return !parentNode->populated || !parentNode->children.isEmpty();
+}
+
+bool Smb4KNetworkBrowserModel::canFetchMore(const QModelIndex &parent) const
+{
+    return parent.isValid() && parent.column() == 0 && !node(parent)->populated;
+}
+
+void Smb4KNetworkBrowserModel::fetchMore(const QModelIndex &parent)
+{
+    if (parent.isValid()) {
+        populate(node(parent));
+    }
+}
+
+QVariant Smb4KNetworkBrowserModel::data(const QModelIndex &index, int role) const
+{
+    if (!index.isValid()) {
+        return QVariant();
+    }
+
+    NetworkItemPtr item = node(index)->item;
+
+    switch (role) {
+    case Qt::DisplayRole: {
+        switch (item->type()) {
+        case Workgroup: {
+            if (index.column() == Network) {
+                return item.staticCast<Smb4KWorkgroup>()->workgroupName();
+            }
+            break;
+        }
+        case Host: {
+            HostPtr host = item.staticCast<Smb4KHost>();
+
+            switch (index.column()) {
+            case Network: {
+                return host->hostName();
+            }
+            case IP: {
+                return host->ipAddress();
+            }
+            case Comment: {
+                return host->comment();
+            }
+            default: {
+                break;
+            }
+            }
+            break;
+        }
+        case Share: {
+            SharePtr share = item.staticCast<Smb4KShare>();
+
+            switch (index.column()) {
+            case Network: {
+                return share->shareName();
+            }
+            case Type: {
+                return share->shareTypeString();
+            }
+            case Comment: {
+                return share->comment();
+            }
+            default: {
+                break;
+            }
+            }
+            break;
+        }
+        default: {
+            break;
+        }
+        }
+        break;
+    }
+    case Qt::DecorationRole: {
+        if (index.column() == Network) {
+            return item->icon();
+        }
+        break;
+    }
+    case Qt::FontRole: {
+        if (item->type() == Share) {
+            SharePtr share = item.staticCast<Smb4KShare>();
+
+            if (!share->isPrinter() && share->isMounted()) {
+                QFont font;
+                font.setItalic(true);
+                return font;
+            }
+        }
+        break;
+    }
+    case Qt::ForegroundRole: {
+        if (item->isCached()) {
+            // The item was loaded from the cache and not confirmed by a scan yet
+            return QApplication::palette().brush(QPalette::Disabled, QPalette::Text);
+        } else if (item->type() == Host && item.staticCast<Smb4KHost>()->isMasterBrowser()) {
+            return QBrush(Qt::darkBlue);
+        }
+        break;
+    }
+    default: {
+        break;
+    }
+    }
+
+    return QVariant();
+}
+
+QVariant Smb4KNetworkBrowserModel::headerData(int section, Qt::Orientation orientation, int role) const
+{
+    if (orientation != Qt::Horizontal || role != Qt::DisplayRole) {
+        return QVariant();
+    }
+
+    switch (section) {
+    case Network: {
+        return i18n("Network");
+    }
+    case Type: {
+        return i18n("Type");
+    }
+    case IP: {
+        return i18n("IP Address");
+    }
+    case Comment: {
+        return i18n("Comment");
+    }
+    default: {
+        break;
+    }
+    }
+
+    return QVariant();
+}
+
+NetworkItemPtr Smb4KNetworkBrowserModel::networkItem(const QModelIndex &index) const
+{
+    if (!index.isValid()) {
+        return NetworkItemPtr();
+    }
+
+    return node(index)->item;
+}
+
+QModelIndex Smb4KNetworkBrowserModel::indexOf(const NetworkItemPtr &item)
+{
+    if (!item) {
+        return QModelIndex();
+    }
+
+    Smb4KNetworkBrowserNode *itemNode = nullptr;
+
+    switch (item->type()) {
+    case Workgroup: {
+        itemNode = findChild(m_root, nodeKey(item));
+        break;
+    }
+    case Host: {
+        Smb4KNetworkBrowserNode *workgroupNode = findChild(m_root, item.staticCast<Smb4KHost>()->workgroupName().toCaseFolded());
+
+        if (workgroupNode) {
+            populate(workgroupNode);
+            itemNode = findChild(workgroupNode, nodeKey(item));
+        }
+        break;
+    }
+    case Share: {
+        SharePtr share = item.staticCast<Smb4KShare>();
+        Smb4KNetworkBrowserNode *workgroupNode = findChild(m_root, share->workgroupName().toCaseFolded());
+
+        if (workgroupNode) {
+            populate(workgroupNode);
+            Smb4KNetworkBrowserNode *hostNode = findChild(workgroupNode, share->hostName().toCaseFolded());
+
+            if (hostNode) {
+                populate(hostNode);
+                itemNode = findChild(hostNode, nodeKey(item));
+            }
+        }
+        break;
+    }
+    default: {
+        break;
+    }
+    }
+
+    return itemNode ? indexOf(itemNode) : QModelIndex();
+}
+
+void Smb4KNetworkBrowserModel::updateWorkgroups(const QList<WorkgroupPtr> &added, const QList<WorkgroupPtr> &removed, const QList<WorkgroupPtr> &changed)
+{
+    const QList<WorkgroupPtr> knownWorkgroups = workgroupsList();
+
+    if (knownWorkgroups.isEmpty()) {
+        clear();
+        return;
+    }
+
+    for (const WorkgroupPtr &workgroup : removed) {
+        removeChild(m_root, nodeKey(workgroup));
+    }
+
+    //
+    // Update the changed workgroups and their master browsers
+    //
+    for (const WorkgroupPtr &workgroup : changed) {
+        Smb4KNetworkBrowserNode *workgroupNode = findChild(m_root, nodeKey(workgroup));
+
+        if (workgroupNode) {
+            updateNode(workgroupNode);
+
+            if (!workgroupNode->children.isEmpty()) {
+                Q_EMIT dataChanged(indexOf(workgroupNode->children.first()), indexOf(workgroupNode->children.last(), ColumnCount - 1));
+            }
+        }
+    }
+
+    //
+    // Add the new workgroups. Also add those workgroups that are known
+    // but not shown yet.
+    //
+    QList<NetworkItemPtr> newWorkgroups;
+
+    if (m_root->children.size() + added.size() != knownWorkgroups.size()) {
+        for (const WorkgroupPtr &workgroup : knownWorkgroups) {
+            newWorkgroups << workgroup;
+        }
+    } else {
+        for (const WorkgroupPtr &workgroup : added) {
+            newWorkgroups << workgroup;
+        }
+    }
+
+    insertChildren(m_root, newWorkgroups);
+}
+
+void Smb4KNetworkBrowserModel::updateHosts(const WorkgroupPtr &workgroup, const QList<HostPtr> &added, const QList<HostPtr> &removed, const QList<HostPtr> &changed)
+{
+    Smb4KNetworkBrowserNode *workgroupNode = findChild(m_root, nodeKey(workgroup));
+
+    //
+    // The members are added when the workgroup is expanded
+    //
+    if (!workgroupNode || !workgroupNode->populated) {
+        return;
+    }
+
+    for (const HostPtr &host : removed) {
+        removeChild(workgroupNode, nodeKey(host));
+    }
+
+    for (const HostPtr &host : changed) {
+        Smb4KNetworkBrowserNode *hostNode = findChild(workgroupNode, nodeKey(host));
+
+        if (hostNode) {
+            updateNode(hostNode);
+        }
+    }
+
+    QList<NetworkItemPtr> newHosts;
+
+    for (const HostPtr &host : added) {
+        newHosts << host;
+    }
+
+    insertChildren(workgroupNode, newHosts);
+}
+
+void Smb4KNetworkBrowserModel::updateShares(const HostPtr &host, const QList<SharePtr> &added, const QList<SharePtr> &removed, const QList<SharePtr> &changed)
+{
+    Smb4KNetworkBrowserNode *workgroupNode = findChild(m_root, host->workgroupName().toCaseFolded());
+    Smb4KNetworkBrowserNode *hostNode = workgroupNode ? findChild(workgroupNode, nodeKey(host)) : nullptr;
+
+    //
+    // The shares are added when the host is expanded
+    //
+    if (!hostNode || !hostNode->populated) {
+        return;
+    }
+
+    for (const SharePtr &share : removed) {
+        removeChild(hostNode, nodeKey(share));
+    }
+
+    for (const SharePtr &share : changed) {
+        Smb4KNetworkBrowserNode *shareNode = findChild(hostNode, nodeKey(share));
+
+        if (shareNode) {
+            updateNode(shareNode);
+        }
+    }
+
+    QList<NetworkItemPtr> newShares;
+
+    for (const SharePtr &share : added) {
+        newShares << share;
+    }
+
+    insertChildren(hostNode, newShares);
+}
+
+void Smb4KNetworkBrowserModel::updateShare(const SharePtr &share)
+{
+    Smb4KNetworkBrowserNode *shareNode = m_shareNodes.value(nodeKey(share));
+
+    if (shareNode) {
+        updateNode(shareNode);
+    }
+}
+
+void Smb4KNetworkBrowserModel::clear()
+{
+    beginResetModel();
+
+    for (Smb4KNetworkBrowserNode *child : std::as_const(m_root->children)) {
+        forgetNode(child);
+    }
+
+    m_root->children.clear();
+    m_root->childIndex.clear();
+    m_shareNodes.clear();
+
+    endResetModel();
+}
+
+Smb4KNetworkBrowserNode *Smb4KNetworkBrowserModel::node(const QModelIndex &index) const
+{
+    if (!index.isValid()) {
+        return m_root;
+    }
+
+    return static_cast<Smb4KNetworkBrowserNode *>(index.internalPointer());
+}
+
+QModelIndex Smb4KNetworkBrowserModel::indexOf(Smb4KNetworkBrowserNode *node, int column) const
+{
+    if (!node || node == m_root) {
+        return QModelIndex();
+    }
+
+    return createIndex(node->row, column, node);
+}
+
+Smb4KNetworkBrowserNode *Smb4KNetworkBrowserModel::findChild(Smb4KNetworkBrowserNode *parent, const QString &key) const
+{
+    return parent->childIndex.value(key);
+}
+
+void Smb4KNetworkBrowserModel::populate(Smb4KNetworkBrowserNode *parent)
+{
+    if (parent->populated) {
+        return;
+    }
+
+    parent->populated = true;
+
+    QList<NetworkItemPtr> items;
+
+    switch (parent->item->type()) {
+    case Workgroup: {
+        const QList<HostPtr> hosts = workgroupMembers(parent->item.staticCast<Smb4KWorkgroup>());
+
+        for (const HostPtr &host : hosts) {
+            items << host;
+        }
+        break;
+    }
+    case Host: {
+        const QList<SharePtr> shares = sharedResources(parent->item.staticCast<Smb4KHost>());
+
+        for (const SharePtr &share : shares) {
+            items << share;
+        }
+        break;
+    }
+    default: {
+        break;
+    }
+    }
+
+    insertChildren(parent, items);
+}
+
+void Smb4KNetworkBrowserModel::insertChildren(Smb4KNetworkBrowserNode *parent, const QList<NetworkItemPtr> &items)
+{
+    QList<Smb4KNetworkBrowserNode *> newNodes;
+    QHash<QString, Smb4KNetworkBrowserNode *> newIndex;
+
+    for (const NetworkItemPtr &item : items) {
+        QString key = nodeKey(item);
+
+        if (parent->childIndex.contains(key) || newIndex.contains(key)) {
+            continue;
+        }
+
+        Smb4KNetworkBrowserNode *newNode = new Smb4KNetworkBrowserNode;
+        newNode->item = item;
+        newNode->parent = parent;
+        newNode->row = parent->children.size() + newNodes.size();
+        newNode->populated = (item->type() != Workgroup && item->type() != Host);
+
+        newNodes << newNode;
+        newIndex.insert(key, newNode);
+    }
+
+    if (newNodes.isEmpty()) {
+        return;
+    }
+
+    //
+    // The new items are appended, the view sorts them through the proxy model
+    //
+    beginInsertRows(indexOf(parent), parent->children.size(), parent->children.size() + newNodes.size() - 1);
+
+    parent->children << newNodes;
+    parent->childIndex.insert(newIndex);
+
+    for (Smb4KNetworkBrowserNode *newNode : std::as_const(newNodes)) {
+        if (newNode->item->type() == Share) {
+            m_shareNodes.insert(nodeKey(newNode->item), newNode);
+        }
+    }
+
+    endInsertRows();
+}
+
+void Smb4KNetworkBrowserModel::removeChild(Smb4KNetworkBrowserNode *parent, const QString &key)
+{
+    Smb4KNetworkBrowserNode *child = parent->childIndex.value(key);
+
+    if (!child) {
+        return;
+    }
+
+    int row = child->row;
+
+    beginRemoveRows(indexOf(parent), row, row);
+
+    parent->children.removeAt(row);
+    parent->childIndex.remove(key);
+
+    for (int i = row; i < parent->children.size(); ++i) {
+        parent->children.at(i)->row = i;
+    }
+
+    forgetNode(child);
+
+    endRemoveRows();
+}
+
+void Smb4KNetworkBrowserModel::updateNode(Smb4KNetworkBrowserNode *node)
+{
+    Q_EMIT dataChanged(indexOf(node), indexOf(node, ColumnCount - 1));
+}
+
+void Smb4KNetworkBrowserModel::forgetNode(Smb4KNetworkBrowserNode *node)
+{
+    for (Smb4KNetworkBrowserNode *child : std::as_const(node->children)) {
+        forgetNode(child);
+    }
+
+    if (node->item->type() == Share) {
+        QString key = nodeKey(node->item);
+
+        if (m_shareNodes.value(key) == node) {
+            m_shareNodes.remove(key);
+        }
+    }
+
+    delete node;
+}
@@ -0,0 +1,122 @@
+/*
+    The model of the network neighborhood browser
+
+    SPDX-FileCopyrightText: 2026 Alexander Reinholdt <alexander.reinholdt@kdemail.net>
+    SPDX-License-Identifier: GPL-2.0-or-later
+*/
+
+#ifndef SMB4KNETWORKBROWSERMODEL_H
+#define SMB4KNETWORKBROWSERMODEL_H
+
+// application specific includes
+#include "core/smb4kglobal.h"
+
+// Qt includes
+#include <QAbstractItemModel>
+#include <QHash>
+#include <QList>
+
+// forward declarations
+class Smb4KNetworkBrowserNode;
+
+/**
+ * This model presents the global lists of workgroups, hosts and shares
+ * as a tree. The members of a workgroup and the shares of a host are only
+ * added to the model when the respective item is expanded. Afterwards,
+ * the model is updated incrementally.
+ *
+ * @author Alexander Reinholdt <alexander.reinholdt@kdemail.net>
+ * @since 4.1.0
+ */
+
+class Smb4KNetworkBrowserModel : public QAbstractItemModel
+{
+    Q_OBJECT
+
+public:
+    /**
+     * Constructor
+     */
+    explicit Smb4KNetworkBrowserModel(QObject *parent = nullptr);
+
+    /**
+     * Destructor
+     */
+    ~Smb4KNetworkBrowserModel();
+
+    /**
+     * The columns of the model
+     */
+    enum Columns {
+        Network = 0,
+        Type = 1,
+        IP = 2,
+        Comment = 3,
+        ColumnCount = 4
+    };
+
+    /**
+     * Reimplemented from QAbstractItemModel
+     */
+    QModelIndex index(int row, int column, const QModelIndex &parent = QModelIndex()) const override;
+    QModelIndex parent(const QModelIndex &index) const override;
+    int rowCount(const QModelIndex &parent = QModelIndex()) const override;
+    int columnCount(const QModelIndex &parent = QModelIndex()) const override;
+    bool hasChildren(const QModelIndex &parent = QModelIndex()) const override;
+    bool canFetchMore(const QModelIndex &parent) const override;
+    void fetchMore(const QModelIndex &parent) override;
+    QVariant data(const QModelIndex &index, int role = Qt::DisplayRole) const override;
+    QVariant headerData(int section, Qt::Orientation orientation, int role = Qt::DisplayRole) const override;
+
+    /**
+     * Returns the network item at @p index or a null pointer.
+     */
+    NetworkItemPtr networkItem(const QModelIndex &index) const;
+
+    /**
+     * Returns the index of the network item @p item. The parents of the
+     * item are populated, if necessary. An invalid index is returned if
+     * the item is not in the model.
+     */
+    QModelIndex indexOf(const NetworkItemPtr &item);
+
+    /**
+     * Apply the changes of the list of workgroups
+     */
+    void updateWorkgroups(const QList<WorkgroupPtr> &added, const QList<WorkgroupPtr> &removed, const QList<WorkgroupPtr> &changed);
+
+    /**
+     * Apply the changes of the members of @p workgroup
+     */
+    void updateHosts(const WorkgroupPtr &workgroup, const QList<HostPtr> &added, const QList<HostPtr> &removed, const QList<HostPtr> &changed);
+
+    /**
+     * Apply the changes of the shares of @p host
+     */
+    void updateShares(const HostPtr &host, const QList<SharePtr> &added, const QList<SharePtr> &removed, const QList<SharePtr> &changed);
+
+    /**
+     * Update the share with the same URL as @p share, e.g. after it was
+     * mounted or unmounted
+     */
+    void updateShare(const SharePtr &share);
+
+    /**
+     * Remove all items
+     */
+    void clear();
+
+private:
+    Smb4KNetworkBrowserNode *node(const QModelIndex &index) const;
+    QModelIndex indexOf(Smb4KNetworkBrowserNode *node, int column = Network) const;
+    Smb4KNetworkBrowserNode *findChild(Smb4KNetworkBrowserNode *parent, const QString &key) const;
+    void populate(Smb4KNetworkBrowserNode *parent);
+    void insertChildren(Smb4KNetworkBrowserNode *parent, const QList<NetworkItemPtr> &items);
+    void removeChild(Smb4KNetworkBrowserNode *parent, const QString &key);
+    void updateNode(Smb4KNetworkBrowserNode *node);
+    void forgetNode(Smb4KNetworkBrowserNode *node);
+    Smb4KNetworkBrowserNode *m_root;
+    QHash<QString, Smb4KNetworkBrowserNode *> m_shareNodes;
+};
+
+#endif
@@ -118,7 +118,9 @@ void Smb4KNetworkSearchToolBar::clearSearch()
 void Smb4KNetworkSearchToolBar::setSearchResults(const QList<SharePtr> &list)
 {
     for (const SharePtr &share : list) {
-        m_searchResults << share->url().toString();
+        if (!m_searchResults.contains(share->url().toString())) {
+            m_searchResults << share->url().toString();
+        }
     }
 
     m_searchResults.sort();
@@ -144,6 +146,7 @@ void Smb4KNetworkSearchToolBar::slotReturnKeyPressed(const QString &text)
 {
     if (!text.isEmpty()) {
         m_searchComboBox->completionObject()->addItem(text);
+        m_searchResults.clear();
         Q_EMIT search(text);
     }
 }
@@ -153,6 +156,7 @@ void Smb4KNetworkSearchToolBar::slotSearchActionTriggered()
     if (!m_searchAction->isActive()) {
         if (!m_searchComboBox->currentText().isEmpty()) {
             m_searchComboBox->completionObject()->addItem(m_searchComboBox->currentText());
+            m_searchResults.clear();
             Q_EMIT search(m_searchComboBox->currentText());
         }
     } else {
@@ -13,7 +13,7 @@
 
 // Qt includes
 #include <QDialogButtonBox>
-#include <QMap>
+#include <QLocale>
 #include <QVBoxLayout>
 
 // KDE includes
@@ -24,6 +24,73 @@
 #include <QWindow>
 // #include <KIO/OpenUrlJob>
 
+//
+// The sort modes of the preview
+//
+enum PreviewSortMode { SortByName = 0, SortBySize, SortByDate };
+
+//
+// List widget item that sorts directories before files
+//
+class Smb4KPreviewItem : public QListWidgetItem
+{
+public:
+    Smb4KPreviewItem(const FilePtr &file, int sortMode)
+        : QListWidgetItem()
+        , m_sortMode(sortMode)
+        , m_directory(file->isDirectory())
+        , m_size(file->size())
+        , m_lastModified(file->lastModified())
+    {
+        setText(file->name());
+        setIcon(file->icon());
+        setData(Qt::UserRole, QVariant::fromValue(*file.data()));
+
+        QStringList toolTip;
+        toolTip << file->name();
+
+        if (!m_directory && m_size != -1) {
+            toolTip << i18n("Size: %1", QLocale().formattedDataSize(m_size));
+        }
+
+        if (m_lastModified.isValid()) {
+            toolTip << i18n("Modified: %1", QLocale().toString(m_lastModified, QLocale::ShortFormat));
+        }
+
+        setToolTip(toolTip.join(QStringLiteral("\n")));
+    }
+
+    void setSortMode(int sortMode)
+    {
+        m_sortMode = sortMode;
+    }
+
+    bool operator<(const QListWidgetItem &other) const override
+    {
+        const Smb4KPreviewItem *otherItem = static_cast<const Smb4KPreviewItem *>(&other);
+
+        if (m_directory != otherItem->m_directory) {
+            return m_directory;
+        }
+
+        if (m_sortMode == SortBySize && m_size != otherItem->m_size) {
+            return m_size < otherItem->m_size;
+        }
+
+        if (m_sortMode == SortByDate && m_lastModified != otherItem->m_lastModified) {
+            return m_lastModified < otherItem->m_lastModified;
+        }
+
+        return text() < other.text();
+    }
+
+private:
+    int m_sortMode;
+    bool m_directory;
+    qint64 m_size;
+    QDateTime m_lastModified;
+};
+
 Smb4KPreviewDialog::Smb4KPreviewDialog(QWidget *parent)
     : QDialog(parent)
 {
@@ -34,6 +101,7 @@ Smb4KPreviewDialog::Smb4KPreviewDialog(QWidget *parent)
 
     m_listWidget = new QListWidget(this);
     m_listWidget->setSelectionMode(QListWidget::SingleSelection);
+    m_listWidget->setSortingEnabled(true);
     connect(m_listWidget, &QListWidget::itemActivated, this, &Smb4KPreviewDialog::slotItemActivated);
 
     layout->addWidget(m_listWidget);
@@ -58,6 +126,16 @@ Smb4KPreviewDialog::Smb4KPreviewDialog(QWidget *parent)
     m_upAction->setObjectName(QStringLiteral("up_action"));
     m_upAction->setEnabled(false);
 
+    m_sortAction = new KSelectAction(KDE::icon(QStringLiteral("view-sort")), i18n("Sort By"), toolBar);
+    m_sortAction->setObjectName(QStringLiteral("sort_action"));
+    m_sortAction->setToolBarMode(KSelectAction::MenuMode);
+    m_sortAction->addAction(i18n("Name"));
+    m_sortAction->addAction(i18n("Size"));
+    m_sortAction->addAction(i18n("Date"));
+    connect(m_sortAction, &KSelectAction::indexTriggered, this, &Smb4KPreviewDialog::slotSortActionTriggered);
+
+    toolBar->addAction(m_sortAction);
+
     toolBar->addSeparator();
 
     m_urlComboBox = new KUrlComboBox(KUrlComboBox::Directories, toolBar);
@@ -92,6 +170,9 @@ Smb4KPreviewDialog::Smb4KPreviewDialog(QWidget *parent)
 
     resize(dialogSize); // workaround for QTBUG-40584
 
+    int sortMode = dialogGroup.readEntry("SortMode", static_cast<int>(SortByName));
+    m_sortAction->setCurrentItem(sortMode);
+
     connect(Smb4KClient::self(), &Smb4KClient::files, this, &Smb4KPreviewDialog::slotPreviewResults);
     connect(Smb4KClient::self(), &Smb4KClient::aboutToStart, this, &Smb4KPreviewDialog::slotAdjustReloadAction);
     connect(Smb4KClient::self(), &Smb4KClient::finished, this, &Smb4KPreviewDialog::slotAdjustReloadAction);
@@ -149,6 +230,10 @@ void Smb4KPreviewDialog::loadPreview(const NetworkItemPtr &networkItem)
 
     m_currentItem = networkItem;
 
+    // The files are appended while the directory is read
+    m_listWidget->clear();
+    m_upAction->setEnabled(!m_currentItem->url().matches(m_share->url(), QUrl::StripTrailingSlash));
+
     Smb4KClient::self()->lookupFiles(networkItem);
 }
 
@@ -156,6 +241,7 @@ void Smb4KPreviewDialog::slotCloseButtonClicked()
 {
     KConfigGroup dialogGroup(Smb4KSettings::self()->config(), QStringLiteral("PreviewDialog"));
     KWindowConfig::saveWindowSize(windowHandle(), dialogGroup);
+    dialogGroup.writeEntry("SortMode", m_sortAction->currentItem());
 
     accept();
 }
@@ -175,41 +261,27 @@ void Smb4KPreviewDialog::slotItemActivated(QListWidgetItem *item)
     }
 }
 
-void Smb4KPreviewDialog::slotPreviewResults(const QList<FilePtr> &files)
+void Smb4KPreviewDialog::slotPreviewResults(const NetworkItemPtr &item, const QList<FilePtr> &files)
 {
-    if (!files.first()->url().toString().startsWith(m_share->url().toString())) {
+    if (!m_currentItem || !m_currentItem->url().matches(item->url(), QUrl::StripTrailingSlash)) {
         return;
     }
 
-    if (m_listWidget->count() != 0) {
-        m_listWidget->clear();
-    }
-
-    QMap<QString, QListWidgetItem *> sortingMap;
+    //
+    // Do not update the view for every single item and append the items
+    // unsorted. The list is sorted once per batch instead of inserting
+    // every item at its sorted position.
+    //
+    m_listWidget->setUpdatesEnabled(false);
+    m_listWidget->setSortingEnabled(false);
 
     for (const FilePtr &file : files) {
-        QVariant variant = QVariant::fromValue(*file.data());
-
-        QListWidgetItem *item = new QListWidgetItem();
-        item->setText(file->name());
-        item->setIcon(file->icon());
-        item->setData(Qt::UserRole, variant);
-
-        if (file->isDirectory()) {
-            sortingMap[QStringLiteral("00_") + file->name()] = item;
-        } else {
-            sortingMap[QStringLiteral("01_") + file->name()] = item;
-        }
+        m_listWidget->addItem(new Smb4KPreviewItem(file, m_sortAction->currentItem()));
     }
 
-    QMapIterator<QString, QListWidgetItem *> it(sortingMap);
-
-    while (it.hasNext()) {
-        it.next();
-        m_listWidget->addItem(it.value());
-    }
-
-    m_upAction->setEnabled(!m_currentItem->url().matches(m_share->url(), QUrl::StripTrailingSlash));
+    m_listWidget->setSortingEnabled(true);
+    m_listWidget->sortItems();
+    m_listWidget->setUpdatesEnabled(true);
 }
 
 void Smb4KPreviewDialog::slotReloadActionTriggered(bool checked)
@@ -243,6 +315,18 @@ void Smb4KPreviewDialog::slotUpActionTriggered()
     }
 }
 
+void Smb4KPreviewDialog::slotSortActionTriggered(int index)
+{
+    //
+    // Set the sort mode once instead of looking it up on every comparison
+    //
+    for (int i = 0; i < m_listWidget->count(); ++i) {
+        static_cast<Smb4KPreviewItem *>(m_listWidget->item(i))->setSortMode(index);
+    }
+
+    m_listWidget->sortItems();
+}
+
 void Smb4KPreviewDialog::slotUrlActivated(const QUrl &url)
 {
     Q_UNUSED(url);
@@ -20,6 +20,7 @@
 
 // KDE includes
 #include <KDualAction>
+#include <KSelectAction>
 #include <KUrlComboBox>
 
 class SMB4KDIALOGS_EXPORT Smb4KPreviewDialog : public QDialog
@@ -52,9 +53,10 @@ public Q_SLOTS:
 protected Q_SLOTS:
     void slotCloseButtonClicked();
     void slotItemActivated(QListWidgetItem *item);
-    void slotPreviewResults(const QList<FilePtr> &files);
+    void slotPreviewResults(const NetworkItemPtr &item, const QList<FilePtr> &files);
     void slotReloadActionTriggered(bool checked);
     void slotUpActionTriggered();
+    void slotSortActionTriggered(int index);
     void slotUrlActivated(const QUrl &url);
     void slotAdjustReloadAction(const NetworkItemPtr &item, int type);
 
@@ -65,6 +67,7 @@ private:
     NetworkItemPtr m_currentItem;
     KDualAction *m_reloadAction;
     QAction *m_upAction;
+    KSelectAction *m_sortAction;
     KUrlComboBox *m_urlComboBox;
 };
 
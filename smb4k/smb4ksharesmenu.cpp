@@ -1,7 +1,7 @@
 /*
     smb4ksharesmenu  -  Shares menu
 
-    SPDX-FileCopyrightText: 2011-2024 Alexander Reinholdt <alexander.reinholdt@kdemail.net>
+    SPDX-FileCopyrightText: 2011-2026 Alexander Reinholdt <alexander.reinholdt@kdemail.net>
     SPDX-License-Identifier: GPL-2.0-or-later
 */
 
@@ -82,8 +82,10 @@ void Smb4KSharesMenu::refreshMenu()
     //
     // Add share menus, if necessary
     //
-    if (!mountedSharesList().isEmpty()) {
-        for (const SharePtr &share : std::as_const(mountedSharesList())) {
+    const QList<SharePtr> mountedShares = mountedSharesList();
+
+    if (!mountedShares.isEmpty()) {
+        for (const SharePtr &share : mountedShares) {
             addShareToMenu(share);
         }
     }